@@ -19,6 +19,7 @@
 #include "run-command.h"
 #include "cli-report.h"
 #include "client.h"
+#include "sensitive_words.h"
 
 /* Field separator for the crash report file that is edited by user. */
 #define FIELD_SEP "%----"
@@ -424,7 +425,7 @@ static void ask_for_missing_settings(const char *event_name)
         for (iter = err_list; iter; iter = iter->next)
         {
             invalid_option_t *err_data = (invalid_option_t *)iter->data;
-            event_option_t *opt = get_event_option_from_list(err_data->invopt_name, event_config->options);
+            event_option_t *opt = ec_get_option(event_config, err_data->invopt_name);
 
             free(opt->eo_value);
             opt->eo_value = NULL;
@@ -528,6 +529,42 @@ static int is_not_reportable(problem_data_t *problem_data)
     return 0;
 }
 
+/* Lists the elements with forbidden words, see forbidden_words.conf(5) */
+static void print_sensitive_data(problem_data_t *problem_data)
+{
+    sensitive_words_t *words = sensitive_words_load_default(/*case sensitive*/0);
+    GHashTable *found = sensitive_words_scan_problem_data(words, problem_data);
+
+    if (g_hash_table_size(found) != 0)
+    {
+        printf("%s\n", _("The problem data may contain sensitive information:"));
+
+        GList *names = g_hash_table_get_keys(found);
+        names = g_list_sort(names, (GCompareFunc)strcmp);
+        for (GList *iter = names; iter; iter = g_list_next(iter))
+        {
+            /* Every word once */
+            GList *listed = NULL;
+            printf("  %s:", (const char *)iter->data);
+            for (GList *m = g_hash_table_lookup(found, iter->data); m; m = g_list_next(m))
+            {
+                const struct sensitive_word_match *match = m->data;
+                if (g_list_find(listed, match->swm_word))
+                    continue;
+
+                printf("%s %s", listed ? "," : "", match->swm_word);
+                listed = g_list_prepend(listed, (gpointer)match->swm_word);
+            }
+            printf("\n");
+            g_list_free(listed);
+        }
+        g_list_free(names);
+    }
+
+    g_hash_table_destroy(found);
+    sensitive_words_free(words);
+}
+
 static int is_backtrace_rating_usable(event_config_t *config, problem_data_t *problem_data)
 {
     char *usability_description = NULL;
@@ -668,6 +705,11 @@ static int run_event_on_dir_name_interactively(
 
         if (config->ec_sending_sensitive_data)
         {
+            problem_data = load_problem_data_if_not_yet(problem_data, dump_dir_name);
+            if (!problem_data)
+                goto ret;
+            print_sensitive_data(problem_data);
+
             char *msg = xasprintf(_("Event '%s' requires permission to send possibly sensitive data."
                                     " Do you want to continue?"),
                         ec_get_screen_name(config) ? ec_get_screen_name(config) : event_name);
@@ -136,8 +136,7 @@ int main(int argc, char** argv)
 
     char *dump_dir_name = argv[0];
 
-    /* Get settings */
-    load_event_config_data();
+    /* Event settings are loaded on demand by get_event_config() */
 
     /* At least, needed by ASK_YES_NO_YESFOREVER event command requests.
      * Removing of the following statement will get the yes forever stuff not
@@ -180,8 +179,6 @@ int main(int argc, char** argv)
         }
         case OPT_workflow:
         {
-            load_workflow_config_data(WORKFLOWS_DIR);
-
             /* list of workflows applicable to the currently processed problem */
             GHashTable *possible_workflows = load_workflow_config_data_from_list(
                                     list_possible_events_glist(dump_dir_name, "workflow"),
@@ -0,0 +1,129 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "internal_libreport.h"
+#include "sensitive_words.h"
+
+/* Exit codes */
+enum {
+    SCAN_CLEAN = 0,
+    SCAN_FOUND = 1,
+    SCAN_ERROR = 2,
+};
+
+static void print_matches(const char *dump_dir_name, const char *name, const char *text, GList *matches)
+{
+    /* The matches are ordered, count the lines on the way */
+    unsigned line = 1;
+    const char *pos = text;
+
+    for (GList *iter = matches; iter; iter = g_list_next(iter))
+    {
+        const struct sensitive_word_match *match = iter->data;
+        for (const char *end = text + match->swm_start; pos < end; ++pos)
+            if (*pos == '\n')
+                ++line;
+
+        printf("%s/%s:%u: %s\n", dump_dir_name, name, line, match->swm_word);
+    }
+}
+
+static int scan_dump_dir(const sensitive_words_t *words, const char *dump_dir_name, bool quiet)
+{
+    struct dump_dir *dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY);
+    if (!dd)
+        return SCAN_ERROR;
+
+    problem_data_t *problem_data = create_problem_data_from_dump_dir(dd);
+    dd_close(dd);
+
+    GHashTable *found = sensitive_words_scan_problem_data(words, problem_data);
+    const int result = g_hash_table_size(found) != 0 ? SCAN_FOUND : SCAN_CLEAN;
+
+    if (!quiet)
+    {
+        GList *names = g_hash_table_get_keys(found);
+        names = g_list_sort(names, (GCompareFunc)strcmp);
+        for (GList *iter = names; iter; iter = g_list_next(iter))
+            print_matches(dump_dir_name, iter->data,
+                          problem_data_get_content_or_NULL(problem_data, iter->data),
+                          g_hash_table_lookup(found, iter->data));
+        g_list_free(names);
+    }
+
+    g_hash_table_destroy(found);
+    problem_data_free(problem_data);
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    abrt_init(argv);
+
+    /* I18n */
+    setlocale(LC_ALL, "");
+#if ENABLE_NLS
+    bindtextdomain(PACKAGE, LOCALEDIR);
+    textdomain(PACKAGE);
+#endif
+
+    /* Can't keep these strings/structs static: _() doesn't support that */
+    const char *program_usage_string = _(
+        "& [-vqi] PROBLEM_DIR...\n"
+        "\n"
+        "Searches problem directories for words listed in forbidden_words.conf\n"
+        "which are not a part of words listed in ignored_words.conf\n"
+        "\n"
+        "Exits with 0 if nothing was found, 1 if a word was found and 2 on errors."
+    );
+    enum {
+        OPT_v = 1 << 0,
+        OPT_q = 1 << 1,
+        OPT_i = 1 << 2,
+    };
+    /* Keep enum above and order of options below in sync! */
+    struct options program_options[] = {
+        OPT__VERBOSE(&g_verbose),
+        OPT_BOOL('q', "quiet"      , NULL, _("Do not print the found words")),
+        OPT_BOOL('i', "ignore-case", NULL, _("Ignore case of forbidden words")),
+        OPT_END()
+    };
+    unsigned opts = parse_opts(argc, argv, program_options, program_usage_string);
+
+    argv += optind;
+    if (!argv[0])
+        show_usage_and_die(program_usage_string, program_options);
+
+    export_abrt_envvars(0);
+
+    sensitive_words_t *words = sensitive_words_load_default(
+            (opts & OPT_i) ? SENSITIVE_WORDS_CASE_INSENSITIVE : 0);
+
+    int exit_code = SCAN_CLEAN;
+    for ( ; argv[0]; ++argv)
+    {
+        const int result = scan_dump_dir(words, argv[0], opts & OPT_q);
+        if (result > exit_code)
+            exit_code = result;
+    }
+
+    sensitive_words_free(words);
+
+    return exit_code;
+}
@@ -0,0 +1,96 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "internal_libreport.h"
+#include "definition_cache.h"
+
+int main(int argc, char **argv)
+{
+    abrt_init(argv);
+
+    /* I18n */
+    setlocale(LC_ALL, "");
+#if ENABLE_NLS
+    bindtextdomain(PACKAGE, LOCALEDIR);
+    textdomain(PACKAGE);
+#endif
+
+    GList *locales = NULL;
+    const char *events_dir = EVENTS_DIR;
+    const char *workflows_dir = WORKFLOWS_DIR;
+
+    /* Can't keep these strings/structs static: _() doesn't support that */
+    const char *program_usage_string = _(
+        "& [-v] [-l LOCALE]... [-e EVENTS_DIR] [-w WORKFLOWS_DIR]\n"
+        "\n"
+        "Compiles event and workflow XML definitions to the definition cache\n"
+        "\n"
+        "Without -l, the cache is regenerated for the current locale and for all\n"
+        "locales already in the cache."
+    );
+    enum {
+        OPT_v = 1 << 0,
+        OPT_l = 1 << 1,
+        OPT_e = 1 << 2,
+        OPT_w = 1 << 3,
+    };
+    /* Keep enum above and order of options below in sync! */
+    struct options program_options[] = {
+        OPT__VERBOSE(&g_verbose),
+        OPT_LIST(  'l', "locale"   , &locales      , "LOCALE", _("Locale (may be given many times)")),
+        OPT_STRING('e', "events"   , &events_dir   , "DIR"   , _("Event definitions directory")),
+        OPT_STRING('w', "workflows", &workflows_dir, "DIR"   , _("Workflow definitions directory")),
+        OPT_END()
+    };
+    unsigned opts = parse_opts(argc, argv, program_options, program_usage_string);
+
+    argv += optind;
+    if (argv[0])
+        show_usage_and_die(program_usage_string, program_options);
+
+    export_abrt_envvars(0);
+
+    if (!(opts & OPT_l))
+    {
+        locales = definition_cache_get_locales();
+
+        char *locale = definition_cache_locale();
+        if (!g_list_find_custom(locales, locale, (GCompareFunc)strcmp))
+            locales = g_list_prepend(locales, locale);
+        else
+            free(locale);
+    }
+
+    int exit_code = EXIT_SUCCESS;
+    for (GList *iter = locales; iter; iter = g_list_next(iter))
+    {
+        log_info("Updating definition cache for locale '%s'", (const char *)iter->data);
+
+        if (definition_cache_update_events(events_dir, iter->data) != 0)
+            exit_code = EXIT_FAILURE;
+        if (definition_cache_update_workflows(workflows_dir, iter->data) != 0)
+            exit_code = EXIT_FAILURE;
+    }
+    /* The list given by -l holds the arguments */
+    if (opts & OPT_l)
+        g_list_free(locales);
+    else
+        g_list_free_full(locales, free);
+
+    return exit_code;
+}
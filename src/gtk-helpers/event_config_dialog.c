@@ -251,7 +251,7 @@ config_dialog_t *create_event_config_dialog_content(event_config_t *event, GtkWi
     */
     g_option_list = NULL;
     /* this fills the g_option_list, so we can use it for new_config_dialog */
-    g_list_foreach(event->options, &add_option_to_table, option_table);
+    g_list_foreach(ec_get_options(event), &add_option_to_table, option_table);
 
     /* if there is at least one password option, add checkbox to disable storing passwords */
     /* if the user storage is not available nothing is to be stored, so it is not necessary
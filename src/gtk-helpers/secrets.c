@@ -1383,7 +1383,7 @@ static void load_settings(GDBusProxy *session, struct secrets_object *collection
         {
             log_notice("loading event config : '%s'", event_name);
             item->tag = (void *)event_name;
-            load_event_options_from_item(session, ec->options, item);
+            load_event_options_from_item(session, ec_get_options(ec), item);
         }
         secrets_object_delete(item);
         item = NULL;
@@ -1598,7 +1598,7 @@ void save_event_config_data_to_user_storage(const char *event_name,
     INITIALIZE_LIBREPORT();
 
     if (is_event_config_user_storage_available())
-        save_event_config(event_name, event_config->options, store_passwords);
+        save_event_config(event_name, ec_get_options(event_config), store_passwords);
     else
     {
         log_notice("Can't save user's configuration due to unavailability of D-Bus secrets API");
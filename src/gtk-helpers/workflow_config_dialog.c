@@ -31,7 +31,7 @@ static GHashTable *g_events_options = NULL;
 
 static void create_event_config_dialog_content_cb(event_config_t *ec, gpointer notebook)
 {
-    if (!ec->options)
+    if (!ec_get_options(ec))
         return;
 
     GtkWidget *ev_lbl = gtk_label_new(ec_get_screen_name(ec));
@@ -18,6 +18,7 @@
 */
 #include <gtk/gtk.h>
 #include "internal_libreport.h"
+#include "config_watcher.h"
 #include "wizard.h"
 #if HAVE_LOCALE_H
 # include <locale.h>
@@ -121,6 +122,40 @@ activate_wizard(GApplication *app,
     update_gui_state_from_problem_data(UPDATE_SELECTED_EVENT);
 }
 
+static guint g_config_update_id;
+
+static gboolean update_gui_on_config_change(gpointer user_data)
+{
+    g_config_update_id = 0;
+    update_gui_state_from_config();
+    return FALSE;
+}
+
+static void
+config_changed(config_watch_kind_t kind,
+               const char *name,
+               void *data)
+{
+    switch (kind)
+    {
+        case CONFIG_WATCH_EVENT:
+            /* The reloaded event lost the values from the user storage */
+            load_event_config_data_from_user_storage(g_event_config_list);
+            break;
+        case CONFIG_WATCH_WORKFLOW:
+        case CONFIG_WATCH_EVENT_RULES:
+            break;
+        case CONFIG_WATCH_PLUGIN:
+        case CONFIG_WATCH_GLOBAL:
+            /* Read whenever they are used */
+            return;
+    }
+
+    /* Update the buttons once for all changes */
+    if (g_config_update_id == 0)
+        g_config_update_id = g_idle_add(update_gui_on_config_change, NULL);
+}
+
 int main(int argc, char **argv)
 {
     int expert_mode = 0;
@@ -216,6 +251,11 @@ int main(int argc, char **argv)
 
     problem_data_reload_from_dump_dir();
 
+    /* Offer the events and workflows installed or configured meanwhile */
+    config_watcher_t *watcher = config_watcher_new(config_changed, NULL);
+    if (watcher)
+        config_watcher_attach(watcher);
+
     g_custom_logger = &show_error_as_msgbox;
     GtkApplication *app = gtk_application_new("org.freedesktop.libreport.report", G_APPLICATION_NON_UNIQUE);
     g_signal_connect(app, "activate", G_CALLBACK(activate_wizard), (gpointer)&expert_mode);
@@ -224,6 +264,8 @@ int main(int argc, char **argv)
     g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
 
+    config_watcher_free(watcher);
+
     if (opts & OPT_d)
         delete_dump_dir_possibly_using_abrtd(g_dump_dir_name);
 
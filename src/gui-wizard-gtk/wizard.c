@@ -24,13 +24,12 @@
 #include "search_item.h"
 #include "libreport_types.h"
 #include "global_configuration.h"
+#include "sensitive_words.h"
 
 #define DEFAULT_WIDTH   800
 #define DEFAULT_HEIGHT  500
 
 #define EMERGENCY_ANALYSIS_EVENT_NAME "report_EmergencyAnalysis"
-#define FORBIDDEN_WORDS_BLACKLLIST "forbidden_words.conf"
-#define FORBIDDEN_WORDS_WHITELIST "ignored_words.conf"
 
 #if GTK_MAJOR_VERSION == 2 && GTK_MINOR_VERSION < 22
 # define gtk_assistant_commit(...) ((void)0)
@@ -168,6 +167,8 @@ enum
 static guint g_timeout = 0;
 static GtkEntry *g_search_entry_bt;
 static const gchar *g_search_text;
+/* Compiled forbidden and ignored words, loaded on the first use */
+static sensitive_words_t *g_forbidden_words;
 static search_item_t *g_current_highlighted_word;
 
 enum
@@ -1396,6 +1397,44 @@ static void update_ls_details_checkboxes(const char *event_name)
     }
 }
 
+/* Recreates the workflow buttons and in expert mode the event buttons
+ *
+ * @returns the active event button or NULL
+ */
+static event_gui_data_t *update_selector_buttons(void)
+{
+    add_workflow_buttons(g_box_workflows, g_workflow_list,
+                        G_CALLBACK(set_auto_event_chain));
+
+    /* Update event radio buttons
+     * show them only in expert mode
+    */
+    event_gui_data_t *active_button = NULL;
+    if (g_expert_mode == true)
+    {
+        //this widget doesn't react to show_all, so we need to "force" it
+        gtk_widget_show(GTK_WIDGET(g_box_events));
+        active_button = add_event_buttons(
+                    g_box_events,
+                    &g_list_events,
+                    g_events,
+                    G_CALLBACK(event_rb_was_toggled)
+        );
+    }
+
+    return active_button;
+}
+
+void update_gui_state_from_config(void)
+{
+    /* The assistant has not been created yet */
+    if (g_wnd_assistant == NULL)
+        return;
+
+    update_selector_buttons();
+    gtk_widget_show_all(GTK_WIDGET(g_wnd_assistant));
+}
+
 void update_gui_state_from_problem_data(int flags)
 {
     update_window_title();
@@ -1423,24 +1462,7 @@ void update_gui_state_from_problem_data(int flags)
     load_text_to_text_view(g_tv_comment, FILENAME_COMMENT);
     load_text_to_text_view(g_tv_steps, FILENAME_REPRODUCER);
 
-    add_workflow_buttons(g_box_workflows, g_workflow_list,
-                        G_CALLBACK(set_auto_event_chain));
-
-    /* Update event radio buttons
-     * show them only in expert mode
-    */
-    event_gui_data_t *active_button = NULL;
-    if (g_expert_mode == true)
-    {
-        //this widget doesn't react to show_all, so we need to "force" it
-        gtk_widget_show(GTK_WIDGET(g_box_events));
-        active_button = add_event_buttons(
-                    g_box_events,
-                    &g_list_events,
-                    g_events,
-                    G_CALLBACK(event_rb_was_toggled)
-        );
-    }
+    event_gui_data_t *active_button = update_selector_buttons();
 
     if (flags & UPDATE_SELECTED_EVENT && g_expert_mode)
     {
@@ -2415,51 +2437,51 @@ static void log_ready_state(void)
 
 static GList *find_words_in_text_buffer(int page,
                                         GtkTextView *tev,
-                                        GList *words,
-                                        GList *ignore_sitem_list,
+                                        const sensitive_words_t *words,
                                         GtkTextIter start_find,
-                                        GtkTextIter end_find,
-                                        bool case_insensitive
-                                        )
+                                        GtkTextIter end_find)
 {
     GtkTextBuffer *buffer = gtk_text_view_get_buffer(tev);
     gtk_text_buffer_set_modified(buffer, FALSE);
 
+    /* The slice has a character for every offset in the buffer */
+    gchar *text = gtk_text_buffer_get_slice(buffer, &start_find, &end_find,
+            /*include hidden chars*/TRUE);
+    GList *matches = sensitive_words_scan(words, text, strlen(text));
+
     GList *found_words = NULL;
-    GtkTextIter start_match;
-    GtkTextIter end_match;
+    const int base = gtk_text_iter_get_offset(&start_find);
+    size_t byte_offset = 0;
+    long char_offset = 0;
 
-    for (GList *w = words; w; w = g_list_next(w))
+    /* The matches are ordered by their start */
+    for (GList *m = matches; m; m = g_list_next(m))
     {
-        gtk_text_buffer_get_start_iter(buffer, &start_find);
+        const struct sensitive_word_match *match = m->data;
 
-        const char *search_word = w->data;
-        while (search_word && search_word[0] && gtk_text_iter_forward_search(&start_find, search_word,
-                    GTK_TEXT_SEARCH_TEXT_ONLY | (case_insensitive ? GTK_TEXT_SEARCH_CASE_INSENSITIVE : 0),
-                    &start_match,
-                    &end_match, NULL))
-        {
-            search_item_t *found_word = sitem_new(
-                    page,
-                    buffer,
-                    tev,
-                    start_match,
-                    end_match
-                );
-            int offset = gtk_text_iter_get_offset(&end_match);
-            gtk_text_buffer_get_iter_at_offset(buffer, &start_find, offset);
+        char_offset += g_utf8_pointer_to_offset(text + byte_offset, text + match->swm_start);
+        byte_offset = match->swm_start;
+        const long char_len = g_utf8_pointer_to_offset(text + match->swm_start, text + match->swm_end);
 
-            if (sitem_is_in_sitemlist(found_word, ignore_sitem_list))
-            {
-                sitem_free(found_word);
-                // don't count the word if it's part of some of the ignored words
-                continue;
-            }
+        GtkTextIter start_match;
+        GtkTextIter end_match;
+        gtk_text_buffer_get_iter_at_offset(buffer, &start_match, base + char_offset);
+        gtk_text_buffer_get_iter_at_offset(buffer, &end_match, base + char_offset + char_len);
 
-            found_words = g_list_prepend(found_words, found_word);
-        }
+        search_item_t *found_word = sitem_new(
+                page,
+                buffer,
+                tev,
+                start_match,
+                end_match
+            );
+
+        found_words = g_list_prepend(found_words, found_word);
     }
 
+    sensitive_word_matches_free(matches);
+    g_free(text);
+
     return found_words;
 }
 
@@ -2511,7 +2533,7 @@ static void search_item_to_list_store_item(GtkListStore *store, GtkTreeIter *new
             -1);
 }
 
-static bool highligh_words_in_textview(int page, GtkTextView *tev, GList *words, GList *ignored_words, bool case_insensitive)
+static bool highligh_words_in_textview(int page, GtkTextView *tev, const sensitive_words_t *words)
 {
     GtkTextBuffer *buffer = gtk_text_view_get_buffer(tev);
     gtk_text_buffer_set_modified(buffer, FALSE);
@@ -2575,26 +2597,7 @@ static bool highligh_words_in_textview(int page, GtkTextView *tev, GList *words,
     gtk_label_set_attributes(GTK_LABEL(tab_lbl), NULL);
     pango_attr_list_unref(attrs);
 
-    GList *result = NULL;
-    GList *ignored_words_in_buffer = NULL;
-
-    ignored_words_in_buffer = find_words_in_text_buffer(page,
-                                                        tev,
-                                                        ignored_words,
-                                                        NULL,
-                                                        start_find,
-                                                        end_find,
-                                                        /*case sensitive*/false);
-
-
-    result = find_words_in_text_buffer(page,
-                                       tev,
-                                       words,
-                                       ignored_words_in_buffer,
-                                       start_find,
-                                       end_find,
-                                       case_insensitive
-                                        );
+    GList *result = find_words_in_text_buffer(page, tev, words, start_find, end_find);
 
     for (GList *w = result; w; w = g_list_next(w))
     {
@@ -2613,11 +2616,8 @@ static bool highligh_words_in_textview(int page, GtkTextView *tev, GList *words,
         pango_attr_list_insert(attrs, underline_attr);
         gtk_label_set_attributes(GTK_LABEL(tab_lbl), attrs);
 
-        /* The current order of the found words is defined by order of words in the
-         * passed list. We have to order the words according to their occurrence in
-         * the buffer.
-         */
-        result = g_list_sort(result, (GCompareFunc)sitem_compare);
+        /* The found words were prepended */
+        result = g_list_reverse(result);
 
         GList *search_result = result;
         for ( ; search_result != NULL; search_result = g_list_next(search_result))
@@ -2643,13 +2643,12 @@ static bool highligh_words_in_textview(int page, GtkTextView *tev, GList *words,
         }
     }
 
-    g_list_free_full(ignored_words_in_buffer, free);
     g_list_free(result);
 
     return result != NULL;
 }
 
-static gboolean highligh_words_in_tabs(GList *forbidden_words,  GList *allowed_words, bool case_insensitive)
+static gboolean highligh_words_in_tabs(const sensitive_words_t *words)
 {
     gboolean found = false;
 
@@ -2666,7 +2665,7 @@ static gboolean highligh_words_in_tabs(GList *forbidden_words,  GList *allowed_w
             continue;
 
         GtkTextView *tev = GTK_TEXT_VIEW(gtk_bin_get_child(GTK_BIN(notebook_child)));
-        found |= highligh_words_in_textview(page, tev, forbidden_words, allowed_words, case_insensitive);
+        found |= highligh_words_in_textview(page, tev, words);
     }
 
     GtkTreeIter iter;
@@ -2676,17 +2675,17 @@ static gboolean highligh_words_in_tabs(GList *forbidden_words,  GList *allowed_w
     return found;
 }
 
-static gboolean highlight_forbidden(void)
+static const sensitive_words_t *get_forbidden_words(void)
 {
-    GList *forbidden_words = load_words_from_file(FORBIDDEN_WORDS_BLACKLLIST);
-    GList *allowed_words = load_words_from_file(FORBIDDEN_WORDS_WHITELIST);
+    if (g_forbidden_words == NULL)
+        g_forbidden_words = sensitive_words_load_default(/*case sensitive*/0);
 
-    const gboolean result = highligh_words_in_tabs(forbidden_words, allowed_words, /*case sensitive*/false);
-
-    list_free_with_free(forbidden_words);
-    list_free_with_free(allowed_words);
+    return g_forbidden_words;
+}
 
-    return result;
+static gboolean highlight_forbidden(void)
+{
+    return highligh_words_in_tabs(get_forbidden_words());
 }
 
 static char *get_next_processed_event(GList **events_list)
@@ -3155,11 +3154,16 @@ static gint select_next_page_no(gint current_page_no, gpointer data)
 
 static void rehighlight_forbidden_words(int page, GtkTextView *tev)
 {
-    GList *forbidden_words = load_words_from_file(FORBIDDEN_WORDS_BLACKLLIST);
-    GList *allowed_words = load_words_from_file(FORBIDDEN_WORDS_WHITELIST);
-    highligh_words_in_textview(page, tev, forbidden_words, allowed_words, /*case sensitive*/false);
-    list_free_with_free(forbidden_words);
-    list_free_with_free(allowed_words);
+    highligh_words_in_textview(page, tev, get_forbidden_words());
+}
+
+static sensitive_words_t *compile_search_text(const gchar *search_text)
+{
+    GList *words = g_list_append(NULL, (gpointer)search_text);
+    sensitive_words_t *compiled = sensitive_words_new(words, NULL, SENSITIVE_WORDS_CASE_INSENSITIVE);
+    g_list_free(words);
+
+    return compiled;
 }
 
 static void on_sensitive_word_selection_changed(GtkTreeSelection *sel, gpointer user_data)
@@ -3187,9 +3191,9 @@ static void on_sensitive_word_selection_changed(GtkTreeSelection *sel, gpointer
         else
         {
             log_notice("searching again: '%s'", g_search_text);
-            GList *searched_words = g_list_append(NULL, (gpointer)g_search_text);
-            highligh_words_in_textview(new_word->page, new_word->tev, searched_words, NULL, /*case insensitive*/true);
-            g_list_free(searched_words);
+            sensitive_words_t *searched_words = compile_search_text(g_search_text);
+            highligh_words_in_textview(new_word->page, new_word->tev, searched_words);
+            sensitive_words_free(searched_words);
         }
 
         return;
@@ -3208,9 +3212,9 @@ static void highlight_search(GtkEntry *entry)
     g_search_text = gtk_entry_get_text(entry);
 
     log_notice("searching: '%s'", g_search_text);
-    GList *words = g_list_append(NULL, (gpointer)g_search_text);
-    highligh_words_in_tabs(words, NULL, /*case insensitive*/true);
-    g_list_free(words);
+    sensitive_words_t *words = compile_search_text(g_search_text);
+    highligh_words_in_tabs(words);
+    sensitive_words_free(words);
 }
 
 static gboolean highlight_search_on_timeout(gpointer user_data)
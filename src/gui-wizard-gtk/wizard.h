@@ -37,6 +37,9 @@ enum
  * @param flags Flags to alternate the update process
  */
 void update_gui_state_from_problem_data(int flags);
+/* Updates GUI elements according to the changed event and workflow
+ * definitions, see config_watcher.h */
+void update_gui_state_from_config(void);
 void show_error_as_msgbox(const char *msg);
 
 
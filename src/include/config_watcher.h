@@ -0,0 +1,112 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/** @file config_watcher.h
+ *
+ * Notifications of changed configuration for long-running processes
+ *
+ * The watcher uses inotify to watch the directories with event and workflow
+ * definitions, event and workflow rules, plugin configuration files and
+ * libreport.conf. Only the changed files are reloaded:
+ *  - events in g_event_config_list, see reload_event_config(), and the
+ *    workflows with the changed events,
+ *  - workflows in g_workflow_list, see reload_workflow(),
+ *  - the global configuration, see reload_global_configuration().
+ *
+ * The rules and the plugin configuration files are read whenever they are
+ * used, so only the callback is called for them.
+ *
+ * Pointers to the changed configurations are kept valid, but the event
+ * options are replaced. Callers must not use event_option_t pointers of a
+ * changed event after the callback. Removed events and workflows stay
+ * allocated until their lists are freed.
+ *
+ * Directories which do not exist yet are watched once they are created. If
+ * the kernel drops notifications, all configuration is reported as changed.
+ */
+#ifndef LIBREPORT_CONFIG_WATCHER_H
+#define LIBREPORT_CONFIG_WATCHER_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    /* an event definition (.xml) or its configuration (.conf), the name is
+     * the event's name */
+    CONFIG_WATCH_EVENT,
+    /* a workflow definition, the name is the workflow's name */
+    CONFIG_WATCH_WORKFLOW,
+    /* report_event.conf or a file in events.d or workflows.d, the name is
+     * the file name */
+    CONFIG_WATCH_EVENT_RULES,
+    /* a plugin configuration file, the name is the file name */
+    CONFIG_WATCH_PLUGIN,
+    /* libreport.conf */
+    CONFIG_WATCH_GLOBAL,
+} config_watch_kind_t;
+
+/* Called after the changed configuration has been reloaded */
+typedef void (*config_watcher_callback)(config_watch_kind_t kind, const char *name, void *data);
+
+typedef struct config_watcher config_watcher_t;
+
+/* Creates a watcher of the default configuration directories.
+ *
+ * @returns NULL if inotify is not available.
+ */
+#define config_watcher_new libreport_config_watcher_new
+config_watcher_t *config_watcher_new(config_watcher_callback callback, void *data);
+
+/* Watches one more directory. The callback is called for the files changed
+ * in the directory but nothing is reloaded.
+ *
+ * @returns 0 or a negative errno value. -ENOENT means that the directory
+ * will be watched once it is created.
+ */
+#define config_watcher_add_dir libreport_config_watcher_add_dir
+int config_watcher_add_dir(config_watcher_t *watcher, config_watch_kind_t kind, const char *dir);
+
+/* Returns the file descriptor to poll for reading for custom main loops */
+#define config_watcher_get_fd libreport_config_watcher_get_fd
+int config_watcher_get_fd(config_watcher_t *watcher);
+
+/* Reads the pending notifications without blocking, reloads the changed
+ * configurations and calls the callback once for every changed item.
+ *
+ * @returns the number of changed items or -1 on error.
+ */
+#define config_watcher_process libreport_config_watcher_process
+int config_watcher_process(config_watcher_t *watcher);
+
+/* Processes the notifications from the default GLib main context */
+#define config_watcher_attach libreport_config_watcher_attach
+void config_watcher_attach(config_watcher_t *watcher);
+
+#define config_watcher_free libreport_config_watcher_free
+void config_watcher_free(config_watcher_t *watcher);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBREPORT_CONFIG_WATCHER_H */
@@ -47,6 +47,8 @@ int create_symlink_lockfile_at(int dir_fd, const char *filename, const char *pid
 
 /* Opens filename for reading relatively to a directory represented by dir_fd.
  * The function fails if the file is symbolic link, directory or hard link.
+ *
+ * @return The file descriptor or a negative errno value
  */
 int secure_openat_read(int dir_fd, const char *filename);
 
@@ -294,6 +296,35 @@ int dd_delete_item(struct dump_dir *dd, const char *name);
  */
 int dd_open_item(struct dump_dir *dd, const char *name, int flags);
 
+/* Maps the item read-only into memory. The item is opened with the same
+ * checks as secure_openat_read() does (no symlinks, no hard links, regular
+ * files only).
+ *
+ * @param dd Dump directory
+ * @param name The name of the item
+ * @param size Receives the length of the mapping
+ * @return NULL on error (errno is set); release the mapping with
+ *  dd_unmap_item()
+ */
+void *dd_map_item(struct dump_dir *dd, const char *name, size_t *size);
+void dd_unmap_item(void *data, size_t size);
+
+enum {
+    DD_HASH_SHA1,
+    DD_HASH_SHA256,
+};
+
+/* Computes the digest of the item's contents without loading the whole item
+ * into memory.
+ *
+ * @param dd Dump directory
+ * @param name The name of the item
+ * @param algorithm DD_HASH_SHA1 or DD_HASH_SHA256
+ * @param result Receives the raw digest (20 or 32 bytes)
+ * @return Length of the digest; otherwise -errno
+ */
+int dd_hash_item(struct dump_dir *dd, const char *name, int algorithm, uint8_t *result);
+
 /* Returns a FILE for the given name. The function is limited to open
  * an element read only, write only or create new.
  *
@@ -367,6 +398,37 @@ time_t dd_get_first_occurrence(struct dump_dir *dd);
  */
 time_t dd_get_last_occurrence(struct dump_dir *dd);
 
+/* Returns the generation of the dump directory meta-data record.
+ *
+ * The record mirrors type, time, last_occurrence, count and owner and it is
+ * updated every time one of them is modified through libreport. The
+ * generation can be used to detect changes of these values without reading
+ * them.
+ *
+ * @param dd Examined dump directory
+ * @returns 0 if the dump directory has no valid meta-data record.
+ */
+unsigned long long dd_get_meta_data_generation(struct dump_dir *dd);
+
+/* Saves data derived from the elements, e.g. parsed or formatted element
+ * contents, to the meta-data directory. Cached data is not an element, so it
+ * is neither listed nor loaded into problem data. The caller is responsible
+ * for detecting stale data, e.g. by storing a hash of the source elements.
+ *
+ * The given dump_dir must be opened for writing.
+ *
+ * @returns 0 on success or a negative errno value.
+ */
+int dd_save_cached_text(struct dump_dir *dd, const char *name, const char *data);
+
+/* Loads data saved by dd_save_cached_text().
+ *
+ * Can be used with DD_OPEN_READONLY.
+ *
+ * @returns NULL if there is no such data.
+ */
+char *dd_load_cached_text(struct dump_dir *dd, const char *name);
+
 /* reported_to handling */
 struct report_result {
     char *label;
@@ -77,6 +77,8 @@ typedef struct
 event_option_t *new_event_option(void);
 void free_event_option(event_option_t *p);
 
+struct event_options;
+
 //structure to hold the option data
 typedef struct
 {
@@ -96,7 +98,8 @@ typedef struct
     bool  ec_requires_details;
 
     GList *ec_imported_event_names;
-    GList *options;
+    /* Private, use ec_get_options(), ec_get_option() and ec_set_option() */
+    struct event_options *ec_options;
 } event_config_t;
 
 event_config_t *new_event_config(const char *name);
@@ -112,6 +115,17 @@ const char *ec_get_long_desc(event_config_t *ec);
 void ec_set_long_desc(event_config_t *ec, const char *long_desc);
 bool ec_is_configurable(event_config_t* ec);
 
+/* Returns the list of event_option_t in the order of definition. The list
+ * belongs to the event and must not be changed, add options with
+ * ec_set_option(). */
+GList *ec_get_options(event_config_t *ec);
+/* Returns the option of the given name or NULL, the options are looked up in
+ * a hash table instead of walking the list */
+event_option_t *ec_get_option(event_config_t *ec, const char *name);
+/* Appends the option, or replaces the option of the same name and returns the
+ * replaced one, which must be freed by the caller */
+event_option_t *ec_set_option(event_config_t *ec, event_option_t *opt);
+
 /* Returns True if the event is configured to create ticket with restricted
  * access.
  */
@@ -128,7 +142,16 @@ void load_event_description_from_file(event_config_t *event_config, const char*
 GHashTable *load_event_config_data(void);
 /* Frees all loaded data */
 void free_event_config_data(void);
+/* Returns the configuration of the given event. If load_event_config_data()
+ * has not been called, only the files of the requested event are loaded and
+ * the result is added to g_event_config_list. */
 event_config_t *get_event_config(const char *event_name);
+/* Reads the files of the loaded event again and updates its configuration in
+ * place, or removes the event from g_event_config_list if its files are gone;
+ * the removed event is freed by free_event_config_data(). Values loaded from other
+ * sources, e.g. load_event_config_data_from_user_storage(), are dropped.
+ * Returns false if the event was not loaded. */
+bool reload_event_config(const char *event_name);
 event_option_t *get_event_option_from_list(const char *option_name, GList *event_options);
 
 /* for debugging */
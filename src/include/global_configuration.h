@@ -32,6 +32,16 @@ bool load_global_configuration(void);
 #define load_global_configuration_from_dirs libreport_load_global_configuration_from_dirs
 bool load_global_configuration_from_dirs(const char *dirs[], int dir_flags[]);
 
+/**
+ * Loads the configuration loaded by load_global_configuration() again
+ *
+ * The current configuration is kept if the files cannot be loaded.
+ *
+ * @return false if nothing was reloaded.
+ */
+#define reload_global_configuration libreport_reload_global_configuration
+bool reload_global_configuration(void);
+
 #define free_global_configuration libreport_free_global_configuration
 void free_global_configuration(void);
 
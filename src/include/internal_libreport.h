@@ -40,6 +40,7 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/wait.h>
 #include <arpa/inet.h> /* sockaddr_in, sockaddr_in6 etc */
 #include <termios.h>
@@ -221,10 +222,16 @@ ssize_t safe_write(int fd, const void *buf, size_t count);
 ssize_t full_read(int fd, void *buf, size_t count);
 #define full_write libreport_full_write
 ssize_t full_write(int fd, const void *buf, size_t count);
+#define full_writev libreport_full_writev
+ssize_t full_writev(int fd, struct iovec *iov, int iovcnt);
 #define full_write_str libreport_full_write_str
 ssize_t full_write_str(int fd, const char *buf);
 #define xmalloc_read libreport_xmalloc_read
 void* xmalloc_read(int fd, size_t *maxsz_p);
+#define mmap_fd_read libreport_mmap_fd_read
+void *mmap_fd_read(int fd, size_t *size);
+#define munmap_fd_read libreport_munmap_fd_read
+void munmap_fd_read(void *data, size_t size);
 #define xmalloc_open_read_close libreport_xmalloc_open_read_close
 void* xmalloc_open_read_close(const char *filename, size_t *maxsz_p);
 #define xmalloc_xopen_read_close libreport_xmalloc_xopen_read_close
@@ -266,6 +273,37 @@ void sha1_hash(sha1_ctx_t *ctx, const void *buffer, size_t len);
 #define sha1_end libreport_sha1_end
 void sha1_end(sha1_ctx_t *ctx, void *resbuf);
 
+#define SHA256_RESULT_LEN (8 * 4)
+/* sha1_ctx_t has room for the SHA-256 state */
+typedef sha1_ctx_t sha256_ctx_t;
+#define sha256_begin libreport_sha256_begin
+void sha256_begin(sha256_ctx_t *ctx);
+#define sha256_hash libreport_sha256_hash
+void sha256_hash(sha256_ctx_t *ctx, const void *buffer, size_t len);
+#define sha256_end libreport_sha256_end
+void sha256_end(sha256_ctx_t *ctx, void *resbuf);
+
+enum {
+    HASH_SHA1,
+    HASH_SHA256,
+};
+
+/* SHA-1 and SHA-256 use SHA-NI instructions if the CPU supports them.
+ * Disabling them is useful for testing only.
+ */
+#define hash_set_hw_acceleration libreport_hash_set_hw_acceleration
+void hash_set_hw_acceleration(bool enable);
+
+/* Hashes all data read from fd. Regular files are mmaped, other files are
+ * read through a large buffer.
+ *
+ * @param algorithm HASH_SHA1 or HASH_SHA256
+ * @param result SHA1_RESULT_LEN or SHA256_RESULT_LEN bytes
+ * @return length of the digest in bytes; -errno on errors
+ */
+#define hash_fd libreport_hash_fd
+int hash_fd(int fd, int algorithm, uint8_t *result);
+
 /* Helpers to hash a string: */
 #define str_to_sha1 libreport_str_to_sha1
 const uint8_t *str_to_sha1(uint8_t result[SHA1_RESULT_LEN], const char *str);
@@ -655,6 +693,15 @@ struct strbuf *strbuf_append_char(struct strbuf *strbuf, char c);
 struct strbuf *strbuf_append_str(struct strbuf *strbuf,
                                  const char *str);
 
+/**
+ * The current content of the string buffer is extended by adding the
+ * first len bytes of a string str at its end. The string does not need to
+ * be null-terminated.
+ */
+#define strbuf_append_strn libreport_strbuf_append_strn
+struct strbuf *strbuf_append_strn(struct strbuf *strbuf,
+                                  const char *str, unsigned len);
+
 /**
  * The current content of the string buffer is extended by inserting a
  * string str at its beginning.
@@ -841,6 +888,36 @@ char *make_description(problem_data_t *problem_data, char **names_to_skip, unsig
 #define make_description_logger libreport_make_description_logger
 char* make_description_logger(problem_data_t *problem_data, unsigned max_text_size);
 
+/* Appended to a description or a problem report section truncated to its
+ * maximal size */
+#define DESCRIPTION_TRUNCATED_MARK "\n[...truncated...]\n"
+
+/* Receives the description in chunks. Returns 0 or a negative errno value
+ * which stops generating of the description. */
+typedef int (*description_writer_t)(void *param, const char *data, size_t len);
+
+/* Generates the same description as make_description() but passes it to the
+ * writer piece by piece instead of building it in memory.
+ *
+ * @param max_size At most max_size bytes of the description are written and
+ * DESCRIPTION_TRUNCATED_MARK is appended if the description is longer. 0 means
+ * no limit.
+ * @returns 0 or the error returned by the writer.
+ */
+#define make_description_cb libreport_make_description_cb
+int make_description_cb(description_writer_t writer, void *param,
+                        problem_data_t *problem_data, char **names_to_skip,
+                        unsigned max_text_size, unsigned desc_flags,
+                        unsigned long max_size);
+/* Writes the description to the file descriptor, see make_description_cb() */
+#define make_description_fd libreport_make_description_fd
+int make_description_fd(int fd, problem_data_t *problem_data, char **names_to_skip,
+                        unsigned max_text_size, unsigned desc_flags,
+                        unsigned long max_size);
+#define make_description_logger_fd libreport_make_description_logger_fd
+int make_description_logger_fd(int fd, problem_data_t *problem_data, unsigned max_text_size,
+                               unsigned long max_size);
+
 /* See man os-release(5) for details */
 #define OSINFO_ID "ID"
 #define OSINFO_NAME "NAME"
@@ -928,6 +1005,15 @@ void parse_release_for_rhts(const char *pRelease, char **product, char **version
  */
 #define load_conf_file libreport_load_conf_file
 bool load_conf_file(const char *pPath, map_string_t *settings, bool skipKeysWithoutValue);
+
+enum {
+    CONF_FILE_FLAG_NONE = 0,
+    /* Do not try the native parser of the simple "Option = value" files */
+    CONF_FILE_FLAG_AUGEAS = 1,
+};
+
+#define load_conf_file_ext libreport_load_conf_file_ext
+bool load_conf_file_ext(const char *path, map_string_t *settings, bool skipKeysWithoutValue, int flags);
 #define load_plugin_conf_file libreport_load_plugin_conf_file
 bool load_plugin_conf_file(const char *name, map_string_t *settings, bool skipKeysWithoutValue);
 
@@ -991,6 +1077,11 @@ GList *parse_list(const char* list);
 /* Connect to abrtd over unix domain socket, issue DELETE command */
 int delete_dump_dir_possibly_using_abrtd(const char *dump_dir_name);
 
+/* Sends the text items over a connected abrtd socket, returns the HTTP status
+ * code of the response or -1 */
+#define problem_data_send_to_abrt_socket libreport_problem_data_send_to_abrt_socket
+int problem_data_send_to_abrt_socket(int socketfd, problem_data_t *problem_data);
+
 /* Tries to create a copy of dump_dir_name in base_dir, with same or similar basename.
  * Returns NULL if copying failed. In this case, logs a message before returning. */
 #define steal_directory libreport_steal_directory
@@ -30,6 +30,40 @@ CURL* xcurl_easy_init();
 /* Set proxy according to the url and call curl_easy_perform */
 CURLcode curl_easy_perform_with_proxy(CURL *handle, const char *url);
 
+/* HTTP session
+ *
+ * Keeps a curl handle alive between requests so that consecutive requests
+ * to the same host re-use the connection and the TLS session. DNS results and
+ * TLS sessions are also shared among all sessions of the process. Proxies
+ * are looked up once per scheme and host.
+ *
+ * A session must not be used by more threads at once. post() uses a per-thread
+ * session if post_state_t.session is NULL, hence all requests made by one
+ * thread share the connections by default.
+ */
+typedef struct http_session http_session_t;
+
+#define new_http_session libreport_new_http_session
+http_session_t *new_http_session(void);
+#define free_http_session libreport_free_http_session
+void free_http_session(http_session_t *session);
+
+/* Content-Encoding of request bodies */
+enum {
+    POST_ENCODING_IDENTITY = 0,
+    POST_ENCODING_GZIP,
+    /* Only if built with libzstd */
+    POST_ENCODING_ZSTD,
+};
+
+/* Parses the value of the ContentEncoding option of reporters.
+ *
+ * @returns POST_ENCODING_*; NULL, "" and "none" mean POST_ENCODING_IDENTITY;
+ * -1 for unknown or unsupported encodings.
+ */
+#define post_encoding_from_string libreport_post_encoding_from_string
+int post_encoding_from_string(const char *str);
+
 typedef struct post_state {
     /* Supplied by caller: */
     int         flags;
@@ -55,6 +89,20 @@ typedef struct post_state {
     char        *body;
     size_t      body_size;
     char        errmsg[CURL_ERROR_SIZE];
+    /* Supplied by caller, added after the original members to keep their
+     * offsets: */
+    /* NULL = use the calling thread's session */
+    http_session_t *session;
+    /* POST_ENCODING_*: request bodies in memory and streamed bodies are
+     * compressed, files are sent as they are. Compressed responses are
+     * accepted unless it is POST_ENCODING_IDENTITY. */
+    int         content_encoding;
+    /* NULL = "ABRT/" VERSION */
+    const char  *user_agent;
+    /* POST_DATA_FROMFILE_PUT: sends the file from this offset and appends it
+     * to the remote file (HTTP gets "Content-Range"). -1 = continue after
+     * the end of the remote file (FTP, SFTP) */
+    off_t       resume_from;
 } post_state_t;
 
 post_state_t *new_post_state(int flags);
@@ -75,6 +123,8 @@ enum {
     POST_DATA_FROMFILE_AS_FORM_DATA = -4,
     POST_DATA_STRING_AS_FORM_DATA = -5,
     POST_DATA_GET = -6,
+    /* Only the headers of the response */
+    POST_DATA_HEAD = -7,
 };
 int
 post(post_state_t *state,
@@ -133,11 +183,84 @@ post_file_as_form(post_state_t *state,
                      filename, POST_DATA_FROMFILE_AS_FORM_DATA);
 }
 
+/* Streamed request body
+ *
+ * The body is a sequence of literal strings and files. The files are
+ * base64-encoded while the request is being sent, so memory usage does not
+ * depend on their sizes. Typical use is an XML envelope with an embedded
+ * file:
+ *
+ *   post_body_t *body = new_post_body();
+ *   post_body_append_str(body, "<content>");
+ *   post_body_append_fd_base64(body, fd);
+ *   post_body_append_str(body, "</content>");
+ *   post_stream(state, url, "text/xml", NULL, body);
+ *   free_post_body(body);
+ *
+ * The file descriptors are not closed by the body, they are read using
+ * pread() and must stay open until the body is freed.
+ */
+typedef struct post_body post_body_t;
+
+#define new_post_body libreport_new_post_body
+post_body_t *new_post_body(void);
+#define free_post_body libreport_free_post_body
+void free_post_body(post_body_t *body);
+/* The data are copied */
+#define post_body_append_mem libreport_post_body_append_mem
+void post_body_append_mem(post_body_t *body, const char *data, size_t len);
+#define post_body_append_str libreport_post_body_append_str
+void post_body_append_str(post_body_t *body, const char *str);
+/* Appends the base64 encoding of the whole regular file.
+ *
+ * @returns 0 on success; otherwise -errno (fd is not a regular file).
+ */
+#define post_body_append_fd_base64 libreport_post_body_append_fd_base64
+int post_body_append_fd_base64(post_body_t *body, int fd);
+/* Appends the text with the base64 encoding of the whole regular file in
+ * place of the placeholder, which must occur in the text exactly once. Use
+ * a random placeholder, so that it can't occur in the rest of the text.
+ *
+ * @returns 0 on success; -EINVAL if the placeholder does not occur exactly
+ * once; otherwise -errno (fd is not a regular file).
+ */
+#define post_body_append_fd_base64_at libreport_post_body_append_fd_base64_at
+int post_body_append_fd_base64_at(post_body_t *body, const char *text, size_t len,
+                                  const char *placeholder, int fd);
+/* Returns the number of bytes the body will have (the Content-Length) */
+#define post_body_size libreport_post_body_size
+off_t post_body_size(const post_body_t *body);
+
+/* Like post(), but the data are read from the body. The body can be posted
+ * more times (e.g. after a redirect).
+ */
+#define post_stream libreport_post_stream
+int post_stream(post_state_t *state,
+                const char *url,
+                const char *content_type,
+                const char **additional_headers,
+                post_body_t *body);
+
 enum {
     UPLOAD_FILE_NOFLAGS = 0,
     UPLOAD_FILE_HANDLE_ACCESS_DENIALS = 1 << 0,
+    /* Keep a checkpoint next to the file while it is being uploaded and
+     * continue an interrupted upload of the file to the same URL instead of
+     * starting from the beginning (HTTP(S), FTP(S), SFTP and FILE). HTTP
+     * servers must advertise "Accept-Ranges: bytes"; the whole file is sent
+     * if they refuse the Content-Range of PUT with 400, 416 or 501 or if the
+     * remote file does not have the size of the local file afterwards.
+     *
+     * Failed uploads are retried (see UPLOAD_RETRIES_ENV), which blocks the
+     * caller for up to several minutes. */
+    UPLOAD_FILE_RESUMABLE = 1 << 1,
 };
 
+/* Number of retries of resumable uploads which failed because of network
+ * errors. The delay between retries grows exponentially. */
+#define UPLOAD_RETRIES_ENV "LIBREPORT_UPLOAD_RETRIES"
+#define UPLOAD_DEFAULT_RETRIES 3
+
 #define upload_file libreport_upload_file
 char *upload_file(const char *url, const char *filename);
 
@@ -147,6 +270,10 @@ char *upload_file(const char *url, const char *filename);
  *
  * Fails if the url does not have scheme or hostname.
  *
+ * With UPLOAD_FILE_RESUMABLE, uploads which failed because of network errors
+ * or HTTP codes 408, 429 and 5xx are retried $LIBREPORT_UPLOAD_RETRIES times
+ * (UPLOAD_DEFAULT_RETRIES by default). Other uploads are not retried.
+ *
  * @return Resulting URL on success (the URL does not contain userinfo);
  * otherwise NULL.
  */
@@ -156,6 +283,12 @@ char *upload_file_ext(post_state_t *post_state,
                 const char *filename,
                 int flags);
 
+/* Returns the name of the checkpoint of an interrupted resumable upload of
+ * the file (see UPLOAD_FILE_RESUMABLE). The checkpoint exists only until the
+ * upload succeeds. */
+#define upload_checkpoint_path libreport_upload_checkpoint_path
+char *upload_checkpoint_path(const char *filename);
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,10 @@ enum {
      * to a bug report etc.
      */
     CD_FLAG_BIGTXT        = (1 << 6),
+    /* Binary element's data is mapped read-only into memory, see
+     * problem_item_get_data(). The mapping is released together with the item.
+     */
+    CD_FLAG_MAPPED        = (1 << 7),
 };
 
 #define PROBLEM_ITEM_UNINITIALIZED_SIZE ((unsigned long)-1)
@@ -57,6 +61,9 @@ struct problem_item {
     int      allowed_by_reporter;  /* 0 "no", 1 "yes" */
     int      default_by_reporter;  /* 0 "no", 1 "yes" */
     int      required_by_reporter; /* 0 "no", 1 "yes" */
+    /* Valid if CD_FLAG_MAPPED is set */
+    void    *mapped_data;
+    size_t   mapped_size;
 };
 typedef struct problem_item problem_item;
 
@@ -64,6 +71,15 @@ char *problem_item_format(struct problem_item *item);
 
 int problem_item_get_size(struct problem_item *item, unsigned long *size);
 
+/* Returns the item's data without copying it. Content of text items is
+ * returned as is, binary items are mapped read-only (CD_FLAG_MAPPED) and stay
+ * mapped until problem_item_unmap() is called or the item is freed.
+ *
+ * @return NULL on errors (errno is set)
+ */
+const char *problem_item_get_data(struct problem_item *item, size_t *size);
+void problem_item_unmap(struct problem_item *item);
+
 /* In-memory problem data structure and accessors */
 
 typedef GHashTable problem_data_t;
@@ -129,6 +145,14 @@ static inline GList *problem_data_get_all_elements(problem_data_t *problem_data)
  */
 void problem_data_get_osinfo(problem_data_t *problem_data, map_string_t *osinfo);
 
+/**
+  @brief Sends the problem data to abrtd which creates a new dump directory
+
+  Items are sent in batches. Binary items are not sent.
+
+  @param problem_data Problem data object to send
+  @return 0 on success; otherwise non-zero value
+ */
 int problem_data_send_to_abrt(problem_data_t* problem_data);
 
 /* Conversions between in-memory and on-disk formats */
@@ -147,6 +171,11 @@ int problem_data_send_to_abrt(problem_data_t* problem_data);
 int problem_data_load_dump_dir_element(struct dump_dir *dd, const char *name, char **content, int *type_flags, int *fd);
 
 void problem_data_load_from_dump_dir(problem_data_t *problem_data, struct dump_dir *dd, char **excluding);
+/* The same as problem_data_load_from_dump_dir() but the elements are read
+ * concurrently by a pool of threads. Worth it on network file systems where
+ * each open/read round trip is expensive.
+ */
+void problem_data_load_from_dump_dir_parallel(problem_data_t *problem_data, struct dump_dir *dd, char **excluding);
 
 problem_data_t *create_problem_data_from_dump_dir(struct dump_dir *dd);
 /* Helper for typical operation in reporters: */
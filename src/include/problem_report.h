@@ -169,6 +169,7 @@ struct problem_report_settings
 {
     int prs_shortbt_max_frames;       ///< generate only max top frames in %short_backtrace
     size_t prs_shortbt_max_text_size; ///< short bt only if it is bigger then this
+    size_t prs_max_section_size;      ///< truncate longer sections, 0 means no limit
 };
 
 typedef struct problem_report_settings problem_report_settings_t;
@@ -338,6 +339,9 @@ int problem_formatter_load_file(problem_formatter_t* self, const char *path);
  * Creates a new problem report, formats the data according to the loaded
  * format string and stores output in the report.
  *
+ * The format is compiled when it is loaded and the formatter is not modified
+ * here, so one formatter can generate reports of any number of problems.
+ *
  * @param self Problem formatter
  * @param data Problem data to format
  * @param report Pointer where the created problem report is to be stored
@@ -345,6 +349,26 @@ int problem_formatter_load_file(problem_formatter_t* self, const char *path);
  */
 int problem_formatter_generate_report(const problem_formatter_t *self, problem_data_t *data, problem_report_t **report);
 
+/*
+ * Same as problem_formatter_generate_report() but the problem data are loaded
+ * from the given dump directory.
+ *
+ * The rendered report and the short backtrace are cached in the dump
+ * directory's meta-data and reused while the format, the formatter's settings,
+ * the locale and all problem elements are unchanged. The cache is written only
+ * if the caller holds the dump directory's lock, i.e. the directory was not
+ * opened read-only. A failure to write it is not an error.
+ *
+ * @param self Problem formatter
+ * @param data Problem data to format
+ * @param dd Opened dump directory of the problem data, NULL disables the
+ * cache
+ * @param report Pointer where the created problem report is to be stored
+ * @return Zero on success, otherwise non-zero value.
+ */
+int problem_formatter_generate_report_ext(const problem_formatter_t *self, problem_data_t *data,
+                                          struct dump_dir *dd, problem_report_t **report);
+
 /*
  * Returns problem report settings from given formatter
  *
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/** @file sensitive_words.h
+ *
+ * Searching for possibly sensitive data in problem elements
+ *
+ * The lists of sensitive and ignored words are compiled once into an
+ * Aho-Corasick automaton, so a text is scanned in one pass regardless of the
+ * number of words. An occurrence of a sensitive word is not reported if it is
+ * a part of an occurrence of an ignored word, e.g. "key" in "keyboard".
+ *
+ * Ignored words are always matched case sensitively. Case insensitive
+ * matching of the sensitive words folds the characters whose lower case form
+ * has the same length in UTF-8, so the reported offsets are always offsets in
+ * the scanned text.
+ */
+#ifndef LIBREPORT_SENSITIVE_WORDS_H
+#define LIBREPORT_SENSITIVE_WORDS_H
+
+#include <glib.h>
+
+#include "problem_data.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The default lists, see load_words_from_file() */
+#define SENSITIVE_WORDS_FILE "forbidden_words.conf"
+#define IGNORED_WORDS_FILE "ignored_words.conf"
+
+enum {
+    SENSITIVE_WORDS_CASE_INSENSITIVE = 1 << 0,
+};
+
+typedef struct sensitive_words sensitive_words_t;
+
+struct sensitive_word_match
+{
+    size_t swm_start;      ///< byte offset of the first byte
+    size_t swm_end;        ///< byte offset after the last byte
+    const char *swm_word;  ///< the matching word, owned by sensitive_words_t
+};
+
+/* Compiles the lists of words, the lists are not referenced afterwards.
+ * Empty words are skipped.
+ *
+ * @param flags SENSITIVE_WORDS_CASE_INSENSITIVE
+ */
+#define sensitive_words_new libreport_sensitive_words_new
+sensitive_words_t *sensitive_words_new(GList *words, GList *ignored_words, int flags);
+
+/* Compiles SENSITIVE_WORDS_FILE and IGNORED_WORDS_FILE */
+#define sensitive_words_load_default libreport_sensitive_words_load_default
+sensitive_words_t *sensitive_words_load_default(int flags);
+
+#define sensitive_words_free libreport_sensitive_words_free
+void sensitive_words_free(sensitive_words_t *self);
+
+/* Returns the list of struct sensitive_word_match ordered by their offsets.
+ * Overlapping occurrences of different words are all reported.
+ */
+#define sensitive_words_scan libreport_sensitive_words_scan
+GList *sensitive_words_scan(const sensitive_words_t *self, const char *text, size_t len);
+
+#define sensitive_word_matches_free libreport_sensitive_word_matches_free
+void sensitive_word_matches_free(GList *matches);
+
+/* Scans all text elements.
+ *
+ * @returns a map of element names to non-empty lists of matches, see
+ * sensitive_words_scan(). The map is never NULL.
+ */
+#define sensitive_words_scan_problem_data libreport_sensitive_words_scan_problem_data
+GHashTable *sensitive_words_scan_problem_data(const sensitive_words_t *self, problem_data_t *problem_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBREPORT_SENSITIVE_WORDS_H */
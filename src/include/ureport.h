@@ -65,6 +65,7 @@ struct ureport_server_config
     char *ur_username;    ///< username for basic HTTP auth
     char *ur_password;    ///< password for basic HTTP auth
     map_string_t *ur_http_headers; ///< Additional HTTP headers
+    int ur_content_encoding; ///< Compression of uploaded reports (POST_ENCODING_*)
 
     struct ureport_preferences ur_prefs; ///< configuration for uReport generation
 };
@@ -242,6 +243,95 @@ ureport_do_post(const char *json, struct ureport_server_config *config,
 struct ureport_server_response *
 ureport_submit(const char *json_ureport, struct ureport_server_config *config);
 
+/*
+ * Outbound queue
+ *
+ * uReports which could not be submitted because the server was unreachable
+ * are kept in a spool directory and delivered later. The server counts every
+ * received uReport as an occurrence of the problem, hence every queued
+ * uReport is delivered on its own.
+ *
+ * The queue is $LIBREPORT_UREPORT_QUEUE_DIR, LOCALSTATEDIR/spool/libreport/ureport
+ * for root and $XDG_CACHE_HOME/libreport/ureport-queue for other users.
+ */
+#define UREPORT_QUEUE_DIR_ENV "LIBREPORT_UREPORT_QUEUE_DIR"
+#define UREPORT_QUEUE_DEFAULT_CONCURRENCY 4
+
+/*
+ * @return Malloced path to the queue directory
+ */
+#define ureport_queue_dir libreport_ureport_queue_dir
+char *
+ureport_queue_dir(void);
+
+/*
+ * Add uReport to the queue of the server
+ *
+ * @param json Queued data
+ * @param dump_dir_path Dump dir of the uReport or NULL; gets the response
+ *                      once the uReport is delivered
+ * @param config Configuration used in communication
+ * @return 0 on success; otherwise -1.
+ */
+#define ureport_queue_add libreport_ureport_queue_add
+int
+ureport_queue_add(const char *json, const char *dump_dir_path,
+                  struct ureport_server_config *config);
+
+/*
+ * Check whether a recent attempt to reach the server failed and the back-off
+ * period has not elapsed yet
+ *
+ * @param config Configuration used in communication
+ * @return True if the server should not be contacted now
+ */
+#define ureport_queue_server_unreachable libreport_ureport_queue_server_unreachable
+bool
+ureport_queue_server_unreachable(struct ureport_server_config *config);
+
+/*
+ * Count queued uReports of the server
+ *
+ * @param config Configuration used in communication
+ * @return Number of queued uReports
+ */
+#define ureport_queue_length libreport_ureport_queue_length
+unsigned
+ureport_queue_length(struct ureport_server_config *config);
+
+/*
+ * Submit queued uReports of the server
+ *
+ * At most max_concurrency uReports are being submitted at once. Delivery
+ * stops at the first network failure and the rest stays queued. The
+ * responses are saved in the dump dirs of the delivered uReports.
+ *
+ * @param config Configuration used in communication
+ * @param max_concurrency Number of concurrent submissions, 0 means default
+ * @return Number of uReports left in the queue or -1 if the queue cannot
+ *         be accessed
+ */
+#define ureport_queue_deliver libreport_ureport_queue_deliver
+int
+ureport_queue_deliver(struct ureport_server_config *config, unsigned max_concurrency);
+
+/*
+ * Submit uReport on server or queue it if the server is unreachable
+ *
+ * The uReport is queued without contacting the server while the server is
+ * backing off after a network failure or HTTP codes 408, 429 and 5xx.
+ *
+ * @param json Sent data
+ * @param dump_dir_path Dump dir of the uReport or NULL
+ * @param config Configuration used in communication
+ * @param queued Set to true if the uReport was queued
+ * @return Malloced, parsed server response; NULL if queued or on errors
+ */
+#define ureport_submit_or_queue libreport_ureport_submit_or_queue
+struct ureport_server_response *
+ureport_submit_or_queue(const char *json, const char *dump_dir_path,
+                        struct ureport_server_config *config, bool *queued);
+
 /*
  * Build a new uReport attachement from give arguments
  *
@@ -295,6 +385,53 @@ ureport_from_dump_dir(const char *dump_dir_path);
 char *ureport_from_dump_dir_ext(const char *dump_dir_path,
                                 const struct ureport_preferences *preferences);
 
+/*
+ * Build uReports from dump dirs concurrently
+ *
+ * Failures of single dump dirs are logged, UREPORT_PREF_FLAG_RETURN_ON_FAILURE
+ * is implied.
+ *
+ * @param dump_dir_paths FS paths to dump dirs
+ * @param count Number of dump dirs
+ * @param preferences uReport generation configuration or NULL
+ * @return Malloced NULL-terminated vector of count malloced JSON strings, an
+ *         item is NULL if the uReport of the dump dir could not be built
+ */
+#define ureport_from_dump_dirs libreport_ureport_from_dump_dirs
+char **
+ureport_from_dump_dirs(const char *const *dump_dir_paths, unsigned count,
+                       const struct ureport_preferences *preferences);
+
+/*
+ * Submit uReports on server through one connection
+ *
+ * The submission stops at the first communication error.
+ *
+ * @param json_ureports Sent data, NULL items are skipped
+ * @param count Number of uReports
+ * @param config Configuration used in communication
+ * @return Malloced vector of count parsed server responses, an item is NULL
+ *         if the uReport was not submitted
+ */
+#define ureport_submit_many libreport_ureport_submit_many
+struct ureport_server_response **
+ureport_submit_many(const char *const *json_ureports, unsigned count,
+                    struct ureport_server_config *config);
+
+/*
+ * Build uReports from dump dirs, submit them and save the responses in the
+ * dump dirs
+ *
+ * @param dump_dir_paths FS paths to dump dirs
+ * @param count Number of dump dirs
+ * @param config Configuration used in communication
+ * @return Number of submitted uReports
+ */
+#define ureport_submit_dump_dirs libreport_ureport_submit_dump_dirs
+unsigned
+ureport_submit_dump_dirs(const char *const *dump_dir_paths, unsigned count,
+                         struct ureport_server_config *config);
+
 #ifdef __cplusplus
 }
 #endif
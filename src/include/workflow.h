@@ -32,8 +32,19 @@ typedef struct workflow workflow_t;
 extern GHashTable *g_workflow_list;
 
 workflow_t *new_workflow(const char *name);
+/* Loads WORKFLOWS_DIR/<name>.xml on the first request if the workflow list
+ * has not been loaded completely yet */
 workflow_t *get_workflow(const char *name);
+/* Reads the XML file of the loaded workflow again and updates the workflow in
+ * place, or removes it from g_workflow_list if the file is gone; the removed
+ * workflow is freed by free_workflow_list(). Returns false if the workflow was
+ * not loaded. */
+#define reload_workflow libreport_reload_workflow
+bool reload_workflow(const char *name);
 void free_workflow(workflow_t *w);
+/* Frees the workflows and sets *wl to NULL. If it is g_workflow_list, the
+ * workflows are loaded on demand again. */
+void free_workflow_list(GHashTable **wl);
 
 void load_workflow_description_from_file(workflow_t *w, const char *filename);
 config_item_info_t *workflow_get_config_info(workflow_t *w);
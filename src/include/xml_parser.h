@@ -27,6 +27,8 @@ struct my_parse_data
     bool in_event_list;
     bool exact_name;
     bool exact_description;
+    /* if not NULL, event names are collected instead of loading the events */
+    GList **event_names;
 };
 
 /**
@@ -46,6 +46,37 @@ static int connect_to_abrtd_socket()
     return socketfd;
 }
 
+/* Reads abrtd's "HTTP/1.1 NNN ..." response line.
+ * returns: NNN
+ * -1 on error
+ */
+static int read_abrtd_response(int socketfd)
+{
+    char response[64];
+    int r = full_read(socketfd, response, sizeof(response) - 1);
+    if (r < 0)
+        return -1;
+
+    log_notice("Response via socket:'%.*s'", r, response);
+    if (r < 13)
+        return -1;
+
+    /*  0123456789...  */
+    /* "HTTP/1.1 200 " */
+    response[5] = '1';
+    response[7] = '1';
+    if (strncmp(response, "HTTP/1.1 ", strlen("HTTP/1.1 ")) == 0
+        && isdigit(response[9])
+        && isdigit(response[10])
+        && isdigit(response[11])
+        && response[12] == ' ')
+    {
+        return (response[9] - '0') * 100 + (response[10] - '0') * 10 + (response[11] - '0');
+    }
+
+    return -1;
+}
+
 static int connect_to_abrtd_and_call_DeleteDebugDump(const char *dump_dir_name)
 {
     int result = -1; /* error so far */
@@ -57,24 +88,7 @@ static int connect_to_abrtd_and_call_DeleteDebugDump(const char *dump_dir_name)
         full_write(socketfd, " HTTP/1.1\r\n\r\n", strlen(" HTTP/1.1\r\n\r\n"));
         shutdown(socketfd, SHUT_WR);
 
-        char response[64];
-        int r = full_read(socketfd, response, sizeof(response) - 1);
-        if (r >= 0)
-        {
-            log_notice("Response via socket:'%.*s'", r, response);
-            /*  0123456789...  */
-            /* "HTTP/1.1 200 " */
-            response[5] = '1';
-            response[7] = '1';
-            if (strncmp(response, "HTTP/1.1 ", strlen("HTTP/1.1 ")) == 0
-                && isdigit(response[9])
-                && isdigit(response[10])
-                && isdigit(response[11])
-                && response[12] == ' ')
-            {
-                result = (response[9] - '0') * 100 + (response[10] - '0') * 10 + (response[11] - '0');
-            }
-        }
+        result = read_abrtd_response(socketfd);
     }
 
     close(socketfd);
@@ -82,56 +96,108 @@ static int connect_to_abrtd_and_call_DeleteDebugDump(const char *dump_dir_name)
     return result;
 }
 
-int problem_data_send_to_abrt(problem_data_t* problem_data)
+/* Items are not written one by one, they are collected in an iovec array
+ * and flushed by a single writev() once the array or the byte budget fills up.
+ */
+#define SEND_BATCH_IOVECS 128
+#define SEND_BATCH_BYTES  (256 * 1024)
+
+struct send_batch
 {
-    int result = 1; /* error so far */
-    int socketfd = connect_to_abrtd_socket();
-    if (socketfd != -1)
+    int fd;
+    int cnt;
+    size_t bytes;
+    bool failed;
+    struct iovec iov[SEND_BATCH_IOVECS];
+};
+
+static void send_batch_flush(struct send_batch *batch)
+{
+    if (batch->cnt == 0)
+        return;
+
+    if (!batch->failed && full_writev(batch->fd, batch->iov, batch->cnt) != (ssize_t)batch->bytes)
     {
-        GHashTableIter iter;
-        char *name;
-        struct problem_item *value;
-        g_hash_table_iter_init(&iter, problem_data);
+        perror_msg("Can't send problem data to abrtd");
+        batch->failed = true;
+    }
 
-        full_write(socketfd, "PUT / HTTP/1.1\r\n\r\n", strlen("PUT / HTTP/1.1\r\n\r\n"));
-        while (g_hash_table_iter_next(&iter, (void**)&name, (void**)&value))
-        {
-            if (value->flags & CD_FLAG_BIN)
-            {
-                /* sending files over the socket is not implemented yet */
-                log_warning("Skipping binary file %s", name);
-                continue;
-            }
-
-            /* only files should contain '/' and those are handled earlier */
-            if (name[0] == '.' || strchr(name, '/'))
-            {
-                error_msg("Problem data field name contains disallowed chars: '%s'", name);
-                continue;
-            }
-
-            char* msg = xasprintf("%s=%s", name, value->content);
-            full_write(socketfd, msg, strlen(msg)+1 /* yes, +1 coz we want to send the trailing 0 */);
-            free(msg);
-        }
-        shutdown(socketfd, SHUT_WR);
+    batch->cnt = 0;
+    batch->bytes = 0;
+}
 
-        char response[64];
-        int r = full_read(socketfd, response, sizeof(response) - 1);
-        if (r >= 0)
+/* Memory pointed to by 'data' must stay valid until the next flush */
+static void send_batch_add(struct send_batch *batch, const void *data, size_t len)
+{
+    if (batch->cnt == SEND_BATCH_IOVECS)
+        send_batch_flush(batch);
+
+    batch->iov[batch->cnt].iov_base = (void *)data;
+    batch->iov[batch->cnt].iov_len = len;
+    batch->cnt++;
+    batch->bytes += len;
+
+    if (batch->bytes >= SEND_BATCH_BYTES)
+        send_batch_flush(batch);
+}
+
+static bool is_sendable_item_name(const char *name)
+{
+    /* only files should contain '/' and those are handled earlier */
+    if (name[0] == '.' || strchr(name, '/'))
+    {
+        error_msg("Problem data field name contains disallowed chars: '%s'", name);
+        return false;
+    }
+    return true;
+}
+
+/* "name=value\0" records, binary items are not supported */
+int problem_data_send_to_abrt_socket(int socketfd, problem_data_t *problem_data)
+{
+    GHashTableIter iter;
+    char *name;
+    struct problem_item *value;
+    g_hash_table_iter_init(&iter, problem_data);
+
+    struct send_batch *batch = xzalloc(sizeof(*batch));
+    batch->fd = socketfd;
+
+    full_write(socketfd, "PUT / HTTP/1.1\r\n\r\n", strlen("PUT / HTTP/1.1\r\n\r\n"));
+    while (g_hash_table_iter_next(&iter, (void**)&name, (void**)&value))
+    {
+        if (value->flags & CD_FLAG_BIN)
         {
-            log_notice("Response via socket:'%.*s'", r, response);
-            /*  0123456789...  */
-            /* "HTTP/1.1 200 " */
-            response[5] = '1';
-            response[7] = '1';
-            result = strncmp(response, "HTTP/1.1 201 ", strlen("HTTP/1.1 201 "));
+            /* sending files over the socket is not implemented yet */
+            log_warning("Skipping binary file %s", name);
+            continue;
         }
 
-        close(socketfd);
+        if (!is_sendable_item_name(name))
+            continue;
+
+        send_batch_add(batch, name, strlen(name));
+        send_batch_add(batch, "=", 1);
+        /* yes, +1 coz we want to send the trailing 0 */
+        send_batch_add(batch, value->content, strlen(value->content) + 1);
     }
+    send_batch_flush(batch);
+    shutdown(socketfd, SHUT_WR);
 
-    return result;
+    free(batch);
+    return read_abrtd_response(socketfd);
+}
+
+int problem_data_send_to_abrt(problem_data_t* problem_data)
+{
+    int socketfd = connect_to_abrtd_socket();
+    if (socketfd == -1)
+        return 1;
+
+    const int status = problem_data_send_to_abrt_socket(socketfd, problem_data);
+    close(socketfd);
+
+    return status != 201;
 }
 
 int delete_dump_dir_possibly_using_abrtd(const char *dump_dir_name)
@@ -19,6 +19,13 @@
 #include "internal_libreport.h"
 #include "abrt_xmlrpc.h"
 #include "proxies.h"
+#include "libreport_curl.h"
+
+#ifdef VERSION
+# define ABRT_XMLRPC_USER_AGENT PACKAGE_NAME"/"VERSION
+#else
+# define ABRT_XMLRPC_USER_AGENT "abrt"
+#endif
 
 struct abrt_xmlrpc_param_pair
 {
@@ -26,6 +33,22 @@ struct abrt_xmlrpc_param_pair
     xmlrpc_value *value;
 };
 
+struct abrt_xmlrpc_queued_call
+{
+    char *method;
+    /* The parameter array including the session parameters */
+    xmlrpc_value *params;
+    abrt_xmlrpc_completion_fn completion;
+    void *user_data;
+};
+
+static void abrt_xmlrpc_queued_call_free(struct abrt_xmlrpc_queued_call *call)
+{
+    free(call->method);
+    xmlrpc_DECREF(call->params);
+    free(call);
+}
+
 void abrt_xmlrpc_die(xmlrpc_env *env)
 {
     error_msg_and_die("fatal: %s", env->fault_string);
@@ -43,6 +66,8 @@ struct abrt_xmlrpc *abrt_xmlrpc_new_client(const char *url, int ssl_verify)
     xmlrpc_env_init(&env);
 
     struct abrt_xmlrpc *ax = xzalloc(sizeof(struct abrt_xmlrpc));
+    ax->ax_url = xstrdup(url);
+    ax->ax_ssl_verify = ssl_verify;
 
     /* This should be done at program startup, once. We do it in main */
     /* xmlrpc_client_setup_global_const(&env); */
@@ -64,11 +89,7 @@ struct abrt_xmlrpc *abrt_xmlrpc_new_client(const char *url, int ssl_verify)
     /* curlParms.network_interface = NULL; - done by memset */
     curl_parms.no_ssl_verifypeer = !ssl_verify;
     curl_parms.no_ssl_verifyhost = !ssl_verify;
-#ifdef VERSION
-    curl_parms.user_agent        = PACKAGE_NAME"/"VERSION;
-#else
-    curl_parms.user_agent        = "abrt";
-#endif
+    curl_parms.user_agent        = ABRT_XMLRPC_USER_AGENT;
 
     proxies = get_proxy_list(url);
     /* Use the first proxy from the list */
@@ -106,6 +127,9 @@ void abrt_xmlrpc_free_client(struct abrt_xmlrpc *ax)
     if (!ax)
         return;
 
+    /* The callers rely on the queued calls being performed */
+    abrt_xmlrpc_flush_calls(ax);
+
     if (ax->ax_server_info)
         xmlrpc_server_info_free(ax->ax_server_info);
 
@@ -122,6 +146,7 @@ void abrt_xmlrpc_free_client(struct abrt_xmlrpc *ax)
 
     g_list_free(ax->ax_session_params);
 
+    free(ax->ax_url);
     free(ax);
 }
 
@@ -138,8 +163,11 @@ void abrt_xmlrpc_client_add_session_param_string(xmlrpc_env *env, struct abrt_xm
     ax->ax_session_params = g_list_append(ax->ax_session_params, new_ses_param);
 }
 
-/* internal helper function */
-static xmlrpc_value *abrt_xmlrpc_call_params_internal(xmlrpc_env *env, struct abrt_xmlrpc *ax, const char *method, xmlrpc_value *params)
+/* internal helper function
+ *
+ * Returns the parameter array of a call with the session parameters added.
+ */
+static xmlrpc_value *abrt_xmlrpc_param_array_new(xmlrpc_env *env, struct abrt_xmlrpc *ax, xmlrpc_value *params)
 {
     xmlrpc_value *array = xmlrpc_array_new(env);
     if (env->fault_occurred)
@@ -172,13 +200,111 @@ static xmlrpc_value *abrt_xmlrpc_call_params_internal(xmlrpc_env *env, struct ab
     if (env->fault_occurred)
         abrt_xmlrpc_die(env);
 
-    xmlrpc_value *result = NULL;
-    xmlrpc_client_call2(env, ax->ax_client, ax->ax_server_info, method,
-                        array, &result);
-
     if (destroy_params)
         xmlrpc_DECREF(params);
 
+    return array;
+}
+
+/* internal helper function
+ *
+ * Sends the serialized call without xmlrpc-c's transport, which can neither
+ * compress nor stream requests, and parses the response.
+ *
+ * The request gets the transport settings abrt_xmlrpc_new_client() gives
+ * to xmlrpc-c: the SSL verification, the user agent and the proxy, which
+ * post() takes from the same list.
+ */
+static xmlrpc_value *abrt_xmlrpc_post_body(xmlrpc_env *env, struct abrt_xmlrpc *ax,
+                               post_body_t *body)
+{
+    post_state_t *post_state = new_post_state(0
+            + POST_WANT_BODY
+            + POST_WANT_ERROR_MSG
+            + (ax->ax_ssl_verify ? POST_WANT_SSL_VERIFY : 0)
+    );
+    post_state->content_encoding = ax->ax_content_encoding;
+    post_state->user_agent = ABRT_XMLRPC_USER_AGENT;
+
+    post_stream(post_state, ax->ax_url, "text/xml", NULL, body);
+
+    xmlrpc_value *result = NULL;
+
+    if (post_state->http_resp_code != 200)
+    {
+        const char *errmsg = post_state->curl_error_msg;
+        if (errmsg && errmsg[0])
+            xmlrpc_env_set_fault_formatted(env, XMLRPC_NETWORK_ERROR,
+                    "Error in XML-RPC request at '%s': %s", ax->ax_url, errmsg);
+        else
+            xmlrpc_env_set_fault_formatted(env, XMLRPC_NETWORK_ERROR,
+                    "Error in XML-RPC request at '%s': HTTP code %d",
+                    ax->ax_url, post_state->http_resp_code);
+    }
+    else
+    {
+        int fault_code = 0;
+        const char *fault_string = NULL;
+        xmlrpc_parse_response2(env, post_state->body, post_state->body_size,
+                               &result, &fault_code, &fault_string);
+
+        if (!env->fault_occurred && fault_string)
+        {
+            xmlrpc_env_set_fault(env, fault_code, fault_string);
+            xmlrpc_strfree(fault_string);
+        }
+    }
+
+
+    free_post_state(post_state);
+    return result;
+}
+
+/* internal helper function
+ *
+ * Like xmlrpc_client_call2() but compresses the request if configured.
+ */
+static void abrt_xmlrpc_perform(xmlrpc_env *env, struct abrt_xmlrpc *ax,
+                               const char *method, xmlrpc_value *array,
+                               xmlrpc_value **result)
+{
+    *result = NULL;
+
+    if (ax->ax_content_encoding == POST_ENCODING_IDENTITY)
+    {
+        xmlrpc_client_call2(env, ax->ax_client, ax->ax_server_info, method,
+                            array, result);
+        return;
+    }
+
+    xmlrpc_mem_block *call_xml = XMLRPC_MEMBLOCK_NEW(char, env, 0);
+    if (env->fault_occurred)
+        return;
+
+    xmlrpc_serialize_call(env, call_xml, method, array);
+    if (!env->fault_occurred)
+    {
+        post_body_t *body = new_post_body();
+        post_body_append_mem(body, XMLRPC_MEMBLOCK_CONTENTS(char, call_xml),
+                             XMLRPC_MEMBLOCK_SIZE(char, call_xml));
+        *result = abrt_xmlrpc_post_body(env, ax, body);
+        free_post_body(body);
+    }
+
+    XMLRPC_MEMBLOCK_FREE(char, call_xml);
+}
+
+/* internal helper function */
+static xmlrpc_value *abrt_xmlrpc_call_params_internal(xmlrpc_env *env, struct abrt_xmlrpc *ax, const char *method, xmlrpc_value *params)
+{
+    /* Keep the order of the calls */
+    abrt_xmlrpc_flush_calls(ax);
+
+    xmlrpc_value *array = abrt_xmlrpc_param_array_new(env, ax, params);
+
+    xmlrpc_value *result = NULL;
+    abrt_xmlrpc_perform(env, ax, method, array, &result);
+
     xmlrpc_DECREF(array);
     return result;
 }
@@ -301,3 +427,344 @@ xmlrpc_value *abrt_xmlrpc_call(struct abrt_xmlrpc *ax,
 
     return result;
 }
+
+xmlrpc_value *abrt_xmlrpc_call_params_fd(xmlrpc_env *env, struct abrt_xmlrpc *ax,
+                               const char *method, xmlrpc_value *params,
+                               const char *fd_name, int fd)
+{
+    abrt_xmlrpc_flush_calls(ax);
+
+    /* The file's member gets a random value which is replaced by the file in
+     * the serialized call, so the call is serialized by xmlrpc-c and the file
+     * is never loaded to memory */
+    unsigned char nonce[48];
+    for (size_t i = 0; i < sizeof(nonce); ++i)
+        nonce[i] = g_random_int_range(0, 256);
+
+    xmlrpc_value *placeholder = xmlrpc_base64_new(env, sizeof(nonce), nonce);
+    if (env->fault_occurred)
+        abrt_xmlrpc_die(env);
+
+    xmlrpc_struct_set_value(env, params, fd_name, placeholder);
+    xmlrpc_DECREF(placeholder);
+    if (env->fault_occurred)
+        abrt_xmlrpc_die(env);
+
+    xmlrpc_value *array = abrt_xmlrpc_param_array_new(env, ax, params);
+
+    xmlrpc_mem_block *call_xml = XMLRPC_MEMBLOCK_NEW(char, env, 0);
+    if (env->fault_occurred)
+        abrt_xmlrpc_die(env);
+
+    xmlrpc_serialize_call(env, call_xml, method, array);
+    xmlrpc_DECREF(array);
+    if (env->fault_occurred)
+        abrt_xmlrpc_die(env);
+
+    /* 48 bytes are encoded without padding and line breaks */
+    char *encoded_nonce = encode_base64(nonce, sizeof(nonce));
+
+    post_body_t *body = new_post_body();
+    const int r = post_body_append_fd_base64_at(body,
+            XMLRPC_MEMBLOCK_CONTENTS(char, call_xml),
+            XMLRPC_MEMBLOCK_SIZE(char, call_xml),
+            encoded_nonce, fd);
+
+    free(encoded_nonce);
+    XMLRPC_MEMBLOCK_FREE(char, call_xml);
+
+    xmlrpc_value *result = NULL;
+    if (r < 0)
+        xmlrpc_env_set_fault_formatted(env, XMLRPC_INTERNAL_ERROR,
+                "Can't attach the file: %s", strerror(-r));
+    else
+        result = abrt_xmlrpc_post_body(env, ax, body);
+
+    free_post_body(body);
+
+    return result;
+}
+
+struct abrt_xmlrpc_async_call
+{
+    abrt_xmlrpc_completion_fn completion;
+    void *user_data;
+};
+
+/* internal helper function, called by xmlrpc-c from the event loop */
+static void abrt_xmlrpc_handle_response(const char *server_url, const char *method,
+                                        xmlrpc_value *param_array, void *user_data,
+                                        xmlrpc_env *fault, xmlrpc_value *result)
+{
+    struct abrt_xmlrpc_async_call *call = user_data;
+
+    call->completion(method, fault, result, call->user_data);
+
+    free(call);
+}
+
+/* internal helper function
+ *
+ * Builds the parameter array of a call including the session parameters.
+ */
+static xmlrpc_value *abrt_xmlrpc_build_param_array_va(struct abrt_xmlrpc *ax,
+                                                      const char *format, va_list args)
+{
+    xmlrpc_env env;
+    xmlrpc_env_init(&env);
+
+    xmlrpc_value* param = NULL;
+    const char* suffix;
+
+    xmlrpc_build_value_va(&env, format, args, &param, &suffix);
+    if (env.fault_occurred)
+        abrt_xmlrpc_die(&env);
+
+    if (*suffix != '\0')
+        error_msg_and_die("Junk after the argument specifier: '%s'", suffix); /* bug */
+
+    xmlrpc_value *array = abrt_xmlrpc_param_array_new(&env, ax, param);
+    xmlrpc_DECREF(param);
+
+    return array;
+}
+
+void abrt_xmlrpc_start_call(struct abrt_xmlrpc *ax, const char *method,
+                            abrt_xmlrpc_completion_fn completion, void *user_data,
+                            const char *format, ...)
+{
+    /* Keep the order of the calls */
+    abrt_xmlrpc_flush_calls(ax);
+
+    va_list args;
+    va_start(args, format);
+    xmlrpc_value *array = abrt_xmlrpc_build_param_array_va(ax, format, args);
+    va_end(args);
+
+    xmlrpc_env env;
+    xmlrpc_env_init(&env);
+
+    struct abrt_xmlrpc_async_call *call = xmalloc(sizeof(*call));
+    call->completion = completion;
+    call->user_data = user_data;
+
+    /* The array is referenced by xmlrpc-c until the call is finished */
+    xmlrpc_client_start_rpc(&env, ax->ax_client, ax->ax_server_info, method,
+                            array, abrt_xmlrpc_handle_response, call);
+    xmlrpc_DECREF(array);
+
+    /* The response handler is not called if the call was not started */
+    if (env.fault_occurred)
+    {
+        completion(method, &env, NULL, user_data);
+        free(call);
+    }
+
+    xmlrpc_env_clean(&env);
+}
+
+void abrt_xmlrpc_finish_calls(struct abrt_xmlrpc *ax)
+{
+    xmlrpc_client_event_loop_finish(ax->ax_client);
+}
+
+void abrt_xmlrpc_queue_call(struct abrt_xmlrpc *ax, const char *method,
+                            abrt_xmlrpc_completion_fn completion, void *user_data,
+                            const char *format, ...)
+{
+    struct abrt_xmlrpc_queued_call *call = xmalloc(sizeof(*call));
+    call->method = xstrdup(method);
+    call->completion = completion;
+    call->user_data = user_data;
+
+    va_list args;
+    va_start(args, format);
+    call->params = abrt_xmlrpc_build_param_array_va(ax, format, args);
+    va_end(args);
+
+    ax->ax_queued_calls = g_list_append(ax->ax_queued_calls, call);
+}
+
+/* internal helper function
+ *
+ * Returns the system.multicall parameters:
+ * [ [ {methodName: METHOD, params: [PARAMS]}, ... ] ]
+ */
+static xmlrpc_value *abrt_xmlrpc_multicall_params_new(xmlrpc_env *env, GList *calls)
+{
+    xmlrpc_value *call_array = abrt_xmlrpc_array_new(env);
+
+    for (GList *iter = calls; iter; iter = g_list_next(iter))
+    {
+        struct abrt_xmlrpc_queued_call *call = iter->data;
+
+        xmlrpc_value *call_struct = abrt_xmlrpc_params_new(env);
+        abrt_xmlrpc_params_add_string(env, call_struct, "methodName", call->method);
+        abrt_xmlrpc_params_add_array(env, call_struct, "params", call->params);
+
+        xmlrpc_array_append_item(env, call_array, call_struct);
+        xmlrpc_DECREF(call_struct);
+        if (env->fault_occurred)
+            abrt_xmlrpc_die(env);
+    }
+
+    xmlrpc_value *params = abrt_xmlrpc_array_new(env);
+    xmlrpc_array_append_item(env, params, call_array);
+    xmlrpc_DECREF(call_array);
+    if (env->fault_occurred)
+        abrt_xmlrpc_die(env);
+
+    return params;
+}
+
+/* internal helper function
+ *
+ * Passes a system.multicall response item to the completion function. The item
+ * is either an array with the result or a fault struct.
+ */
+static void abrt_xmlrpc_complete_multicall_item(struct abrt_xmlrpc_queued_call *call,
+                                                xmlrpc_value *item)
+{
+    xmlrpc_env env;
+    xmlrpc_env_init(&env);
+
+    xmlrpc_value *result = NULL;
+    if (xmlrpc_value_type(item) == XMLRPC_TYPE_ARRAY)
+        xmlrpc_array_read_item(&env, item, 0, &result);
+    else
+    {
+        xmlrpc_env decompose_env;
+        xmlrpc_env_init(&decompose_env);
+
+        int fault_code = 0;
+        const char *fault_string = NULL;
+        xmlrpc_decompose_value(&decompose_env, item, "{s:i,s:s,*}",
+                               "faultCode", &fault_code,
+                               "faultString", &fault_string);
+        if (decompose_env.fault_occurred)
+            xmlrpc_env_set_fault(&env, XMLRPC_PARSE_ERROR, "Invalid system.multicall response");
+        else
+        {
+            xmlrpc_env_set_fault(&env, fault_code, fault_string);
+            free((char *)fault_string);
+        }
+
+        xmlrpc_env_clean(&decompose_env);
+    }
+
+    call->completion(call->method, &env, result, call->user_data);
+
+    if (result)
+        xmlrpc_DECREF(result);
+    xmlrpc_env_clean(&env);
+}
+
+/* internal helper function
+ *
+ * XML-RPC servers report calls of unknown methods with one of these fault
+ * codes, the former is used by xmlrpc-c, the latter by most other servers.
+ */
+static bool abrt_xmlrpc_is_no_such_method(const xmlrpc_env *env)
+{
+    return env->fault_code == XMLRPC_NO_SUCH_METHOD_ERROR
+        || env->fault_code == -32601;
+}
+
+/* internal helper function
+ *
+ * Sends the calls in one system.multicall request. Returns false if the server
+ * does not know system.multicall and no completion function was called.
+ *
+ * Any other failure is passed to the completion functions of all calls, the
+ * calls might have been performed, so it's not safe to repeat them.
+ */
+static bool abrt_xmlrpc_multicall(struct abrt_xmlrpc *ax, GList *calls)
+{
+    xmlrpc_env env;
+    xmlrpc_env_init(&env);
+
+    xmlrpc_value *params = abrt_xmlrpc_multicall_params_new(&env, calls);
+
+    xmlrpc_value *response = NULL;
+    abrt_xmlrpc_perform(&env, ax, "system.multicall", params, &response);
+    xmlrpc_DECREF(params);
+
+    if (env.fault_occurred)
+    {
+        log_notice("system.multicall failed: (%d) %s", env.fault_code, env.fault_string);
+
+        const bool unknown = abrt_xmlrpc_is_no_such_method(&env);
+        for (GList *iter = calls; !unknown && iter; iter = g_list_next(iter))
+        {
+            struct abrt_xmlrpc_queued_call *call = iter->data;
+            call->completion(call->method, &env, NULL, call->user_data);
+        }
+
+        xmlrpc_env_clean(&env);
+        return !unknown;
+    }
+
+    const unsigned count = g_list_length(calls);
+    if (xmlrpc_value_type(response) != XMLRPC_TYPE_ARRAY
+        || (unsigned)xmlrpc_array_size(&env, response) != count)
+    {
+        /* The calls might have been performed, it's not safe to repeat them */
+        error_msg_and_die("Invalid system.multicall response");
+    }
+
+    unsigned i = 0;
+    for (GList *iter = calls; iter; iter = g_list_next(iter), ++i)
+    {
+        xmlrpc_value *item = NULL;
+        xmlrpc_array_read_item(&env, response, i, &item);
+        if (env.fault_occurred)
+            abrt_xmlrpc_die(&env);
+
+        abrt_xmlrpc_complete_multicall_item(iter->data, item);
+        xmlrpc_DECREF(item);
+    }
+
+    xmlrpc_DECREF(response);
+    xmlrpc_env_clean(&env);
+    return true;
+}
+
+void abrt_xmlrpc_flush_calls(struct abrt_xmlrpc *ax)
+{
+    /* Taking the list first makes calls from the completion functions safe */
+    GList *calls = ax->ax_queued_calls;
+    ax->ax_queued_calls = NULL;
+
+    if (calls == NULL)
+        return;
+
+    bool done = false;
+    if (calls->next != NULL && !ax->ax_no_multicall)
+    {
+        done = abrt_xmlrpc_multicall(ax, calls);
+        if (!done)
+        {
+            log_notice("Server does not support system.multicall, sending calls one by one");
+            ax->ax_no_multicall = 1;
+        }
+    }
+
+    for (GList *iter = calls; !done && iter; iter = g_list_next(iter))
+    {
+        struct abrt_xmlrpc_queued_call *call = iter->data;
+
+        xmlrpc_env env;
+        xmlrpc_env_init(&env);
+
+        xmlrpc_value *result = NULL;
+        abrt_xmlrpc_perform(&env, ax, call->method, call->params, &result);
+
+        call->completion(call->method, &env, result, call->user_data);
+
+        if (result)
+            xmlrpc_DECREF(result);
+        xmlrpc_env_clean(&env);
+    }
+
+    g_list_free_full(calls, (GDestroyNotify)abrt_xmlrpc_queued_call_free);
+}
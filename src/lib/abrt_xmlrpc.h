@@ -37,6 +37,16 @@ struct abrt_xmlrpc {
     xmlrpc_client *ax_client;
     xmlrpc_server_info *ax_server_info;
     GList *ax_session_params;
+    /* For requests sent without xmlrpc-c's transport */
+    char *ax_url;
+    int ax_ssl_verify;
+    /* POST_ENCODING_*, compressed requests are sent without xmlrpc-c's
+     * transport; asynchronous calls are never compressed */
+    int ax_content_encoding;
+    /* Calls waiting for abrt_xmlrpc_flush_calls() */
+    GList *ax_queued_calls;
+    /* The server refused system.multicall */
+    int ax_no_multicall;
 };
 
 xmlrpc_value *abrt_xmlrpc_array_new(xmlrpc_env *env);
@@ -63,6 +73,55 @@ xmlrpc_value *abrt_xmlrpc_call_params(xmlrpc_env *env, struct abrt_xmlrpc *ax,
 xmlrpc_value *abrt_xmlrpc_call_full(xmlrpc_env *enf, struct abrt_xmlrpc *ax,
                                    const char *method, const char *format, ...);
 
+/* Calls the method with the struct params which gets one more member of the
+ * base64 type whose value is the contents of the file. The file is encoded
+ * while the request is being sent, hence it is never loaded to memory. The
+ * request is sent with the client's transport settings, like all compressed
+ * requests.
+ *
+ * Unlike abrt_xmlrpc_call_params(), returns NULL and sets env on faults.
+ */
+xmlrpc_value *abrt_xmlrpc_call_params_fd(xmlrpc_env *env, struct abrt_xmlrpc *ax,
+                               const char *method, xmlrpc_value *params,
+                               const char *fd_name, int fd);
+
+/* Asynchronous calls
+ *
+ * abrt_xmlrpc_start_call() only sends the request. The calls started on one
+ * client are performed concurrently (each in its own connection) while
+ * abrt_xmlrpc_finish_calls() runs, which returns after all of them finished.
+ *
+ * The completion function gets either fault with fault_occurred set or the
+ * result which is destroyed after the completion function returns.
+ */
+typedef void (*abrt_xmlrpc_completion_fn)(const char *method, const xmlrpc_env *fault,
+                                          xmlrpc_value *result, void *user_data);
+
+void abrt_xmlrpc_start_call(struct abrt_xmlrpc *ax, const char *method,
+                            abrt_xmlrpc_completion_fn completion, void *user_data,
+                            const char *format, ...);
+
+void abrt_xmlrpc_finish_calls(struct abrt_xmlrpc *ax);
+
+/* Batched calls
+ *
+ * abrt_xmlrpc_queue_call() only remembers the call. abrt_xmlrpc_flush_calls()
+ * sends all queued calls in a single system.multicall request and calls the
+ * completion functions in the order the calls were queued. If the server does
+ * not know system.multicall, the calls are sent one by one. If the request
+ * fails otherwise, all completion functions get the fault and the calls are
+ * not repeated.
+ *
+ * The queued calls are flushed before any other call on the client and by
+ * abrt_xmlrpc_free_client(), so they are always performed in the order they
+ * were made.
+ */
+void abrt_xmlrpc_queue_call(struct abrt_xmlrpc *ax, const char *method,
+                            abrt_xmlrpc_completion_fn completion, void *user_data,
+                            const char *format, ...);
+
+void abrt_xmlrpc_flush_calls(struct abrt_xmlrpc *ax);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,560 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include <sys/inotify.h>
+
+#include "internal_libreport.h"
+#include "config_watcher.h"
+
+#define WATCH_MASK (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ONLYDIR)
+/* Waiting for a missing directory, added to the mask of the watched ones */
+#define ANCESTOR_MASK (IN_CREATE | IN_MOVED_TO | IN_ONLYDIR | IN_MASK_ADD)
+
+struct watched_dir
+{
+    config_watch_kind_t kind;
+    char *path;
+    /* Only the default directories hold the loaded configuration */
+    bool reload;
+    /* The directory contains configuration files */
+    bool config;
+    /* A missing directory might be created in the directory */
+    bool ancestor;
+};
+
+struct config_change
+{
+    config_watch_kind_t kind;
+    char *name;
+    bool reload;
+};
+
+struct config_watcher
+{
+    int fd;
+    GHashTable *dirs; /* wd -> struct watched_dir */
+    GList *missing; /* struct watched_dir, watched once they are created */
+    config_watcher_callback callback;
+    void *data;
+    GIOChannel *channel;
+    guint source_id;
+};
+
+static void free_watched_dir(struct watched_dir *dir)
+{
+    if (dir)
+    {
+        free(dir->path);
+        free(dir);
+    }
+}
+
+static struct watched_dir *new_watched_dir(config_watch_kind_t kind, const char *path, bool reload)
+{
+    struct watched_dir *dir = xzalloc(sizeof(*dir));
+    dir->kind = kind;
+    dir->path = xstrdup(path);
+    dir->reload = reload;
+    return dir;
+}
+
+/* Returns the entry of the watch descriptor, creates it if needed */
+static struct watched_dir *get_watched_dir(config_watcher_t *watcher, int wd,
+                                           config_watch_kind_t kind, const char *path)
+{
+    struct watched_dir *dir = g_hash_table_lookup(watcher->dirs, GINT_TO_POINTER(wd));
+    if (!dir)
+    {
+        dir = new_watched_dir(kind, path, false);
+        g_hash_table_insert(watcher->dirs, GINT_TO_POINTER(wd), dir);
+    }
+
+    return dir;
+}
+
+/* Watches the closest existing ancestor of the missing directory, so the
+ * directory is watched once it is created */
+static void watch_ancestor(config_watcher_t *watcher, const char *path)
+{
+    char *ancestor = xstrdup(path);
+    int wd = -1;
+
+    char *slash;
+    while (wd < 0 && (slash = strrchr(ancestor, '/')) != NULL)
+    {
+        if (slash == ancestor)
+            slash[1] = '\0';
+        else
+            slash[0] = '\0';
+
+        wd = inotify_add_watch(watcher->fd, ancestor, ANCESTOR_MASK);
+        if (wd < 0 && (errno != ENOENT || slash == ancestor))
+            break;
+    }
+
+    if (wd < 0)
+        log_info("Can't watch any parent directory of '%s'", path);
+    else
+    {
+        struct watched_dir *dir = get_watched_dir(watcher, wd, CONFIG_WATCH_GLOBAL, ancestor);
+        dir->ancestor = true;
+        log_debug("Waiting for '%s' in '%s'", path, ancestor);
+    }
+
+    free(ancestor);
+}
+
+static GList *add_change(GList *changes, config_watch_kind_t kind, char *name, bool reload);
+static char *file_to_change(const struct watched_dir *dir, const char *file,
+                            config_watch_kind_t *kind);
+
+/* Adds the changes of all configuration files in the directory */
+static GList *scan_dir(const struct watched_dir *dir, GList *changes)
+{
+    DIR *dp = opendir(dir->path);
+    if (!dp)
+        return changes;
+
+    struct dirent *dent;
+    while ((dent = readdir(dp)) != NULL)
+    {
+        config_watch_kind_t kind;
+        char *name = file_to_change(dir, dent->d_name, &kind);
+        if (name)
+            changes = add_change(changes, kind, name, dir->reload);
+    }
+    closedir(dp);
+
+    return changes;
+}
+
+static int watch_dir(config_watcher_t *watcher, struct watched_dir *missing)
+{
+    int wd = inotify_add_watch(watcher->fd, missing->path, WATCH_MASK);
+    if (wd < 0)
+        return -errno;
+
+    struct watched_dir *dir = get_watched_dir(watcher, wd, missing->kind, missing->path);
+    /* The same directory added twice, the reloading one wins */
+    dir->reload |= missing->reload;
+    if (!dir->config)
+    {
+        dir->config = true;
+        dir->kind = missing->kind;
+    }
+
+    log_debug("Watching '%s'", missing->path);
+    return wd;
+}
+
+static int add_dir(config_watcher_t *watcher, config_watch_kind_t kind,
+                   const char *path, bool reload)
+{
+    struct watched_dir *missing = new_watched_dir(kind, path, reload);
+    int wd = watch_dir(watcher, missing);
+    if (wd >= 0)
+    {
+        free_watched_dir(missing);
+        return 0;
+    }
+
+    if (wd != -ENOENT)
+    {
+        perror_msg("Can't watch '%s'", path);
+        free_watched_dir(missing);
+        return wd;
+    }
+
+    log_info("Not watching '%s' until it is created", path);
+    watcher->missing = g_list_append(watcher->missing, missing);
+    watch_ancestor(watcher, path);
+    return wd;
+}
+
+/* Watches the missing directories which have been created since, their files
+ * are reported as changed */
+static GList *watch_created_dirs(config_watcher_t *watcher, GList *changes)
+{
+    GList *iter = watcher->missing;
+    while (iter)
+    {
+        GList *next = g_list_next(iter);
+        struct watched_dir *missing = iter->data;
+
+        const int wd = watch_dir(watcher, missing);
+        if (wd >= 0)
+        {
+            changes = scan_dir(missing, changes);
+            watcher->missing = g_list_delete_link(watcher->missing, iter);
+            free_watched_dir(missing);
+        }
+        else
+            /* Some of the ancestors might have been created or removed */
+            watch_ancestor(watcher, missing->path);
+
+        iter = next;
+    }
+
+    return changes;
+}
+
+/* Reports all configuration as changed, used when notifications were lost */
+static GList *rescan(config_watcher_t *watcher, GList *changes)
+{
+    GHashTableIter iter;
+    gpointer wd, value;
+    g_hash_table_iter_init(&iter, watcher->dirs);
+    while (g_hash_table_iter_next(&iter, &wd, &value))
+    {
+        const struct watched_dir *dir = value;
+        if (dir->config)
+            changes = scan_dir(dir, changes);
+    }
+
+    /* The loaded items might have been removed */
+    GHashTableIter loaded;
+    gpointer name;
+    if (g_event_config_list)
+    {
+        g_hash_table_iter_init(&loaded, g_event_config_list);
+        while (g_hash_table_iter_next(&loaded, &name, NULL))
+            changes = add_change(changes, CONFIG_WATCH_EVENT, xstrdup(name), true);
+    }
+    if (g_workflow_list)
+    {
+        g_hash_table_iter_init(&loaded, g_workflow_list);
+        while (g_hash_table_iter_next(&loaded, &name, NULL))
+            changes = add_change(changes, CONFIG_WATCH_WORKFLOW, xstrdup(name), true);
+    }
+
+    return watch_created_dirs(watcher, changes);
+}
+
+config_watcher_t *config_watcher_new(config_watcher_callback callback, void *data)
+{
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        perror_msg("inotify_init1");
+        return NULL;
+    }
+
+    config_watcher_t *watcher = xzalloc(sizeof(*watcher));
+    watcher->fd = fd;
+    watcher->dirs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                          NULL, (GDestroyNotify)free_watched_dir);
+    watcher->callback = callback;
+    watcher->data = data;
+
+    add_dir(watcher, CONFIG_WATCH_EVENT, EVENTS_DIR, true);
+    add_dir(watcher, CONFIG_WATCH_EVENT, EVENTS_CONF_DIR, true);
+    char *user_events_dir = concat_path_file(g_get_user_cache_dir(), "abrt/events");
+    add_dir(watcher, CONFIG_WATCH_EVENT, user_events_dir, true);
+    free(user_events_dir);
+
+    add_dir(watcher, CONFIG_WATCH_WORKFLOW, WORKFLOWS_DIR, true);
+
+    /* libreport.conf and report_event.conf, see file_to_change() */
+    add_dir(watcher, CONFIG_WATCH_GLOBAL, CONF_DIR, true);
+    add_dir(watcher, CONFIG_WATCH_GLOBAL, get_user_conf_base_dir(), true);
+
+    add_dir(watcher, CONFIG_WATCH_EVENT_RULES, CONF_DIR"/events.d", true);
+    add_dir(watcher, CONFIG_WATCH_EVENT_RULES, CONF_DIR"/workflows.d", true);
+
+    add_dir(watcher, CONFIG_WATCH_PLUGIN, PLUGINS_CONF_DIR, true);
+
+    return watcher;
+}
+
+int config_watcher_add_dir(config_watcher_t *watcher, config_watch_kind_t kind, const char *dir)
+{
+    return add_dir(watcher, kind, dir, false);
+}
+
+int config_watcher_get_fd(config_watcher_t *watcher)
+{
+    return watcher->fd;
+}
+
+/* Returns the malloced name of the changed item or NULL if the file is not
+ * a configuration file of the directory's kind */
+static char *file_to_change(const struct watched_dir *dir, const char *file,
+                            config_watch_kind_t *kind)
+{
+    /* Editors' backups, swap files and temporary files */
+    if (file[0] == '.' || file[0] == '\0')
+        return NULL;
+
+    *kind = dir->kind;
+    switch (dir->kind)
+    {
+        case CONFIG_WATCH_GLOBAL:
+            if (strcmp(file, "libreport.conf") == 0)
+                return xstrdup(file);
+            if (strcmp(file, "report_event.conf") == 0)
+            {
+                *kind = CONFIG_WATCH_EVENT_RULES;
+                return xstrdup(file);
+            }
+            return NULL;
+
+        case CONFIG_WATCH_EVENT:
+        {
+            const char *suffix = strrchr(file, '.');
+            if (!suffix || suffix == file
+             || (strcmp(suffix, ".xml") != 0 && strcmp(suffix, ".conf") != 0))
+                return NULL;
+            return xstrndup(file, suffix - file);
+        }
+
+        case CONFIG_WATCH_WORKFLOW:
+        {
+            const char *suffix = strrchr(file, '.');
+            if (!suffix || suffix == file || strcmp(suffix, ".xml") != 0)
+                return NULL;
+            return xstrndup(file, suffix - file);
+        }
+
+        case CONFIG_WATCH_EVENT_RULES:
+        case CONFIG_WATCH_PLUGIN:
+        {
+            const char *suffix = strrchr(file, '.');
+            if (!suffix || suffix == file || strcmp(suffix, ".conf") != 0)
+                return NULL;
+            return xstrdup(file);
+        }
+    }
+
+    return NULL;
+}
+
+static void free_config_change(struct config_change *change)
+{
+    if (change)
+    {
+        free(change->name);
+        free(change);
+    }
+}
+
+static GList *add_change(GList *changes, config_watch_kind_t kind, char *name, bool reload)
+{
+    for (GList *iter = changes; iter; iter = g_list_next(iter))
+    {
+        struct config_change *change = iter->data;
+        if (change->kind == kind && strcmp(change->name, name) == 0)
+        {
+            change->reload |= reload;
+            free(name);
+            return changes;
+        }
+    }
+
+    struct config_change *change = xzalloc(sizeof(*change));
+    change->kind = kind;
+    change->name = name;
+    change->reload = reload;
+    return g_list_append(changes, change);
+}
+
+static bool workflow_has_event(workflow_t *workflow, const char *name)
+{
+    for (GList *iter = wf_get_event_list(workflow); iter; iter = g_list_next(iter))
+        if (strcmp(ec_get_name(iter->data), name) == 0)
+            return true;
+
+    return false;
+}
+
+static void reload_event(const char *name)
+{
+    /* Workflows hold their own copies of their events */
+    GList *workflows = NULL;
+    if (g_workflow_list)
+    {
+        GHashTableIter iter;
+        gpointer wf_name, workflow;
+        g_hash_table_iter_init(&iter, g_workflow_list);
+        while (g_hash_table_iter_next(&iter, &wf_name, &workflow))
+            if (workflow_has_event(workflow, name))
+                workflows = g_list_prepend(workflows, xstrdup(wf_name));
+    }
+
+    if (reload_event_config(name))
+        log_info("Reloaded event '%s'", name);
+
+    for (GList *iter = workflows; iter; iter = g_list_next(iter))
+        reload_workflow(iter->data);
+    g_list_free_full(workflows, free);
+}
+
+static void apply_change(const struct config_change *change)
+{
+    if (!change->reload)
+        return;
+
+    switch (change->kind)
+    {
+        case CONFIG_WATCH_EVENT:
+            reload_event(change->name);
+            break;
+        case CONFIG_WATCH_WORKFLOW:
+            if (reload_workflow(change->name))
+                log_info("Reloaded workflow '%s'", change->name);
+            break;
+        case CONFIG_WATCH_GLOBAL:
+            reload_global_configuration();
+            break;
+        case CONFIG_WATCH_EVENT_RULES:
+        case CONFIG_WATCH_PLUGIN:
+            /* Read whenever they are used */
+            break;
+    }
+}
+
+int config_watcher_process(config_watcher_t *watcher)
+{
+    /* The buffer must be aligned for struct inotify_event */
+    char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    GList *changes = NULL;
+    bool overflow = false;
+    bool created = false;
+
+    while (1)
+    {
+        ssize_t len = read(watcher->fd, buf, sizeof(buf));
+        if (len < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN)
+                break;
+            perror_msg("Can't read inotify events");
+            g_list_free_full(changes, (GDestroyNotify)free_config_change);
+            return -1;
+        }
+        if (len == 0)
+            break;
+
+        for (char *ptr = buf; ptr < buf + len; )
+        {
+            struct inotify_event *event = (struct inotify_event *)ptr;
+            ptr += sizeof(*event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                log_warning("Too many configuration changes, reloading everything");
+                overflow = true;
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED)
+            {
+                /* The directory itself was removed, wait for it again */
+                struct watched_dir *dir = g_hash_table_lookup(watcher->dirs, GINT_TO_POINTER(event->wd));
+                g_hash_table_steal(watcher->dirs, GINT_TO_POINTER(event->wd));
+                if (dir && dir->config)
+                    watcher->missing = g_list_append(watcher->missing, dir);
+                else
+                    free_watched_dir(dir);
+                created = true;
+                continue;
+            }
+
+            if (event->len == 0)
+                continue;
+
+            const struct watched_dir *dir = g_hash_table_lookup(watcher->dirs, GINT_TO_POINTER(event->wd));
+            if (!dir)
+                continue;
+
+            if (dir->ancestor && (event->mask & IN_ISDIR))
+                created = true;
+
+            if (!dir->config)
+                continue;
+
+            config_watch_kind_t kind;
+            char *name = file_to_change(dir, event->name, &kind);
+            if (!name)
+                continue;
+
+            log_debug("'%s/%s' changed (0x%x)", dir->path, event->name, (unsigned)event->mask);
+            changes = add_change(changes, kind, name, dir->reload);
+        }
+    }
+
+    if (overflow)
+        changes = rescan(watcher, changes);
+    else if (created)
+        changes = watch_created_dirs(watcher, changes);
+
+    int cnt = 0;
+    for (GList *iter = changes; iter; iter = g_list_next(iter))
+    {
+        struct config_change *change = iter->data;
+        apply_change(change);
+        if (watcher->callback)
+            watcher->callback(change->kind, change->name, watcher->data);
+        ++cnt;
+    }
+    g_list_free_full(changes, (GDestroyNotify)free_config_change);
+
+    return cnt;
+}
+
+static gboolean handle_inotify_fd(GIOChannel *channel, GIOCondition condition, gpointer data)
+{
+    config_watcher_t *watcher = data;
+
+    if (config_watcher_process(watcher) < 0)
+    {
+        error_msg("Stopped watching configuration changes");
+        watcher->source_id = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void config_watcher_attach(config_watcher_t *watcher)
+{
+    if (watcher->source_id != 0)
+        return;
+
+    if (!watcher->channel)
+        watcher->channel = g_io_channel_unix_new(watcher->fd);
+
+    watcher->source_id = g_io_add_watch(watcher->channel, G_IO_IN, handle_inotify_fd, watcher);
+}
+
+void config_watcher_free(config_watcher_t *watcher)
+{
+    if (!watcher)
+        return;
+
+    if (watcher->source_id != 0)
+        g_source_remove(watcher->source_id);
+    if (watcher->channel)
+        g_io_channel_unref(watcher->channel);
+
+    g_hash_table_destroy(watcher->dirs);
+    g_list_free_full(watcher->missing, (GDestroyNotify)free_watched_dir);
+    close(watcher->fd);
+    free(watcher);
+}
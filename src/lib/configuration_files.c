@@ -153,7 +153,7 @@ static void internal_aug_error_msg(augeas *aug, const char *def_msg)
  * node.
  */
 static bool
-internal_aug_init(augeas **aug, const char *path)
+internal_aug_init(augeas **aug)
 {
     int aug_flag = AUG_NO_ERR_CLOSE /* without this flag aug_init() returns
                                      * NULL on errors and we cannot read the
@@ -183,17 +183,28 @@ internal_aug_init(augeas **aug, const char *path)
         internal_aug_error_msg(*aug, "Cannot configure augeas to use Libreport.lns");
         return false;
     }
+#endif
+
+    return true;
+}
 
+/* Loads the configuration file into the tree. Files loaded by the previous
+ * calls are dropped from the tree, unchanged files are not parsed again.
+ */
+static bool
+internal_aug_load_file(augeas *aug, const char *path)
+{
+#if NOAUTOLOAD
     /* parse only this configuration file */
-    if (aug_set(*aug, "/augeas/load/Libreport/incl[1]", path) < 0)
+    if (aug_set(aug, "/augeas/load/Libreport/incl[1]", path) < 0)
     {
-        internal_aug_error_msg(*aug, "Cannot configure augeas to read the configuration file");
+        internal_aug_error_msg(aug, "Cannot configure augeas to read the configuration file");
         return false;
     }
 
-    if (aug_load(*aug) < 0)
+    if (aug_load(aug) < 0)
     {
-        internal_aug_error_msg(*aug, "Cannot load the configuration file");
+        internal_aug_error_msg(aug, "Cannot load the configuration file");
         return false;
     }
 #endif
@@ -201,6 +212,50 @@ internal_aug_init(augeas **aug, const char *path)
     return true;
 }
 
+/* Compiling the lens takes most of the time of aug_init(), hence all files
+ * are read using one context for the whole life of the process.
+ */
+static GMutex shared_aug_lock;
+static augeas *shared_aug;
+
+static augeas *
+shared_aug_acquire(const char *path)
+{
+    g_mutex_lock(&shared_aug_lock);
+
+    if (shared_aug == NULL && !internal_aug_init(&shared_aug))
+    {
+        if (shared_aug != NULL)
+            aug_close(shared_aug);
+        shared_aug = NULL;
+        goto fail;
+    }
+
+    /* aug_load() skips files whose modification time (in seconds) has not
+     * changed, but the file could have been saved in the same second */
+    char *aug_path = xasprintf("/augeas/files%s", path);
+    aug_rm(shared_aug, aug_path);
+    free(aug_path);
+    aug_path = xasprintf("/files%s", path);
+    aug_rm(shared_aug, aug_path);
+    free(aug_path);
+
+    if (!internal_aug_load_file(shared_aug, path))
+        goto fail;
+
+    return shared_aug;
+
+fail:
+    g_mutex_unlock(&shared_aug_lock);
+    return NULL;
+}
+
+static void
+shared_aug_release(void)
+{
+    g_mutex_unlock(&shared_aug_lock);
+}
+
 enum {
     GAON_NO_FLAG = 0,   /* Explicit default value */
     GAON_FAIL_ON_NOENT, /* Fail if configuration file does not exist */
@@ -208,6 +263,8 @@ enum {
 
 #define IS_FAIL_ON_NOENT(f) ((f) & GAON_FAIL_ON_NOENT)
 
+static bool check_conf_file_without_options(const char *real_path, int flags);
+
 /* Finds names of all options from a file placed on the real_path and returns
  * the names in an array of strings.
  *
@@ -233,6 +290,12 @@ static bool internal_aug_get_all_option_names(augeas *aug, const char *real_path
         return true;
 
     /* match_num == 0 means 'no option found'; let's find out why */
+    return check_conf_file_without_options(real_path, flags);
+}
+
+/* Returns false if the configuration file without options is not OK */
+static bool check_conf_file_without_options(const char *real_path, int flags)
+{
     struct stat buf;
     if (0 != stat(real_path, &buf))
     {
@@ -258,22 +321,165 @@ static bool internal_aug_get_all_option_names(augeas *aug, const char *real_path
     return true;
 }
 
-/* Returns false if any error occurs, else returns true.
+static void add_conf_option(map_string_t *settings, const char *option,
+                            const char *value, bool skipKeysWithoutValue)
+{
+    log_info("Loaded option '%s' = '%s'", option, value);
+
+    if (!skipKeysWithoutValue || value[0] != '\0')
+        replace_map_string_item(settings, xstrdup(option), xstrdup(value));
+}
+
+static bool is_conf_blank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+static bool is_conf_alpha(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+/* Parses the subset of the Libreport lens (augeas/libreport.aug) which
+ * configuration files actually use:
+ *
+ *   # comment
+ *   Option = value
+ *   Option =
+ *
+ * Every line must end with a new line character, option names are at least
+ * two letters or underscores and values are stored without the surrounding
+ * blanks. Anything else, as well as repeated options, makes the function
+ * return false and the caller must use augeas, so the results never differ.
  */
-bool load_conf_file(const char *path, map_string_t *settings, bool skipKeysWithoutValue)
+static bool parse_conf_data(const char *data, size_t len, map_string_t *options)
 {
-    bool retval = false;
-    char real_path[PATH_MAX + 1];
-    augeas *aug = NULL;
+    if (memchr(data, '\0', len) != NULL)
+        return false;
 
-    if (!canonicalize_path(path, real_path))
+    const char *const end = data + len;
+    for (const char *line = data; line < end; )
     {
-        VERB3 perror_msg("Cannot get real path for '%s'", path);
-        goto finalize;
+        const char *const eol = memchr(line, '\n', end - line);
+        if (eol == NULL)
+            return false;
+
+        const char *p = line;
+        if (*p == '#')
+        {
+            /* The lens does not accept blanks at the end of comments */
+            while (++p < eol && is_conf_blank(*p))
+                ;
+            if (p != eol && is_conf_blank(eol[-1]))
+                return false;
+
+            line = eol + 1;
+            continue;
+        }
+
+        while (p < eol && is_conf_blank(*p))
+            ++p;
+
+        if (p == eol)
+        {
+            line = eol + 1;
+            continue;
+        }
+
+        const char *const name = p;
+        if (!is_conf_alpha(*p))
+            return false;
+        while (++p < eol && (is_conf_alpha(*p) || *p == '_'))
+            ;
+        const char *const name_end = p;
+        if (name_end - name < 2)
+            return false;
+
+        while (p < eol && is_conf_blank(*p))
+            ++p;
+        if (p == eol || *p != '=')
+            return false;
+        while (++p < eol && is_conf_blank(*p))
+            ;
+
+        const char *value_end = eol;
+        while (value_end > p && is_conf_blank(value_end[-1]))
+            --value_end;
+
+        char *option = xstrndup(name, name_end - name);
+        if (get_map_string_item_or_NULL(options, option) != NULL)
+        {
+            free(option);
+            return false;
+        }
+        insert_map_string(options, option, xstrndup(p, value_end - p));
+
+        line = eol + 1;
     }
 
-    if (!internal_aug_init(&aug, real_path))
-        goto finalize;
+    return true;
+}
+
+enum {
+    NATIVE_LOAD_OK,
+    NATIVE_LOAD_FAILED,
+    /* Use augeas */
+    NATIVE_LOAD_UNSUPPORTED,
+};
+
+#define NATIVE_LOAD_MAX_SIZE (1024 * 1024)
+
+static int load_conf_file_native(const char *real_path, map_string_t *settings, bool skipKeysWithoutValue)
+{
+    const int fd = open(real_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return check_conf_file_without_options(real_path, GAON_FAIL_ON_NOENT)
+               ? NATIVE_LOAD_OK : NATIVE_LOAD_FAILED;
+
+    struct stat buf;
+    if (fstat(fd, &buf) != 0 || !S_ISREG(buf.st_mode))
+    {
+        close(fd);
+        return check_conf_file_without_options(real_path, GAON_FAIL_ON_NOENT)
+               ? NATIVE_LOAD_OK : NATIVE_LOAD_FAILED;
+    }
+
+    size_t size = NATIVE_LOAD_MAX_SIZE;
+    char *data = xmalloc_read(fd, &size);
+    close(fd);
+    if (data == NULL || size == NATIVE_LOAD_MAX_SIZE)
+    {
+        free(data);
+        return NATIVE_LOAD_UNSUPPORTED;
+    }
+
+    map_string_t *options = new_map_string();
+    const bool parsed = parse_conf_data(data, size, options);
+    free(data);
+
+    if (parsed)
+    {
+        if (size_map_string(options) == 0)
+            log_info("Configuration file '%s' contains no option", real_path);
+
+        const char *option;
+        const char *value;
+        map_string_iter_t iter;
+        init_map_string_iter(&iter, options);
+        while (next_map_string_iter(&iter, &option, &value))
+            add_conf_option(settings, option, value, skipKeysWithoutValue);
+    }
+
+    free_map_string(options);
+    return parsed ? NATIVE_LOAD_OK : NATIVE_LOAD_UNSUPPORTED;
+}
+
+static bool load_conf_file_augeas(const char *real_path, map_string_t *settings, bool skipKeysWithoutValue)
+{
+    bool retval = false;
+    augeas *aug = shared_aug_acquire(real_path);
+    if (aug == NULL)
+        return false;
 
     char **matches = NULL;
     int match_num = 0;
@@ -297,10 +503,7 @@ bool load_conf_file(const char *path, map_string_t *settings, bool skipKeysWitho
             goto cleanup;
         }
 
-        log_info("Loaded option '%s' = '%s'", option, value);
-
-        if (!skipKeysWithoutValue || value[0] != '\0')
-            replace_map_string_item(settings, xstrdup(option), xstrdup(value));
+        add_conf_option(settings, option, value, skipKeysWithoutValue);
 
         free(matches[i]);
     }
@@ -312,12 +515,40 @@ cleanup:
     free(matches);
 
 finalize:
-    if (aug != NULL)
-        aug_close(aug);
+    shared_aug_release();
 
     return retval;
 }
 
+bool load_conf_file_ext(const char *path, map_string_t *settings, bool skipKeysWithoutValue, int flags)
+{
+    char real_path[PATH_MAX + 1];
+
+    if (!canonicalize_path(path, real_path))
+    {
+        VERB3 perror_msg("Cannot get real path for '%s'", path);
+        return false;
+    }
+
+    if (!(flags & CONF_FILE_FLAG_AUGEAS))
+    {
+        const int r = load_conf_file_native(real_path, settings, skipKeysWithoutValue);
+        if (r != NATIVE_LOAD_UNSUPPORTED)
+            return r == NATIVE_LOAD_OK;
+
+        log_debug("Parsing '%s' with augeas", real_path);
+    }
+
+    return load_conf_file_augeas(real_path, settings, skipKeysWithoutValue);
+}
+
+/* Returns false if any error occurs, else returns true.
+ */
+bool load_conf_file(const char *path, map_string_t *settings, bool skipKeysWithoutValue)
+{
+    return load_conf_file_ext(path, settings, skipKeysWithoutValue, CONF_FILE_FLAG_NONE);
+}
+
 const char *get_user_conf_base_dir(void)
 {
     static char *base_dir = NULL;
@@ -403,7 +634,8 @@ bool save_conf_file(const char *path, map_string_t *settings)
         goto finalize;
     }
 
-    if (!internal_aug_init(&aug, real_path))
+    /* Not the shared context, a failed save must not leave changes in it */
+    if (!internal_aug_init(&aug) || !internal_aug_load_file(aug, real_path))
         goto finalize;
 
     /* Get all option names to be able to delete those which have
@@ -20,6 +20,8 @@
 #include "client.h"
 #include "libreport_curl.h"
 #include "proxies.h"
+#include "http_cache.h"
+#include "http_encoding.h"
 
 /*
  * Utility functions
@@ -77,22 +79,153 @@ xcurl_easy_setopt_off_t(CURL *handle, CURLoption option, curl_off_t parameter)
     }
 }
 
-CURLcode curl_easy_perform_with_proxy(CURL *handle, const char *url)
+/*
+ * HTTP sessions
+ */
+struct http_session
+{
+    /* Kept between requests. curl_easy_reset() preserves live connections,
+     * the DNS cache and the TLS session IDs of the handle. */
+    CURL *handle;
+    /* "scheme://host" -> GList of proxy URLs (NULL means no proxy). The proxy
+     * which worked last time is the first item. */
+    GHashTable *proxies;
+};
+
+static GMutex s_curl_share_locks[CURL_LOCK_DATA_LAST];
+
+static void
+curl_share_lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *unused)
+{
+    g_mutex_lock(&s_curl_share_locks[data]);
+}
+
+static void
+curl_share_unlock(CURL *handle, curl_lock_data data, void *unused)
+{
+    g_mutex_unlock(&s_curl_share_locks[data]);
+}
+
+/* DNS results and TLS sessions are shared by all sessions in the process, so
+ * even a new thread does not have to do a full handshake.
+ */
+static CURLSH *
+get_curl_share(void)
+{
+    static gsize s_initialized = 0;
+    static CURLSH *s_share = NULL;
+
+    if (g_once_init_enter(&s_initialized))
+    {
+        s_share = curl_share_init();
+        if (s_share != NULL)
+        {
+            curl_share_setopt(s_share, CURLSHOPT_LOCKFUNC, curl_share_lock);
+            curl_share_setopt(s_share, CURLSHOPT_UNLOCKFUNC, curl_share_unlock);
+            curl_share_setopt(s_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(s_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        }
+        else
+            log_notice("Can't create curl share, DNS and TLS sessions won't be shared");
+
+        g_once_init_leave(&s_initialized, 1);
+    }
+
+    return s_share;
+}
+
+http_session_t *new_http_session(void)
+{
+    http_session_t *session = (http_session_t *)xzalloc(sizeof(*session));
+    session->handle = xcurl_easy_init();
+
+    CURLSH *share = get_curl_share();
+    if (share)
+        xcurl_easy_setopt_ptr(session->handle, CURLOPT_SHARE, share);
+    /* Resume TLS sessions of previous reporters, if enabled */
+    http_cache_import_tls_sessions(session->handle);
+
+    session->proxies = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                             free, (GDestroyNotify)list_free_with_free);
+    return session;
+}
+
+void free_http_session(http_session_t *session)
+{
+    if (!session)
+        return;
+
+    curl_easy_cleanup(session->handle);
+    g_hash_table_destroy(session->proxies);
+    free(session);
+}
+
+/* post() uses a session per thread unless the caller supplies one. The
+ * session of a thread is destroyed when the thread exits.
+ */
+static GPrivate s_thread_http_session = G_PRIVATE_INIT((GDestroyNotify)free_http_session);
+
+static http_session_t *
+get_thread_http_session(void)
+{
+    http_session_t *session = g_private_get(&s_thread_http_session);
+    if (session == NULL)
+    {
+        session = new_http_session();
+        g_private_set(&s_thread_http_session, session);
+    }
+
+    return session;
+}
+
+static GList *
+get_session_proxy_list(http_session_t *session, const char *url)
+{
+    /* Proxy settings can differ only per scheme and host */
+    char *key = http_cache_host_key(url);
+
+    gpointer proxy_list = NULL;
+    if (g_hash_table_lookup_extended(session->proxies, key, NULL, &proxy_list))
+        free(key);
+    else
+    {
+        proxy_list = get_proxy_list(url);
+        /* Takes ownership of key and the list */
+        g_hash_table_insert(session->proxies, key, proxy_list);
+    }
+
+    return (GList *)proxy_list;
+}
+
+static CURLcode
+perform_with_proxy(CURL *handle, const char *url, http_session_t *session)
 {
-    GList *proxy_list, *li;
+    GList *proxy_list;
     CURLcode curl_err;
 
-    proxy_list = get_proxy_list(url);
+    proxy_list = session ? get_session_proxy_list(session, url) : get_proxy_list(url);
 
     if (proxy_list)
     {
         /* Try with each proxy before giving up. */
         /* TODO: Should we repeat the perform call only on certain errors? */
-        for (li = proxy_list, curl_err = 1; curl_err && li; li = g_list_next(li))
+        curl_err = 1;
+        for (GList *li = proxy_list; li; li = g_list_next(li))
         {
             xcurl_easy_setopt_ptr(handle, CURLOPT_PROXY, li->data);
             log_notice("Connecting to %s (using proxy server %s)", url, (const char *)li->data);
             curl_err = curl_easy_perform(handle);
+            if (curl_err == CURLE_OK)
+            {
+                /* Remember the working proxy for the next request */
+                if (li != proxy_list)
+                {
+                    gpointer first = proxy_list->data;
+                    proxy_list->data = li->data;
+                    li->data = first;
+                }
+                break;
+            }
         }
     }
     else
@@ -101,11 +234,18 @@ CURLcode curl_easy_perform_with_proxy(CURL *handle, const char *url)
         curl_err = curl_easy_perform(handle);
     }
 
-    list_free_with_free(proxy_list);
+    /* Session's proxy lists are owned by the session */
+    if (!session)
+        list_free_with_free(proxy_list);
 
     return curl_err;
 }
 
+CURLcode curl_easy_perform_with_proxy(CURL *handle, const char *url)
+{
+    return perform_with_proxy(handle, url, /*no session*/NULL);
+}
+
 /*
  * post_state utility functions
  */
@@ -142,7 +282,8 @@ char *find_header_in_post_state(post_state_t *state, const char *str)
         unsigned len = strlen(str);
         while (*headers)
         {
-            if (strncmp(*headers, str, len) == 0)
+            /* Field names are case-insensitive, HTTP/2 uses lower case */
+            if (strncasecmp(*headers, str, len) == 0)
                 return skip_whitespace(*headers + len);
             headers++;
         }
@@ -233,6 +374,360 @@ static size_t fread_with_reporting(void *ptr, size_t size, size_t nmemb, void *u
     return fread(ptr, size, nmemb, fp);
 }
 
+/* "seek in the file" callback, used to resume uploads */
+static int fseek_for_curl(void *userdata, curl_off_t offset, int origin)
+{
+    FILE *fp = (FILE*)userdata;
+
+    if (fseeko(fp, offset, origin) != 0)
+        return CURL_SEEKFUNC_CANTSEEK;
+
+    return CURL_SEEKFUNC_OK;
+}
+
+/*
+ * Streamed request body
+ */
+
+/* Must be a multiple of 3 to get a base64 encoding without padding between
+ * the chunks. */
+#define POST_BODY_CHUNK_SIZE (3 * 16 * 1024)
+
+struct post_body_segment
+{
+    /* Literal data or NULL */
+    char *data;
+    /* Number of literal bytes or the file size */
+    off_t size;
+    /* File to be base64 encoded, if data is NULL */
+    int fd;
+};
+
+struct post_body
+{
+    GList *segments;
+
+    /* Read position */
+    GList *cur_segment;
+    off_t cur_offset;
+    off_t sent;
+    /* Encoded but not yet sent data of a file */
+    char *encoded;
+    size_t encoded_len;
+    size_t encoded_pos;
+    gint b64_state;
+    gint b64_save;
+    char *chunk;
+
+    /* Compression of the whole body, if requested */
+    http_encoder_t *encoder;
+    GByteArray *compressed;
+    size_t compressed_pos;
+    bool compressed_end;
+
+    time_t last_report;
+    time_t report_interval;
+};
+
+post_body_t *new_post_body(void)
+{
+    return xzalloc(sizeof(post_body_t));
+}
+
+static void post_body_segment_free(struct post_body_segment *segment)
+{
+    free(segment->data);
+    free(segment);
+}
+
+void free_post_body(post_body_t *body)
+{
+    if (!body)
+        return;
+
+    g_list_free_full(body->segments, (GDestroyNotify)post_body_segment_free);
+    http_encoder_free(body->encoder);
+    if (body->compressed)
+        g_byte_array_free(body->compressed, TRUE);
+    free(body->encoded);
+    free(body->chunk);
+    free(body);
+}
+
+void post_body_append_mem(post_body_t *body, const char *data, size_t len)
+{
+    struct post_body_segment *segment = xzalloc(sizeof(*segment));
+    segment->data = xmalloc(len + 1);
+    memcpy(segment->data, data, len);
+    segment->data[len] = '\0';
+    segment->size = len;
+    segment->fd = -1;
+
+    body->segments = g_list_append(body->segments, segment);
+}
+
+void post_body_append_str(post_body_t *body, const char *str)
+{
+    post_body_append_mem(body, str, strlen(str));
+}
+
+int post_body_append_fd_base64(post_body_t *body, int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        return -errno;
+
+    if (!S_ISREG(st.st_mode))
+        return -EINVAL;
+
+    struct post_body_segment *segment = xzalloc(sizeof(*segment));
+    segment->size = st.st_size;
+    segment->fd = fd;
+
+    body->segments = g_list_append(body->segments, segment);
+
+    if (!body->chunk)
+    {
+        body->chunk = xmalloc(POST_BODY_CHUNK_SIZE);
+        /* g_base64_encode_step() needs at most (len / 3 + 1) * 4 + 4 bytes
+         * and g_base64_encode_close() adds at most 4 more */
+        body->encoded = xmalloc((POST_BODY_CHUNK_SIZE / 3 + 1) * 4 + 8);
+    }
+
+    return 0;
+}
+
+int post_body_append_fd_base64_at(post_body_t *body, const char *text, size_t len,
+                                  const char *placeholder, int fd)
+{
+    const size_t placeholder_len = strlen(placeholder);
+    const char *at = memmem(text, len, placeholder, placeholder_len);
+    if (at == NULL)
+        return -EINVAL;
+
+    const char *after = at + placeholder_len;
+    const size_t after_len = len - (after - text);
+    if (memmem(after, after_len, placeholder, placeholder_len) != NULL)
+        return -EINVAL;
+
+    post_body_append_mem(body, text, at - text);
+    const int r = post_body_append_fd_base64(body, fd);
+    post_body_append_mem(body, after, after_len);
+
+    return r;
+}
+
+static off_t post_body_segment_size(const struct post_body_segment *segment)
+{
+    if (segment->data)
+        return segment->size;
+
+    return (segment->size + 2) / 3 * 4;
+}
+
+off_t post_body_size(const post_body_t *body)
+{
+    off_t size = 0;
+    for (GList *iter = body->segments; iter; iter = g_list_next(iter))
+        size += post_body_segment_size(iter->data);
+
+    return size;
+}
+
+static void post_body_rewind(post_body_t *body)
+{
+    body->cur_segment = body->segments;
+    body->cur_offset = 0;
+    body->sent = 0;
+    body->encoded_len = body->encoded_pos = 0;
+    body->b64_state = body->b64_save = 0;
+
+    if (body->encoder)
+    {
+        http_encoder_reset(body->encoder);
+        g_byte_array_set_size(body->compressed, 0);
+        body->compressed_pos = 0;
+        body->compressed_end = false;
+    }
+}
+
+/* Compresses the body with the encoding (POST_ENCODING_*) while it is being
+ * sent */
+static void post_body_set_encoding(post_body_t *body, int encoding)
+{
+    http_encoder_free(body->encoder);
+    body->encoder = NULL;
+
+    if (encoding == POST_ENCODING_IDENTITY)
+        return;
+
+    body->encoder = http_encoder_new(encoding);
+    if (!body->compressed)
+        body->compressed = g_byte_array_new();
+}
+
+static void post_body_next_segment(post_body_t *body)
+{
+    body->cur_segment = g_list_next(body->cur_segment);
+    body->cur_offset = 0;
+}
+
+/* Encodes the next chunk of the current file. Returns false on read errors. */
+static bool post_body_encode_chunk(post_body_t *body, struct post_body_segment *segment)
+{
+    body->encoded_len = body->encoded_pos = 0;
+
+    const off_t left = segment->size - body->cur_offset;
+    if (left > 0)
+    {
+        const size_t want = MIN(left, POST_BODY_CHUNK_SIZE);
+        ssize_t r;
+        do
+            r = pread(segment->fd, body->chunk, want, body->cur_offset);
+        while (r < 0 && errno == EINTR);
+
+        if (r <= 0)
+        {
+            /* The file was truncated or can't be read */
+            if (r < 0)
+                perror_msg("Can't read the file to upload");
+            else
+                error_msg("The file to upload has been truncated");
+            return false;
+        }
+
+        body->cur_offset += r;
+        body->encoded_len = g_base64_encode_step((const guchar *)body->chunk, r,
+                /*break_lines*/FALSE, body->encoded, &body->b64_state, &body->b64_save);
+    }
+
+    if (body->cur_offset == segment->size)
+    {
+        body->encoded_len += g_base64_encode_close(/*break_lines*/FALSE,
+                body->encoded + body->encoded_len, &body->b64_state, &body->b64_save);
+        body->b64_state = body->b64_save = 0;
+        post_body_next_segment(body);
+    }
+
+    return true;
+}
+
+static void post_body_report_progress(post_body_t *body)
+{
+    time_t t = time(NULL);
+
+    if (body->sent == 0) /* first call */
+    {
+        body->last_report = t;
+        body->report_interval = 15;
+    }
+
+    /* Report the progress after 15 seconds, then after 30 seconds, then after
+     * 60 seconds and so on (like fread_with_reporting()).
+     */
+    if ((t - body->last_report) >= body->report_interval)
+    {
+        body->last_report = t;
+        body->report_interval *= 2;
+        log_warning(_("Uploaded: %llu of %llu kbytes"),
+                (unsigned long long)body->sent / 1024,
+                (unsigned long long)post_body_size(body) / 1024);
+    }
+}
+
+/* "read the request body" callback */
+static size_t post_body_read(char *buffer, size_t size, size_t nitems, void *userdata)
+{
+    post_body_t *body = userdata;
+    const size_t max = size * nitems;
+    size_t written = 0;
+
+    post_body_report_progress(body);
+
+    while (written < max)
+    {
+        if (body->encoded_pos < body->encoded_len)
+        {
+            const size_t len = MIN(max - written, body->encoded_len - body->encoded_pos);
+            memcpy(buffer + written, body->encoded + body->encoded_pos, len);
+            body->encoded_pos += len;
+            written += len;
+            continue;
+        }
+
+        if (!body->cur_segment)
+            break;
+
+        struct post_body_segment *segment = body->cur_segment->data;
+        if (segment->data)
+        {
+            const size_t len = MIN(max - written, segment->size - body->cur_offset);
+            memcpy(buffer + written, segment->data + body->cur_offset, len);
+            body->cur_offset += len;
+            written += len;
+
+            if (body->cur_offset == segment->size)
+                post_body_next_segment(body);
+        }
+        else if (!post_body_encode_chunk(body, segment))
+            return CURL_READFUNC_ABORT;
+    }
+
+    body->sent += written;
+    return written;
+}
+
+/* "read the compressed request body" callback */
+static size_t post_body_read_compressed(char *buffer, size_t size, size_t nitems, void *userdata)
+{
+    post_body_t *body = userdata;
+    const size_t max = size * nitems;
+    size_t written = 0;
+
+    while (written < max)
+    {
+        GByteArray *compressed = body->compressed;
+        if (body->compressed_pos < compressed->len)
+        {
+            const size_t len = MIN(max - written, compressed->len - body->compressed_pos);
+            memcpy(buffer + written, compressed->data + body->compressed_pos, len);
+            body->compressed_pos += len;
+            written += len;
+            continue;
+        }
+
+        if (body->compressed_end)
+            break;
+
+        g_byte_array_set_size(compressed, 0);
+        body->compressed_pos = 0;
+
+        char raw[POST_BODY_CHUNK_SIZE];
+        const size_t raw_len = post_body_read(raw, 1, sizeof(raw), body);
+        if (raw_len == CURL_READFUNC_ABORT)
+            return CURL_READFUNC_ABORT;
+
+        body->compressed_end = (raw_len == 0);
+        if (!http_encoder_process(body->encoder, raw, raw_len, body->compressed_end, compressed))
+        {
+            error_msg("Can't compress the request");
+            return CURL_READFUNC_ABORT;
+        }
+    }
+
+    return written;
+}
+
+/* curl needs to send the body again, e.g. for authentication */
+static int post_body_seek(void *userdata, curl_off_t offset, int origin)
+{
+    if (offset != 0 || origin != SEEK_SET)
+        return CURL_SEEKFUNC_CANTSEEK;
+
+    post_body_rewind((post_body_t *)userdata);
+    return CURL_SEEKFUNC_OK;
+}
+
 static int curl_debug(CURL *handle, curl_infotype it, char *buf, size_t bufsize, void *unused)
 {
     if (logmode == 0)
@@ -294,13 +789,15 @@ static int curl_debug(CURL *handle, curl_infotype it, char *buf, size_t bufsize,
     return 0;
 }
 
-int
-post(post_state_t *state,
+/* body != NULL means post_stream(), data and data_size are not used then */
+static int
+post_ext(post_state_t *state,
                 const char *url,
                 const char *content_type,
                 const char **additional_headers,
                 const char *data,
-                off_t data_size)
+                off_t data_size,
+                post_body_t *body)
 {
     INITIALIZE_LIBREPORT();
 
@@ -308,7 +805,7 @@ post(post_state_t *state,
     long response_code;
     post_state_t localstate;
 
-    log_debug("%s('%s','%s')", __func__, url, data);
+    log_debug("%s('%s','%s')", __func__, url, body ? "<stream>" : data);
 
     if (!state)
     {
@@ -318,11 +815,13 @@ post(post_state_t *state,
 
     state->curl_result = state->http_resp_code = response_code = -1;
 
-    CURL *handle = xcurl_easy_init();
+    // Consecutive requests re-use the session's connections
+    http_session_t *session = state->session ? state->session : get_thread_http_session();
+    CURL *handle = session->handle;
 
     // Buffer[CURL_ERROR_SIZE] curl stores human readable error messages in.
     // This may be more helpful than just return code from curl_easy_perform.
-    // curl will need it until curl_easy_cleanup.
+    // curl will need it until curl_easy_reset.
     state->errmsg[0] = '\0';
     xcurl_easy_setopt_ptr(handle, CURLOPT_ERRORBUFFER, state->errmsg);
     // Shut off the built-in progress meter completely
@@ -357,7 +856,9 @@ post(post_state_t *state,
     if (state->client_ssh_private_keyfile)
         xcurl_easy_setopt_ptr(handle, CURLOPT_SSH_PRIVATE_KEYFILE, state->client_ssh_private_keyfile);
 
-    if (data_size != POST_DATA_FROMFILE_PUT && data_size != POST_DATA_GET)
+    if (data_size == POST_DATA_HEAD)
+        xcurl_easy_setopt_long(handle, CURLOPT_NOBODY, 1);
+    else if (data_size != POST_DATA_FROMFILE_PUT && data_size != POST_DATA_GET)
     {
         // Do a HTTP POST. This also makes curl use
         // a "Content-Type: application/x-www-form-urlencoded" header.
@@ -371,9 +872,41 @@ post(post_state_t *state,
     FILE *data_file = NULL;
     FILE *body_stream = NULL;
     struct curl_slist *httpheader_list = NULL;
+    GByteArray *encoded_data = NULL;
+    char *form_content_type = NULL;
+
+    // Files are sent as they are, everything else can be compressed
+    const char *encoding = NULL;
+    if (data_size != POST_DATA_FROMFILE
+        && data_size != POST_DATA_FROMFILE_PUT
+        && data_size != POST_DATA_FROMFILE_AS_FORM_DATA
+        && data_size != POST_DATA_GET
+        && data_size != POST_DATA_HEAD)
+        encoding = http_encoding_name(state->content_encoding);
 
     // Supply data...
-    if (data_size == POST_DATA_FROMFILE
+    if (body)
+    {
+        // ...from the body, files are encoded while being sent
+        post_body_set_encoding(body, encoding ? state->content_encoding : POST_ENCODING_IDENTITY);
+        post_body_rewind(body);
+        xcurl_easy_setopt_ptr(handle, CURLOPT_READDATA, body);
+        xcurl_easy_setopt_ptr(handle, CURLOPT_SEEKFUNCTION, (const void*)post_body_seek);
+        xcurl_easy_setopt_ptr(handle, CURLOPT_SEEKDATA, body);
+        if (encoding)
+        {
+            xcurl_easy_setopt_ptr(handle, CURLOPT_READFUNCTION, (const void*)post_body_read_compressed);
+            // The compressed size is not known in advance, use chunked encoding
+            xcurl_easy_setopt_off_t(handle, CURLOPT_POSTFIELDSIZE_LARGE, -1);
+        }
+        else
+        {
+            xcurl_easy_setopt_ptr(handle, CURLOPT_READFUNCTION, (const void*)post_body_read);
+            // The size is known in advance, no need for chunked encoding
+            xcurl_easy_setopt_off_t(handle, CURLOPT_POSTFIELDSIZE_LARGE, post_body_size(body));
+        }
+    }
+    else if (data_size == POST_DATA_FROMFILE
      || data_size == POST_DATA_FROMFILE_PUT
     ) {
         // ...from a file
@@ -400,6 +933,15 @@ post(post_state_t *state,
         {
             xcurl_easy_setopt_long(handle, CURLOPT_UPLOAD, 1);
             xcurl_easy_setopt_off_t(handle, CURLOPT_INFILESIZE_LARGE, sz);
+            if (state->resume_from != 0)
+            {
+                // curl skips the beginning of the file (using the seek
+                // function) and sends "Content-Range" or appends to the
+                // remote file, depending on the protocol
+                xcurl_easy_setopt_off_t(handle, CURLOPT_RESUME_FROM_LARGE, state->resume_from);
+                xcurl_easy_setopt_ptr(handle, CURLOPT_SEEKFUNCTION, (const void*)fseek_for_curl);
+                xcurl_easy_setopt_ptr(handle, CURLOPT_SEEKDATA, data_file);
+            }
         }
     }
     else if (data_size == POST_DATA_FROMFILE_AS_FORM_DATA)
@@ -445,6 +987,33 @@ post(post_state_t *state,
             error_msg_and_die("out of memory or read error (curl_formadd error code: %d)", (int)curlform_err);
         xcurl_easy_setopt_ptr(handle, CURLOPT_HTTPPOST, post);
     }
+    else if (data_size == POST_DATA_STRING_AS_FORM_DATA && encoding)
+    {
+        // curl can't compress forms, build the same form curl_formadd
+        // would and compress it as a blob
+        char *boundary = xasprintf("------------------------%016llx",
+                        (unsigned long long)g_random_int() << 32 | g_random_int());
+        char *form = xasprintf("--%s\r\n"
+                        "Content-Disposition: form-data; name=\"file\"; filename=\"*buffer*\"\r\n"
+                        "Content-Type: %s\r\n"
+                        "\r\n"
+                        "%s\r\n"
+                        "--%s--\r\n",
+                        boundary, content_type, data, boundary);
+        form_content_type = xasprintf("multipart/form-data; boundary=%s", boundary);
+        free(boundary);
+
+        encoded_data = http_encode(state->content_encoding, form, strlen(form));
+        free(form);
+        if (!encoded_data)
+        {
+            error_msg("Can't compress the request");
+            goto ret; // return -1
+        }
+
+        xcurl_easy_setopt_ptr(handle, CURLOPT_POSTFIELDS, encoded_data->data);
+        xcurl_easy_setopt_off_t(handle, CURLOPT_POSTFIELDSIZE_LARGE, encoded_data->len);
+    }
     else if (data_size == POST_DATA_STRING_AS_FORM_DATA)
     {
         CURLFORMcode curlform_err = curl_formadd(&post, &last,
@@ -465,7 +1034,21 @@ post(post_state_t *state,
             error_msg_and_die("out of memory or read error (curl_formadd error code: %d)", (int)curlform_err);
         xcurl_easy_setopt_ptr(handle, CURLOPT_HTTPPOST, post);
     }
-    else if (data_size != POST_DATA_GET)
+    else if (data_size != POST_DATA_GET && data_size != POST_DATA_HEAD && encoding)
+    {
+        // ...from a blob in memory, compressed
+        encoded_data = http_encode(state->content_encoding, data,
+                        data_size == POST_DATA_STRING ? strlen(data) : data_size);
+        if (!encoded_data)
+        {
+            error_msg("Can't compress the request");
+            goto ret; // return -1
+        }
+
+        xcurl_easy_setopt_ptr(handle, CURLOPT_POSTFIELDS, encoded_data->data);
+        xcurl_easy_setopt_off_t(handle, CURLOPT_POSTFIELDSIZE_LARGE, encoded_data->len);
+    }
+    else if (data_size != POST_DATA_GET && data_size != POST_DATA_HEAD)
     {
         // ...from a blob in memory
         xcurl_easy_setopt_ptr(handle, CURLOPT_POSTFIELDS, data);
@@ -477,10 +1060,12 @@ post(post_state_t *state,
     }
 
     // Override "Content-Type:"
-    if (data_size != POST_DATA_FROMFILE_AS_FORM_DATA
-        && data_size != POST_DATA_STRING_AS_FORM_DATA)
+    if (form_content_type
+        || (data_size != POST_DATA_FROMFILE_AS_FORM_DATA
+            && data_size != POST_DATA_STRING_AS_FORM_DATA))
     {
-        char *content_type_header = xasprintf("Content-Type: %s", content_type);
+        char *content_type_header = xasprintf("Content-Type: %s",
+                        form_content_type ? form_content_type : content_type);
         // Note: curl_slist_append() copies content_type_header
         httpheader_list = curl_slist_append(httpheader_list, content_type_header);
         if (!httpheader_list)
@@ -488,6 +1073,20 @@ post(post_state_t *state,
         free(content_type_header);
     }
 
+    if (encoding)
+    {
+        char *content_encoding_header = xasprintf("Content-Encoding: %s", encoding);
+        httpheader_list = curl_slist_append(httpheader_list, content_encoding_header);
+        if (!httpheader_list)
+            error_msg_and_die("out of memory");
+        free(content_encoding_header);
+    }
+
+    // A server which understands compressed requests most likely sends
+    // compressed responses too, "" = all encodings curl supports
+    if (state->content_encoding != POST_ENCODING_IDENTITY)
+        xcurl_easy_setopt_ptr(handle, CURLOPT_ACCEPT_ENCODING, "");
+
     for (; additional_headers && *additional_headers; additional_headers++)
     {
         httpheader_list = curl_slist_append(httpheader_list, *additional_headers);
@@ -495,10 +1094,14 @@ post(post_state_t *state,
             error_msg_and_die("out of memory");
     }
 
-    // Add User-Agent: ABRT/N.M
-    httpheader_list = curl_slist_append(httpheader_list, "User-Agent: ABRT/"VERSION);
+    // Add User-Agent: ABRT/N.M unless the caller has its own
+    char *user_agent_header = state->user_agent
+                              ? xasprintf("User-Agent: %s", state->user_agent)
+                              : xstrdup("User-Agent: ABRT/"VERSION);
+    httpheader_list = curl_slist_append(httpheader_list, user_agent_header);
     if (!httpheader_list)
         error_msg_and_die("out of memory");
+    free(user_agent_header);
 
     if (httpheader_list)
         xcurl_easy_setopt_ptr(handle, CURLOPT_HTTPHEADER, httpheader_list);
@@ -553,7 +1156,7 @@ post(post_state_t *state,
 
     // This is the place where everything happens.
     // Here errors are not limited to "out of memory", can't just die.
-    state->curl_result = curl_err = curl_easy_perform_with_proxy(handle, url);
+    state->curl_result = curl_err = perform_with_proxy(handle, url, session);
     if (curl_err)
     {
         log_info("curl_easy_perform: error %d", (int)curl_err);
@@ -574,10 +1177,16 @@ post(post_state_t *state,
     curl_err = curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
     die_if_curl_error(curl_err);
     state->http_resp_code = response_code;
+
+    // Let the next reporter resume the TLS session, if enabled
+    if (strncasecmp(url, "https:", strlen("https:")) == 0)
+        http_cache_export_tls_sessions(handle);
+
     log_debug("after curl_easy_perform: response_code:%ld body:'%s'", response_code, state->body);
 
  ret:
-    curl_easy_cleanup(handle);
+    // Drop all options (they point to our local data) but keep connections
+    curl_easy_reset(handle);
     if (httpheader_list)
         curl_slist_free_all(httpheader_list);
     if (body_stream)
@@ -586,10 +1195,213 @@ post(post_state_t *state,
         fclose(data_file);
     if (post)
         curl_formfree(post);
+    if (encoded_data)
+        g_byte_array_free(encoded_data, TRUE);
+    free(form_content_type);
 
     return response_code;
 }
 
+int
+post(post_state_t *state,
+                const char *url,
+                const char *content_type,
+                const char **additional_headers,
+                const char *data,
+                off_t data_size)
+{
+    return post_ext(state, url, content_type, additional_headers,
+                    data, data_size, /*body*/NULL);
+}
+
+int
+post_stream(post_state_t *state,
+                const char *url,
+                const char *content_type,
+                const char **additional_headers,
+                post_body_t *body)
+{
+    return post_ext(state, url, content_type, additional_headers,
+                    /*data*/NULL, POST_DATA_STRING, body);
+}
+
+/*
+ * upload_file_ext: retries and resumable uploads
+ */
+
+/* Upper limit of the delay between retries */
+#define UPLOAD_MAX_RETRY_DELAY 120
+
+static unsigned upload_retries(void)
+{
+    const char *value = getenv(UPLOAD_RETRIES_ENV);
+    if (value == NULL || value[0] == '\0')
+        return UPLOAD_DEFAULT_RETRIES;
+
+    int retries = 0;
+    if (try_atoi(value, &retries) != 0 || retries < 0)
+    {
+        log_notice("Ignoring invalid %s='%s'", UPLOAD_RETRIES_ENV, value);
+        return UPLOAD_DEFAULT_RETRIES;
+    }
+
+    return retries;
+}
+
+/* 2, 4, 8 ... seconds with random jitter, so clients which failed at the same
+ * time don't retry at the same time */
+static unsigned upload_retry_delay(unsigned attempt)
+{
+    const unsigned delay = MIN(2u << MIN(attempt, 16u), UPLOAD_MAX_RETRY_DELAY);
+    return delay / 2 + g_random_int_range(0, delay / 2 + 1);
+}
+
+static bool upload_failed_transiently(const post_state_t *state, bool http)
+{
+    switch (state->curl_result)
+    {
+        case CURLE_OK:
+            /* Timeout, too many requests or server error */
+            return http && (state->http_resp_code == 408
+                            || state->http_resp_code == 429
+                            || state->http_resp_code >= 500);
+        case CURLE_COULDNT_RESOLVE_PROXY:
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_PARTIAL_FILE:
+        case CURLE_OPERATION_TIMEDOUT:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_AGAIN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+char *upload_checkpoint_path(const char *filename)
+{
+    return xasprintf("%s.upload", filename);
+}
+
+/* The checkpoint is "SIZE MTIME URL" of the file being uploaded, the upload
+ * is resumed only if the file was not changed and goes to the same URL */
+static char *upload_checkpoint_line(const char *url, const struct stat *sb)
+{
+    return xasprintf("%lld %lld %s\n", (long long)sb->st_size, (long long)sb->st_mtime, url);
+}
+
+static bool upload_checkpoint_matches(const char *checkpoint, const char *url,
+                const struct stat *sb)
+{
+    size_t size = 64 * 1024;
+    char *data = xmalloc_open_read_close(checkpoint, &size);
+    if (data == NULL)
+        return false;
+
+    char *line = upload_checkpoint_line(url, sb);
+    const bool matches = strcmp(data, line) == 0;
+
+    free(line);
+    free(data);
+    return matches;
+}
+
+static void upload_checkpoint_save(const char *checkpoint, const char *url,
+                const struct stat *sb)
+{
+    char *line = upload_checkpoint_line(url, sb);
+
+    const int fd = open(checkpoint, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0 || full_write_str(fd, line) != (ssize_t)strlen(line))
+        log_notice("Can't save upload checkpoint '%s': %s", checkpoint, strerror(errno));
+
+    if (fd >= 0)
+        close(fd);
+    free(line);
+}
+
+static bool upload_can_resume(const char *scheme)
+{
+    static const char *const schemes[] = {
+        "http:", "https:", "ftp:", "ftps:", "sftp:", "file:", NULL
+    };
+
+    for (const char *const *s = schemes; *s; ++s)
+        if (strcmp(scheme, *s) == 0)
+            return true;
+
+    return false;
+}
+
+/* Asks the HTTP server for the size of the remote file. Returns -1 if the
+ * size is unknown. With ranges_required, the size is returned only if the
+ * server advertises byte ranges. */
+static off_t upload_remote_size(post_state_t *state, const char *url, bool ranges_required)
+{
+    post_state_t *head_state = new_post_state(POST_WANT_HEADERS
+                                              | (state->flags & POST_WANT_SSL_VERIFY));
+    head_state->session = state->session;
+    head_state->username = state->username;
+    head_state->password = state->password;
+    head_state->client_cert_path = state->client_cert_path;
+    head_state->client_key_path = state->client_key_path;
+    head_state->cert_authority_cert_path = state->cert_authority_cert_path;
+
+    off_t remote_size = -1;
+    post(head_state, url, "application/octet-stream", NULL, NULL, POST_DATA_HEAD);
+    const char *ranges = find_header_in_post_state(head_state, "Accept-Ranges:");
+    if (head_state->http_resp_code == 200
+        && (!ranges_required || (ranges != NULL && strstr(ranges, "bytes") != NULL)))
+    {
+        const char *length = find_header_in_post_state(head_state, "Content-Length:");
+        if (length != NULL)
+            remote_size = strtoll(length, NULL, 10);
+    }
+    free_post_state(head_state);
+
+    return remote_size;
+}
+
+/* Returns the offset of the file the interrupted upload continues from */
+static off_t upload_resume_offset(post_state_t *state, const char *scheme,
+                const char *url, off_t size)
+{
+    /* curl asks the server for the size of the remote file */
+    if (strcmp(scheme, "ftp:") == 0 || strcmp(scheme, "ftps:") == 0
+        || strcmp(scheme, "sftp:") == 0)
+        return -1;
+
+    off_t remote_size = 0;
+    if (strcmp(scheme, "file:") == 0)
+    {
+        /* curl fails to resume if the file does not exist */
+        gchar *path = g_filename_from_uri(url, NULL, NULL);
+        struct stat sb;
+        if (path != NULL && stat(path, &sb) == 0 && S_ISREG(sb.st_mode))
+            remote_size = sb.st_size;
+        g_free(path);
+    }
+    else
+    {
+        /* The server keeps the part sent before the upload was interrupted.
+         * There is no standard way to advertise partial PUT, the servers
+         * which support it advertise byte ranges. Byte ranges describe GET,
+         * hence the result of the resumed PUT is verified afterwards. */
+        remote_size = upload_remote_size(state, url, /*ranges_required*/true);
+        if (remote_size < 0)
+            log_info("The server does not advertise resumable uploads");
+    }
+
+    /* A remote file of the same size might be a different file */
+    if (remote_size <= 0 || remote_size >= size)
+        return 0;
+
+    return remote_size;
+}
+
 /* Unlike post_file(),
  * this function will use PUT, not POST if url is "http(s)://..."
  */
@@ -649,6 +1461,26 @@ char *upload_file_ext(post_state_t *state, const char *url, const char *filename
     else
         whole_url = xstrdup(clean_url);
 
+    const bool http = strcmp(scheme, "http:") == 0 || strcmp(scheme, "https:") == 0;
+
+    /* The remote file is a part of ours only if there is a checkpoint */
+    char *checkpoint = NULL;
+    bool resume = false;
+    struct stat sb = { 0 };
+    if ((flags & UPLOAD_FILE_RESUMABLE) && upload_can_resume(scheme)
+        && stat(filename, &sb) == 0)
+    {
+        checkpoint = upload_checkpoint_path(filename);
+        resume = upload_checkpoint_matches(checkpoint, whole_url, &sb);
+        if (!resume)
+            upload_checkpoint_save(checkpoint, whole_url, &sb);
+    }
+
+    /* Retries sleep, only callers which can wait ask for them */
+    const unsigned retries = (flags & UPLOAD_FILE_RESUMABLE) ? upload_retries() : 0;
+    unsigned attempt = 0;
+    bool range_refused = false;
+
     /* work around bug in libssh2(curl with scp://)
      * libssh2_aget_disconnect() calls close(0)
      * https://bugzilla.redhat.com/show_bug.cgi?id=1147717
@@ -661,9 +1493,17 @@ char *upload_file_ext(post_state_t *state, const char *url, const char *filename
      */
   do_post:
 
+    state->resume_from = resume ? upload_resume_offset(state, scheme, whole_url, sb.st_size) : 0;
+
     /* Do not include the path part of the URL as it can contain sensitive data
      * in case of typos */
-    log_warning(_("Sending %s to %s//%s"), filename, scheme, hostname);
+    if (state->resume_from > 0)
+        log_warning(_("Resuming upload of %s to %s//%s at %llu kbytes"), filename, scheme, hostname,
+                    (unsigned long long)state->resume_from / 1024);
+    else if (state->resume_from < 0)
+        log_warning(_("Resuming upload of %s to %s//%s"), filename, scheme, hostname);
+    else
+        log_warning(_("Sending %s to %s//%s"), filename, scheme, hostname);
     post(state,
                 whole_url,
                 /*content_type:*/ "application/octet-stream",
@@ -671,18 +1511,69 @@ char *upload_file_ext(post_state_t *state, const char *url, const char *filename
                 /*data:*/ filename,
                 POST_DATA_FROMFILE_PUT
     );
+    const off_t resumed_from = state->resume_from;
+    state->resume_from = 0;
 
     dup2(stdin_bck, 0);
 
-    int error = (state->curl_result != 0);
+    /* The server advertised byte ranges but does not accept Content-Range
+     * in PUT after all */
+    if (http && resumed_from > 0 && state->curl_result == 0
+        && (state->http_resp_code == 400
+            || state->http_resp_code == 416
+            || state->http_resp_code == 501))
+    {
+        log_warning(_("The server refused to resume the upload, sending the whole file"));
+
+        free(state->curl_error_msg);
+        state->curl_error_msg = NULL;
+        resume = false;
+        range_refused = true;
+        goto do_post;
+    }
+
+    /* A server which ignores Content-Range stores only the tail of the file */
+    if (http && resumed_from > 0 && state->curl_result == 0 && state->http_resp_code < 300)
+    {
+        const off_t remote_size = upload_remote_size(state, whole_url, /*ranges_required*/false);
+        if (remote_size != sb.st_size)
+        {
+            log_warning(_("The server did not resume the upload, sending the whole file"));
+            log_info("The remote file has %lld bytes instead of %lld",
+                     (long long)remote_size, (long long)sb.st_size);
+
+            free(state->curl_error_msg);
+            state->curl_error_msg = NULL;
+            resume = false;
+            range_refused = true;
+            goto do_post;
+        }
+    }
+
+    int error = (state->curl_result != 0) || (http && state->http_resp_code >= 400);
     if (error)
     {
         if (state->curl_error_msg)
             error_msg("Error while uploading: '%s'", state->curl_error_msg);
+        else if (state->curl_result == 0)
+            error_msg("Error while uploading: HTTP code %d", state->http_resp_code);
         else
             /* for example, when source file can't be opened */
             error_msg("Error while uploading");
 
+        if (attempt < retries && upload_failed_transiently(state, http))
+        {
+            const unsigned delay = upload_retry_delay(attempt++);
+            log_warning(_("Retrying in %u seconds (%u of %u)"), delay, attempt, retries);
+            sleep(delay);
+
+            free(state->curl_error_msg);
+            state->curl_error_msg = NULL;
+            /* Now the remote file is ours */
+            resume = checkpoint != NULL && !range_refused;
+            goto do_post;
+        }
+
         if ((flags & UPLOAD_FILE_HANDLE_ACCESS_DENIALS) &&
                 (state->curl_result == CURLE_LOGIN_DENIED
                  || state->curl_result == CURLE_REMOTE_ACCESS_DENIED))
@@ -710,6 +1601,9 @@ char *upload_file_ext(post_state_t *state, const char *url, const char *filename
             }
         }
 
+        if (checkpoint)
+            log_warning(_("The upload can be resumed later"));
+
         free(whole_url);
         whole_url = NULL;
     }
@@ -717,8 +1611,12 @@ char *upload_file_ext(post_state_t *state, const char *url, const char *filename
     {
         /* This ends up a "reporting status message" in abrtd */
         log_warning(_("Successfully created %s"), whole_url);
+
+        if (checkpoint)
+            unlink(checkpoint);
     }
 
+    free(checkpoint);
     close(stdin_bck);
 
 finito:
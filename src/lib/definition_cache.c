@@ -0,0 +1,787 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "internal_libreport.h"
+#include "definition_cache.h"
+
+#define DEFINITION_CACHE_DEFAULT_DIR LOCALSTATEDIR"/cache/libreport"
+#define DEFINITION_CACHE_SFX ".cache"
+#define DEFINITION_CACHE_EVENTS "events"
+#define DEFINITION_CACHE_WORKFLOWS "workflows"
+
+/* "LRDC" and the format version. The cache is built on the host which reads
+ * it, so the numbers are stored in the host byte order. */
+#define DEFINITION_CACHE_MAGIC 0x4344524c
+#define DEFINITION_CACHE_VERSION 1
+
+/* The length of a NULL string */
+#define DEFINITION_CACHE_NULL UINT32_MAX
+
+/* File layout:
+ *   u32 magic, u32 version, str locale, str directory, u32 count
+ *   count times: str name, i64 mtime sec, i64 mtime nsec, i64 size,
+ *                u32 length, the entry of the given length
+ *
+ * A string is its u32 length followed by the bytes without the terminating
+ * NUL.
+ */
+
+struct definition_cache
+{
+    dev_t dev;
+    ino_t ino;
+    struct timespec mtime;
+    off_t size;
+
+    char *data;
+    /* entry name -> the entry's data following the name */
+    GHashTable *entries;
+};
+
+struct cache_reader
+{
+    const char *pos;
+    const char *end;
+    bool failed;
+};
+
+static GMutex definition_cache_lock;
+/* cache file path -> struct definition_cache */
+static GHashTable *definition_caches;
+
+char *definition_cache_dir(void)
+{
+    const char *dir = getenv(DEFINITION_CACHE_DIR_ENV);
+    if (dir != NULL && dir[0] != '\0')
+        return xstrdup(dir);
+
+    return xstrdup(DEFINITION_CACHE_DEFAULT_DIR);
+}
+
+char *definition_cache_locale(void)
+{
+    char *locale = xstrdup(setlocale(LC_ALL, NULL));
+    strchrnul(locale, '.')[0] = '\0';
+    return locale;
+}
+
+/* The cache file of the directory, the directory is hashed to get a file name
+ * of a sane length */
+static char *definition_cache_path(const char *kind, const char *dir, const char *locale)
+{
+    if (locale[0] == '\0' || strchr(locale, '/') != NULL)
+        return NULL;
+
+    char hash[SHA1_RESULT_LEN*2 + 1];
+    str_to_sha1str(hash, dir);
+
+    char *cache_dir = definition_cache_dir();
+    char *name = xasprintf("%s.%s.%s"DEFINITION_CACHE_SFX, kind, hash, locale);
+    char *path = concat_path_file(cache_dir, name);
+    free(name);
+    free(cache_dir);
+
+    return path;
+}
+
+static bool cache_read(struct cache_reader *r, void *dest, size_t len)
+{
+    if (r->failed || (size_t)(r->end - r->pos) < len)
+    {
+        r->failed = true;
+        memset(dest, 0, len);
+        return false;
+    }
+
+    memcpy(dest, r->pos, len);
+    r->pos += len;
+    return true;
+}
+
+static uint32_t cache_read_u32(struct cache_reader *r)
+{
+    uint32_t value;
+    cache_read(r, &value, sizeof(value));
+    return value;
+}
+
+static int64_t cache_read_i64(struct cache_reader *r)
+{
+    int64_t value;
+    cache_read(r, &value, sizeof(value));
+    return value;
+}
+
+/* Returns a pointer to the mapped file, the string is not NUL-terminated */
+static const char *cache_read_str_ref(struct cache_reader *r, uint32_t *len)
+{
+    *len = cache_read_u32(r);
+    if (r->failed || *len == DEFINITION_CACHE_NULL)
+        return NULL;
+
+    if ((size_t)(r->end - r->pos) < *len)
+    {
+        r->failed = true;
+        return NULL;
+    }
+
+    const char *str = r->pos;
+    r->pos += *len;
+    return str;
+}
+
+static char *cache_read_str(struct cache_reader *r)
+{
+    uint32_t len;
+    const char *str = cache_read_str_ref(r, &len);
+    return str ? xstrndup(str, len) : NULL;
+}
+
+static bool cache_str_equals(struct cache_reader *r, const char *expected)
+{
+    uint32_t len;
+    const char *str = cache_read_str_ref(r, &len);
+    return str && len == strlen(expected) && memcmp(str, expected, len) == 0;
+}
+
+static void cache_write_u32(GByteArray *buf, uint32_t value)
+{
+    g_byte_array_append(buf, (const guint8 *)&value, sizeof(value));
+}
+
+static void cache_write_i64(GByteArray *buf, int64_t value)
+{
+    g_byte_array_append(buf, (const guint8 *)&value, sizeof(value));
+}
+
+static void cache_write_str(GByteArray *buf, const char *str)
+{
+    if (str == NULL)
+    {
+        cache_write_u32(buf, DEFINITION_CACHE_NULL);
+        return;
+    }
+
+    const size_t len = strlen(str);
+    cache_write_u32(buf, len);
+    g_byte_array_append(buf, (const guint8 *)str, len);
+}
+
+static void free_definition_cache(struct definition_cache *cache)
+{
+    if (cache == NULL)
+        return;
+
+    if (cache->entries)
+        g_hash_table_destroy(cache->entries);
+    munmap(cache->data, cache->size);
+    free(cache);
+}
+
+/* Maps the cache file and indexes its entries */
+static struct definition_cache *definition_cache_map(const char *path,
+                                                     const char *locale, const char *dir)
+{
+    const int fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno != ENOENT)
+            log_notice("Can't open definition cache '%s': %s", path, strerror(errno));
+        return NULL;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || !S_ISREG(sb.st_mode) || sb.st_size == 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    /* Other users could make us load anything they like */
+    if ((sb.st_uid != 0 && sb.st_uid != geteuid()) || (sb.st_mode & (S_IWGRP | S_IWOTH)))
+    {
+        log_notice("Ignoring definition cache '%s' writable by other users", path);
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        log_notice("Can't map definition cache '%s': %s", path, strerror(errno));
+        return NULL;
+    }
+
+    struct definition_cache *cache = xzalloc(sizeof(*cache));
+    cache->dev = sb.st_dev;
+    cache->ino = sb.st_ino;
+    cache->mtime = sb.st_mtim;
+    cache->size = sb.st_size;
+    cache->data = data;
+
+    struct cache_reader r = { cache->data, cache->data + cache->size, false };
+    if (cache_read_u32(&r) != DEFINITION_CACHE_MAGIC
+        || cache_read_u32(&r) != DEFINITION_CACHE_VERSION
+        || !cache_str_equals(&r, locale)
+        || !cache_str_equals(&r, dir))
+    {
+        log_notice("Ignoring definition cache '%s' of a different format or directory", path);
+        free_definition_cache(cache);
+        return NULL;
+    }
+
+    cache->entries = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+    for (uint32_t count = cache_read_u32(&r); count > 0 && !r.failed; --count)
+    {
+        uint32_t name_len;
+        const char *name = cache_read_str_ref(&r, &name_len);
+        const char *entry = r.pos;
+
+        /* mtime sec, mtime nsec, size */
+        int64_t stamps[3];
+        cache_read(&r, stamps, sizeof(stamps));
+        const uint32_t len = cache_read_u32(&r);
+        if (name == NULL || r.failed || (size_t)(r.end - r.pos) < len)
+        {
+            r.failed = true;
+            break;
+        }
+        r.pos += len;
+
+        g_hash_table_replace(cache->entries, xstrndup(name, name_len), (gpointer)entry);
+    }
+
+    if (r.failed)
+    {
+        log_notice("Ignoring corrupted definition cache '%s'", path);
+        free_definition_cache(cache);
+        return NULL;
+    }
+
+    log_debug("Mapped definition cache '%s' with %u entries", path,
+              g_hash_table_size(cache->entries));
+    return cache;
+}
+
+/* Returns the mapped cache file, the file is mapped again if it has been
+ * replaced. Must be called with definition_cache_lock held. */
+static struct definition_cache *definition_cache_get(const char *path,
+                                                     const char *locale, const char *dir)
+{
+    if (definition_caches == NULL)
+        definition_caches = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                  free, (GDestroyNotify)free_definition_cache);
+
+    struct definition_cache *cache = g_hash_table_lookup(definition_caches, path);
+
+    struct stat sb;
+    if (stat(path, &sb) != 0)
+    {
+        if (cache)
+            g_hash_table_remove(definition_caches, path);
+        return NULL;
+    }
+
+    if (cache
+        && cache->dev == sb.st_dev
+        && cache->ino == sb.st_ino
+        && cache->size == sb.st_size
+        && cache->mtime.tv_sec == sb.st_mtim.tv_sec
+        && cache->mtime.tv_nsec == sb.st_mtim.tv_nsec)
+    {
+        return cache;
+    }
+
+    cache = definition_cache_map(path, locale, dir);
+    if (cache)
+        g_hash_table_replace(definition_caches, xstrdup(path), cache);
+    else
+        g_hash_table_remove(definition_caches, path);
+
+    return cache;
+}
+
+/* Sets up the reader of the up-to-date entry of the XML file. Must be called
+ * with definition_cache_lock held. */
+static bool definition_cache_find(const char *kind, const char *filename, const char *locale,
+                                  struct cache_reader *r)
+{
+    struct stat sb;
+    if (stat(filename, &sb) != 0)
+        return false;
+
+    bool found = false;
+    char *dir = g_path_get_dirname(filename);
+    char *name = g_path_get_basename(filename);
+    char *path = NULL;
+
+    char *ext = strrchr(name, '.');
+    if (ext == NULL || strcmp(ext, ".xml") != 0)
+        goto finish;
+    *ext = '\0';
+
+    path = definition_cache_path(kind, dir, locale);
+    if (path == NULL)
+        goto finish;
+
+    struct definition_cache *cache = definition_cache_get(path, locale, dir);
+    if (cache == NULL)
+        goto finish;
+
+    const char *entry = g_hash_table_lookup(cache->entries, name);
+    if (entry == NULL)
+        goto finish;
+
+    r->pos = entry;
+    r->end = cache->data + cache->size;
+    r->failed = false;
+
+    const int64_t mtime_sec = cache_read_i64(r);
+    const int64_t mtime_nsec = cache_read_i64(r);
+    const int64_t size = cache_read_i64(r);
+    const uint32_t len = cache_read_u32(r);
+
+    if (mtime_sec != sb.st_mtim.tv_sec || mtime_nsec != sb.st_mtim.tv_nsec || size != sb.st_size)
+    {
+        log_debug("Cached definition of '%s' is out of date", filename);
+        goto finish;
+    }
+
+    r->end = r->pos + len;
+    found = true;
+
+finish:
+    free(path);
+    g_free(name);
+    g_free(dir);
+    return found;
+}
+
+/* Adds the option the same way the XML parser does: an option of the same
+ * name is replaced but keeps its value */
+static void definition_cache_add_option(event_config_t *event_config, event_option_t *opt)
+{
+    event_option_t *old_opt = ec_set_option(event_config, opt);
+    if (old_opt)
+    {
+        if (old_opt->eo_value)
+        {
+            free(opt->eo_value);
+            opt->eo_value = old_opt->eo_value;
+            old_opt->eo_value = NULL;
+        }
+        free_event_option(old_opt);
+    }
+}
+
+static void cache_read_str_into(struct cache_reader *r, char **dest)
+{
+    char *value = cache_read_str(r);
+    if (value)
+    {
+        free(*dest);
+        *dest = value;
+    }
+}
+
+static void encode_event(GByteArray *buf, event_config_t *ec)
+{
+    cache_write_str(buf, ec_get_screen_name(ec));
+    cache_write_str(buf, ec_get_description(ec));
+    cache_write_str(buf, ec_get_long_desc(ec));
+    cache_write_str(buf, ec->ec_creates_items);
+    cache_write_str(buf, ec->ec_requires_items);
+    cache_write_str(buf, ec->ec_exclude_items_by_default);
+    cache_write_str(buf, ec->ec_include_items_by_default);
+    cache_write_str(buf, ec->ec_exclude_items_always);
+    cache_write_u32(buf, ec->ec_exclude_binary_items);
+    cache_write_i64(buf, ec->ec_minimal_rating);
+    cache_write_u32(buf, ec->ec_skip_review);
+    cache_write_u32(buf, ec->ec_sending_sensitive_data);
+    cache_write_u32(buf, ec->ec_supports_restricted_access);
+    cache_write_str(buf, ec->ec_restricted_access_option);
+    cache_write_u32(buf, ec->ec_requires_details);
+
+    cache_write_u32(buf, g_list_length(ec->ec_imported_event_names));
+    for (GList *iter = ec->ec_imported_event_names; iter; iter = g_list_next(iter))
+        cache_write_str(buf, iter->data);
+
+    cache_write_u32(buf, g_list_length(ec_get_options(ec)));
+    for (GList *iter = ec_get_options(ec); iter; iter = g_list_next(iter))
+    {
+        event_option_t *opt = iter->data;
+        cache_write_str(buf, opt->eo_name);
+        cache_write_str(buf, opt->eo_value);
+        cache_write_str(buf, opt->eo_label);
+        cache_write_str(buf, opt->eo_note_html);
+        cache_write_u32(buf, opt->eo_type);
+        cache_write_u32(buf, opt->eo_allow_empty);
+        cache_write_u32(buf, opt->is_advanced);
+    }
+}
+
+static bool decode_event(struct cache_reader *r, event_config_t *ec)
+{
+    char *value;
+    if ((value = cache_read_str(r)) != NULL)
+        ec_set_screen_name(ec, value);
+    free(value);
+    if ((value = cache_read_str(r)) != NULL)
+        ec_set_description(ec, value);
+    free(value);
+    if ((value = cache_read_str(r)) != NULL)
+        ec_set_long_desc(ec, value);
+    free(value);
+
+    cache_read_str_into(r, &ec->ec_creates_items);
+    cache_read_str_into(r, &ec->ec_requires_items);
+    cache_read_str_into(r, &ec->ec_exclude_items_by_default);
+    cache_read_str_into(r, &ec->ec_include_items_by_default);
+    cache_read_str_into(r, &ec->ec_exclude_items_always);
+    ec->ec_exclude_binary_items = cache_read_u32(r);
+    ec->ec_minimal_rating = cache_read_i64(r);
+    ec->ec_skip_review = cache_read_u32(r);
+    ec->ec_sending_sensitive_data = cache_read_u32(r);
+    ec->ec_supports_restricted_access = cache_read_u32(r);
+    cache_read_str_into(r, &ec->ec_restricted_access_option);
+    ec->ec_requires_details = cache_read_u32(r);
+
+    for (uint32_t count = cache_read_u32(r); count > 0 && !r->failed; --count)
+    {
+        if ((value = cache_read_str(r)) != NULL)
+            ec->ec_imported_event_names = g_list_append(ec->ec_imported_event_names, value);
+    }
+
+    for (uint32_t count = cache_read_u32(r); count > 0 && !r->failed; --count)
+    {
+        event_option_t *opt = new_event_option();
+        opt->eo_name = cache_read_str(r);
+        opt->eo_value = cache_read_str(r);
+        opt->eo_label = cache_read_str(r);
+        opt->eo_note_html = cache_read_str(r);
+        opt->eo_type = cache_read_u32(r);
+        opt->eo_allow_empty = cache_read_u32(r);
+        opt->is_advanced = cache_read_u32(r);
+
+        if (r->failed || opt->eo_name == NULL || opt->eo_type > OPTION_TYPE_INVALID)
+        {
+            r->failed = true;
+            free_event_option(opt);
+            break;
+        }
+
+        definition_cache_add_option(ec, opt);
+    }
+
+    return !r->failed;
+}
+
+bool definition_cache_load_event(event_config_t *event_config, const char *filename,
+                                 const char *locale)
+{
+    bool loaded = false;
+    struct cache_reader r;
+
+    g_mutex_lock(&definition_cache_lock);
+    if (definition_cache_find(DEFINITION_CACHE_EVENTS, filename, locale, &r))
+    {
+        loaded = decode_event(&r, event_config);
+        if (loaded)
+            log_debug("Loaded event '%s' from the definition cache", filename);
+        else
+            log_warning("Corrupted cached definition of '%s'", filename);
+    }
+    g_mutex_unlock(&definition_cache_lock);
+
+    return loaded;
+}
+
+static void encode_workflow(GByteArray *buf, workflow_t *workflow, GList *event_names)
+{
+    cache_write_str(buf, wf_get_screen_name(workflow));
+    cache_write_str(buf, wf_get_description(workflow));
+    cache_write_str(buf, wf_get_long_desc(workflow));
+    cache_write_u32(buf, (uint32_t)wf_get_priority(workflow));
+
+    cache_write_u32(buf, g_list_length(event_names));
+    for (GList *iter = event_names; iter; iter = g_list_next(iter))
+        cache_write_str(buf, iter->data);
+}
+
+static bool decode_workflow(struct cache_reader *r, workflow_t *workflow, GList **event_names)
+{
+    char *value;
+    if ((value = cache_read_str(r)) != NULL)
+        wf_set_screen_name(workflow, value);
+    free(value);
+    if ((value = cache_read_str(r)) != NULL)
+        wf_set_description(workflow, value);
+    free(value);
+    if ((value = cache_read_str(r)) != NULL)
+        wf_set_long_desc(workflow, value);
+    free(value);
+
+    wf_set_priority(workflow, (int)cache_read_u32(r));
+
+    for (uint32_t count = cache_read_u32(r); count > 0 && !r->failed; --count)
+    {
+        if ((value = cache_read_str(r)) != NULL)
+            *event_names = g_list_append(*event_names, value);
+    }
+
+    return !r->failed;
+}
+
+bool definition_cache_load_workflow(workflow_t *workflow, const char *filename,
+                                    const char *locale)
+{
+    bool loaded = false;
+    GList *event_names = NULL;
+    struct cache_reader r;
+
+    g_mutex_lock(&definition_cache_lock);
+    if (definition_cache_find(DEFINITION_CACHE_WORKFLOWS, filename, locale, &r))
+    {
+        loaded = decode_workflow(&r, workflow, &event_names);
+        if (loaded)
+            log_debug("Loaded workflow '%s' from the definition cache", filename);
+        else
+            log_warning("Corrupted cached definition of '%s'", filename);
+    }
+    g_mutex_unlock(&definition_cache_lock);
+
+    /* The events have their own entries, so they are loaded without the lock
+     * and the same way the XML parser loads them */
+    for (GList *iter = event_names; loaded && iter; iter = g_list_next(iter))
+    {
+        event_config_t *ec = new_event_config(iter->data);
+        char *subevent_filename = xasprintf(EVENTS_DIR"/%s.xml", (const char *)iter->data);
+
+        load_event_description_from_file(ec, subevent_filename);
+        if (ec_get_screen_name(ec))
+            wf_add_event(workflow, ec);
+        else
+            free_event_config(ec);
+
+        free(subevent_filename);
+    }
+    g_list_free_full(event_names, free);
+
+    return loaded;
+}
+
+static void encode_event_file(GByteArray *buf, const char *fullpath, const char *name,
+                              const char *locale)
+{
+    event_config_t *ec = new_event_config(name);
+    parse_event_description_file(ec, fullpath, locale);
+    encode_event(buf, ec);
+    free_event_config(ec);
+}
+
+static void encode_workflow_file(GByteArray *buf, const char *fullpath, const char *name,
+                                 const char *locale)
+{
+    workflow_t *workflow = new_workflow(name);
+    GList *event_names = NULL;
+    parse_workflow_description_file(workflow, fullpath, locale, &event_names);
+    encode_workflow(buf, workflow, event_names);
+    g_list_free_full(event_names, free);
+    free_workflow(workflow);
+}
+
+/* The cache is read without any lock, hence it is written to a temporary
+ * file and renamed */
+static int definition_cache_store(const char *path, GByteArray *buf)
+{
+    char *cache_dir = definition_cache_dir();
+    char *tmp_path = xasprintf("%s.%lu.tmp", path, (unsigned long)getpid());
+    int r = 0;
+
+    if (g_mkdir_with_parents(cache_dir, 0755) != 0)
+    {
+        r = -errno;
+        perror_msg("Can't create definition cache directory '%s'", cache_dir);
+        goto finish;
+    }
+
+    const int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        r = -errno;
+        perror_msg("Can't create definition cache '%s'", tmp_path);
+        goto finish;
+    }
+
+    if (full_write(fd, buf->data, buf->len) != buf->len || fsync(fd) != 0)
+    {
+        r = -errno;
+        perror_msg("Can't write definition cache '%s'", tmp_path);
+        close(fd);
+        unlink(tmp_path);
+        goto finish;
+    }
+    close(fd);
+
+    if (rename(tmp_path, path) != 0)
+    {
+        r = -errno;
+        perror_msg("Can't rename definition cache '%s'", tmp_path);
+        unlink(tmp_path);
+    }
+
+finish:
+    free(tmp_path);
+    free(cache_dir);
+    return r;
+}
+
+static int definition_cache_update(const char *kind, const char *dir, const char *locale,
+                                   void (*encode)(GByteArray *, const char *, const char *, const char *))
+{
+    char *cur_locale = NULL;
+    if (locale == NULL)
+        locale = cur_locale = definition_cache_locale();
+
+    /* The directory as returned by g_path_get_dirname() for the files */
+    char *key_dir = xstrdup(dir);
+    for (size_t len = strlen(key_dir); len > 1 && key_dir[len - 1] == '/'; --len)
+        key_dir[len - 1] = '\0';
+
+    int r = 0;
+    char *path = definition_cache_path(kind, key_dir, locale);
+    if (path == NULL)
+    {
+        error_msg("Invalid locale '%s'", locale);
+        r = -EINVAL;
+        goto finish;
+    }
+
+    GByteArray *buf = g_byte_array_new();
+    cache_write_u32(buf, DEFINITION_CACHE_MAGIC);
+    cache_write_u32(buf, DEFINITION_CACHE_VERSION);
+    cache_write_str(buf, locale);
+    cache_write_str(buf, key_dir);
+    const guint count_offset = buf->len;
+    cache_write_u32(buf, 0);
+
+    uint32_t count = 0;
+    GByteArray *entry = g_byte_array_new();
+    GHashTable *added = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+    GList *files = get_file_list(key_dir, "xml");
+    for (GList *iter = files; iter; iter = g_list_next(iter))
+    {
+        file_obj_t *file = iter->data;
+
+        /* Symlinks are listed with the path of their target */
+        char *name = g_path_get_basename(fo_get_fullpath(file));
+        strrchr(name, '.')[0] = '\0';
+        if (g_hash_table_contains(added, name))
+        {
+            g_free(name);
+            continue;
+        }
+
+        /* Before parsing, so the entry is out of date if the file is
+         * changed in the meantime */
+        struct stat sb;
+        if (stat(fo_get_fullpath(file), &sb) != 0)
+        {
+            perror_msg("Can't stat '%s'", fo_get_fullpath(file));
+            g_free(name);
+            continue;
+        }
+
+        g_byte_array_set_size(entry, 0);
+        encode(entry, fo_get_fullpath(file), name, locale);
+
+        cache_write_str(buf, name);
+        cache_write_i64(buf, sb.st_mtim.tv_sec);
+        cache_write_i64(buf, sb.st_mtim.tv_nsec);
+        cache_write_i64(buf, sb.st_size);
+        cache_write_u32(buf, entry->len);
+        g_byte_array_append(buf, entry->data, entry->len);
+
+        g_hash_table_add(added, xstrdup(name));
+        g_free(name);
+        ++count;
+    }
+    free_file_list(files);
+    g_hash_table_destroy(added);
+    g_byte_array_free(entry, TRUE);
+
+    memcpy(buf->data + count_offset, &count, sizeof(count));
+    r = definition_cache_store(path, buf);
+    if (r == 0)
+        log_info("Cached %u %s of '%s' for locale '%s'", (unsigned)count, kind, key_dir, locale);
+
+    g_byte_array_free(buf, TRUE);
+
+finish:
+    free(path);
+    free(key_dir);
+    free(cur_locale);
+    return r;
+}
+
+int definition_cache_update_events(const char *events_dir, const char *locale)
+{
+    return definition_cache_update(DEFINITION_CACHE_EVENTS, events_dir, locale, encode_event_file);
+}
+
+int definition_cache_update_workflows(const char *workflows_dir, const char *locale)
+{
+    return definition_cache_update(DEFINITION_CACHE_WORKFLOWS, workflows_dir, locale, encode_workflow_file);
+}
+
+GList *definition_cache_get_locales(void)
+{
+    char *cache_dir = definition_cache_dir();
+    GList *locales = NULL;
+
+    DIR *dir = opendir(cache_dir);
+    if (dir == NULL)
+    {
+        if (errno != ENOENT)
+            perror_msg("Can't open definition cache directory '%s'", cache_dir);
+        free(cache_dir);
+        return NULL;
+    }
+
+    struct dirent *dent;
+    while ((dent = readdir(dir)) != NULL)
+    {
+        /* KIND.HASH.LOCALE.cache */
+        if (!g_str_has_suffix(dent->d_name, DEFINITION_CACHE_SFX))
+            continue;
+
+        char *name = xstrndup(dent->d_name, strlen(dent->d_name) - strlen(DEFINITION_CACHE_SFX));
+        const char *locale = strrchr(name, '.');
+        if (locale && locale[1] != '\0'
+            && !g_list_find_custom(locales, locale + 1, (GCompareFunc)strcmp))
+        {
+            locales = g_list_append(locales, xstrdup(locale + 1));
+        }
+        free(name);
+    }
+
+    closedir(dir);
+    free(cache_dir);
+    return locales;
+}
@@ -0,0 +1,94 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#ifndef DEFINITION_CACHE_H_
+#define DEFINITION_CACHE_H_
+
+/* Compiled cache of event and workflow XML definitions
+ *
+ * One cache file holds the parsed XML files of one directory for one locale.
+ * The files are mmapped and the entries are turned into event_config_t and
+ * workflow_t without parsing XML. An entry is used only if the modification
+ * time and the size of its XML file have not changed since the cache was
+ * built, otherwise the XML file is parsed as before.
+ *
+ * The cache files are stored in LOCALSTATEDIR/cache/libreport or in the
+ * directory from the environment variable LIBREPORT_DEFINITION_CACHE_DIR and
+ * are regenerated by report-update-cache. Only cache files owned by root or
+ * by the current user and not writable by others are used.
+ */
+
+#include <stdbool.h>
+#include <glib.h>
+
+#include "event_config.h"
+#include "workflow.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEFINITION_CACHE_DIR_ENV "LIBREPORT_DEFINITION_CACHE_DIR"
+
+/* Returns the malloced path of the cache directory. */
+char *definition_cache_dir(void);
+
+/* Returns the current locale without the encoding, e.g. "cs_CZ", the way the
+ * XML parsers match xml:lang attributes. */
+char *definition_cache_locale(void);
+
+/* Fills the event_config with the cached definition from the XML file.
+ *
+ * @returns false if there is no up-to-date entry of the file for the locale.
+ */
+bool definition_cache_load_event(event_config_t *event_config, const char *filename,
+                                 const char *locale);
+
+/* Fills the workflow with the cached definition from the XML file, the
+ * workflow's events are loaded from EVENTS_DIR.
+ *
+ * @returns false if there is no up-to-date entry of the file for the locale.
+ */
+bool definition_cache_load_workflow(workflow_t *workflow, const char *filename,
+                                    const char *locale);
+
+/* Parses all XML files of the directory and replaces its cache file.
+ *
+ * @param locale NULL means the current locale.
+ * @returns 0 on success or a negative errno value.
+ */
+int definition_cache_update_events(const char *events_dir, const char *locale);
+int definition_cache_update_workflows(const char *workflows_dir, const char *locale);
+
+/* Returns the malloced locales of all files in the cache directory. */
+GList *definition_cache_get_locales(void);
+
+/* The XML parsers without the cache */
+void parse_event_description_file(event_config_t *event_config, const char *filename,
+                                  const char *locale);
+
+/* @param event_names If not NULL, the names of the workflow's events are
+ * appended to the list instead of loading the events. */
+void parse_workflow_description_file(workflow_t *workflow, const char *filename,
+                                     const char *locale, GList **event_names);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEFINITION_CACHE_H_ */
@@ -90,6 +90,13 @@
 // does not exist (backward compatibility).
 #define META_DATA_DIR_NAME             ".libreport"
 #define META_DATA_FILE_OWNER           "owner"
+// A consolidated record of the values needed to open and list a dump
+// directory (see struct dd_md_record).
+#define META_DATA_FILE_RECORD          "record"
+#define META_DATA_RECORD_VERSION       "2"
+// The record is a handful of short lines, anything bigger is not ours.
+#define META_DATA_RECORD_MAX_SIZE      1024
+#define META_DATA_CACHE_PREFIX         "cache."
 
 enum {
     /* Try to create meta-data dir if it does not exist */
@@ -180,7 +187,8 @@ int secure_openat_read(int dir_fd, const char *filename)
         return -EFAULT;
     }
 
-    static char reopen_buf[sizeof("/proc/self/fd/") + 3*sizeof(int) + 1];
+    /* Not static - problem data items can be loaded by several threads */
+    char reopen_buf[sizeof("/proc/self/fd/") + 3*sizeof(int) + 1];
 
     int path_fd = openat(dir_fd, filename, O_PATH | O_NOFOLLOW);
     if (path_fd < 0)
@@ -208,9 +216,10 @@ int secure_openat_read(int dir_fd, const char *filename)
     }
 
     const int fd = open(reopen_buf, O_RDONLY);
+    const int err = errno;
     close(path_fd);
 
-    return fd;
+    return fd < 0 ? -err : fd;
 }
 
 static int read_number_from_file_at(int dir_fd, const char *filename, const char *typename,
@@ -391,9 +400,336 @@ int create_symlink_lockfile(const char *filename, const char *pid_str)
     return create_symlink_lockfile_at(AT_FDCWD, filename, pid_str);
 }
 
+/* The meta-data record mirrors the values which are needed to open a dump
+ * directory and to display it in a list of problems so that they can be
+ * obtained by a single read() instead of opening and parsing one file per
+ * value.
+ *
+ * The record is stored in the meta-data directory as 'key=value' lines and is
+ * always replaced atomically (see dd_md_record_update()). The element files
+ * remain the source of truth: every member of the record is optional and
+ * a missing member (or a missing record) means that the element file must be
+ * consulted. The generation is incremented on every update.
+ *
+ * Every member is accompanied by a 'stamp.key=ino size ctime' line describing
+ * the element file the value was taken from. A member whose element file has
+ * been modified outside of libreport does not match its stamp and is ignored.
+ * Readers check only the members they use (see dd_md_record_valid()), so
+ * opening a dump directory costs one fstatat() per used value on top of the
+ * read of the record.
+ */
+static const char *const s_record_members[] = {
+    FILENAME_TIME,
+    FILENAME_LAST_OCCURRENCE,
+    FILENAME_COUNT,
+    FILENAME_TYPE,
+    META_DATA_FILE_OWNER,
+};
+
+/* Indexes of s_record_members */
+enum {
+    DD_MD_RECORD_TIME,
+    DD_MD_RECORD_LAST_OCCURRENCE,
+    DD_MD_RECORD_COUNT,
+    DD_MD_RECORD_TYPE,
+    DD_MD_RECORD_OWNER,
+};
+
+#define DD_MD_RECORD_MEMBERS ARRAY_SIZE(s_record_members)
+
+struct dd_md_stamp
+{
+    bool valid;
+    unsigned long long ino;
+    unsigned long long size;
+    long long ctime_sec;
+    long long ctime_nsec;
+};
+
+struct dd_md_record
+{
+    unsigned long long generation;
+    long long time;
+    long long last_occurrence;
+    long long count;
+    long long owner;
+    /* Empty string if unknown */
+    char type[128];
+    /* Indexed like s_record_members */
+    struct dd_md_stamp stamps[DD_MD_RECORD_MEMBERS];
+};
+
+static void dd_md_record_init(struct dd_md_record *record)
+{
+    record->generation = 0;
+    record->time = -1;
+    record->last_occurrence = -1;
+    record->count = -1;
+    record->owner = -1;
+    record->type[0] = '\0';
+    memset(record->stamps, 0, sizeof(record->stamps));
+}
+
+/* Returns the index of the member in s_record_members or -1. */
+static int dd_md_record_member(const char *name)
+{
+    for (unsigned i = 0; i < DD_MD_RECORD_MEMBERS; ++i)
+        if (strcmp(name, s_record_members[i]) == 0)
+            return i;
+
+    return -1;
+}
+
+/* Converts a decimal number in the range <0, max>, returns -1 on errors. */
+static long long dd_md_record_number(const char *value, unsigned long long max)
+{
+    if (value == NULL || !isdigit(value[0]))
+        return -1;
+
+    errno = 0;
+    char *endptr;
+    const unsigned long long res = strtoull(value, &endptr, /* base */ 10);
+    if (errno != 0 || *endptr != '\0' || res > max)
+        return -1;
+
+    return (long long)res;
+}
+
+static void dd_md_record_set(struct dd_md_record *record, const char *key, const char *value)
+{
+    const long long MAX_TIME_T = (1ULL << (sizeof(time_t)*8 - 1)) - 1;
+    const long long MAX_UID_T = (1ULL << (sizeof(uid_t)*8 - 1)) - 1;
+
+    if (strcmp(key, FILENAME_TIME) == 0)
+        record->time = dd_md_record_number(value, MAX_TIME_T);
+    else if (strcmp(key, FILENAME_LAST_OCCURRENCE) == 0)
+        record->last_occurrence = dd_md_record_number(value, MAX_TIME_T);
+    else if (strcmp(key, FILENAME_COUNT) == 0)
+        record->count = dd_md_record_number(value, LLONG_MAX);
+    else if (strcmp(key, META_DATA_FILE_OWNER) == 0)
+        record->owner = dd_md_record_number(value, MAX_UID_T);
+    else if (strcmp(key, FILENAME_TYPE) == 0)
+    {
+        record->type[0] = '\0';
+        /* Values that cannot be represented are left to the element file */
+        if (value != NULL && strlen(value) < sizeof(record->type) && strchr(value, '\n') == NULL)
+            strcpy(record->type, value);
+    }
+}
+
+static bool dd_md_record_is_tracked(const char *name)
+{
+    return dd_md_record_member(name) >= 0;
+}
+
+static bool dd_md_record_has(const struct dd_md_record *record, int member)
+{
+    switch (member)
+    {
+        case DD_MD_RECORD_TIME: return record->time >= 0;
+        case DD_MD_RECORD_LAST_OCCURRENCE: return record->last_occurrence >= 0;
+        case DD_MD_RECORD_COUNT: return record->count >= 0;
+        case DD_MD_RECORD_TYPE: return record->type[0] != '\0';
+        case DD_MD_RECORD_OWNER: return record->owner >= 0;
+    }
+
+    return false;
+}
+
+/* The owner is stored in the meta-data directory, the others are elements */
+static int dd_md_record_member_dir_fd(struct dump_dir *dd, int dd_md_fd, int member)
+{
+    return member == DD_MD_RECORD_OWNER ? dd_md_fd : dd->dd_fd;
+}
+
+static bool dd_md_stamp_file(int dir_fd, const char *name, struct dd_md_stamp *stamp)
+{
+    struct stat sb;
+    stamp->valid = fstatat(dir_fd, name, &sb, AT_SYMLINK_NOFOLLOW) == 0
+                   && S_ISREG(sb.st_mode);
+    if (!stamp->valid)
+        return false;
+
+    stamp->ino = sb.st_ino;
+    stamp->size = sb.st_size;
+    /* ctime can't be set by users, it changes on every write */
+    stamp->ctime_sec = sb.st_ctim.tv_sec;
+    stamp->ctime_nsec = sb.st_ctim.tv_nsec;
+    return true;
+}
+
+static bool dd_md_stamp_parse(const char *value, struct dd_md_stamp *stamp)
+{
+    stamp->valid = sscanf(value, "%llu %llu %lld.%lld",
+                          &stamp->ino, &stamp->size, &stamp->ctime_sec, &stamp->ctime_nsec) == 4;
+    return stamp->valid;
+}
+
+static bool dd_md_stamp_equal(const struct dd_md_stamp *a, const struct dd_md_stamp *b)
+{
+    return a->valid && b->valid
+        && a->ino == b->ino
+        && a->size == b->size
+        && a->ctime_sec == b->ctime_sec
+        && a->ctime_nsec == b->ctime_nsec;
+}
+
+/* Forgets the value of the member, readers use the file instead */
+static void dd_md_record_unset(struct dd_md_record *record, int member)
+{
+    dd_md_record_set(record, s_record_members[member], NULL);
+    record->stamps[member].valid = false;
+}
+
+static int dd_get_meta_data_dir_fd(struct dump_dir *dd, int flags);
+
+/* Returns true if the record has the member and its file matches the stamp.
+ * Drops the member otherwise, so the caller falls back to the file.
+ */
+static bool dd_md_record_valid(struct dump_dir *dd, struct dd_md_record *record, int member)
+{
+    if (!dd_md_record_has(record, member))
+        return false;
+
+    const int dd_md_fd = dd_get_meta_data_dir_fd(dd, /*no create*/0);
+    struct dd_md_stamp current;
+    if (dd_md_fd < 0
+        || !dd_md_stamp_file(dd_md_record_member_dir_fd(dd, dd_md_fd, member), s_record_members[member], &current)
+        || !dd_md_stamp_equal(&record->stamps[member], &current))
+    {
+        log_debug("Meta-data record of '%s' is out of date", s_record_members[member]);
+        dd_md_record_unset(record, member);
+        return false;
+    }
+
+    return true;
+}
+
+/* Drops all members whose files do not match their stamps */
+static void dd_md_record_validate(struct dump_dir *dd, struct dd_md_record *record)
+{
+    for (unsigned i = 0; i < DD_MD_RECORD_MEMBERS; ++i)
+        dd_md_record_valid(dd, record, i);
+}
+
+/* Reads the record with a single read().
+ *
+ * The record is always initialized, so the caller can use its members even if
+ * the function fails.
+ *
+ * Returns 0 on success, -ENOENT if there is no record and other negative
+ * errno values if the record is not readable or not valid.
+ */
+static int dd_md_record_read_at(int dir_fd, const char *name, struct dd_md_record *record)
+{
+    dd_md_record_init(record);
+
+    /* The meta-data directory has the owner and the mode of the dump
+     * directory, so open() does not need the O_PATH round trip of
+     * secure_openat_read(). It neither follows links nor blocks on FIFOs and
+     * fstat() accepts only a regular file with a single link. */
+    const int fd = openat(dir_fd, name, O_RDONLY | O_NOFOLLOW | O_NONBLOCK);
+    if (fd < 0)
+        return -errno;
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || !S_ISREG(sb.st_mode) || sb.st_nlink > 1)
+    {
+        log_notice("Meta-data record '%s' isn't a regular file or has more links", name);
+        close(fd);
+        return -EINVAL;
+    }
+
+    char buf[META_DATA_RECORD_MAX_SIZE + 1];
+    const ssize_t r = safe_read(fd, buf, sizeof(buf));
+    const int err = errno;
+    close(fd);
+
+    if (r < 0)
+    {
+        log_info("Can't read meta-data record '%s': %s", name, strerror(err));
+        return -err;
+    }
+
+    if (r > META_DATA_RECORD_MAX_SIZE)
+    {
+        log_info("Meta-data record '%s' is too long", name);
+        return -EMSGSIZE;
+    }
+    buf[r] = '\0';
+
+    bool valid = false;
+    struct dd_md_record parsed;
+    dd_md_record_init(&parsed);
+
+    for (char *line = buf; *line != '\0'; )
+    {
+        char *eol = strchr(line, '\n');
+        if (eol != NULL)
+            *eol = '\0';
+
+        char *value = strchr(line, '=');
+        if (value != NULL)
+        {
+            *value++ = '\0';
+            if (strcmp(line, "version") == 0)
+                valid = strcmp(value, META_DATA_RECORD_VERSION) == 0;
+            else if (strcmp(line, "generation") == 0)
+            {
+                const long long generation = dd_md_record_number(value, LLONG_MAX);
+                parsed.generation = generation < 0 ? 0 : generation;
+            }
+            else if (prefixcmp(line, "stamp.") == 0)
+            {
+                const int member = dd_md_record_member(line + strlen("stamp."));
+                if (member >= 0)
+                    dd_md_stamp_parse(value, &parsed.stamps[member]);
+            }
+            else
+                dd_md_record_set(&parsed, line, value);
+        }
+
+        if (eol == NULL)
+            break;
+        line = eol + 1;
+    }
+
+    if (!valid)
+    {
+        log_info("Meta-data record '%s' has unsupported format", name);
+        return -EINVAL;
+    }
+
+    *record = parsed;
+    return 0;
+}
+
+/* Reads the record from the validated meta-data directory. The members are
+ * not checked against their files, use dd_md_record_valid() before using one.
+ *
+ * The record is always initialized, see dd_md_record_read_at().
+ */
+static int dd_md_record_load(struct dump_dir *dd, struct dd_md_record *record)
+{
+    const int dd_md_fd = dd_get_meta_data_dir_fd(dd, /*no create*/0);
+    if (dd_md_fd < 0)
+    {
+        dd_md_record_init(record);
+        return dd_md_fd;
+    }
+
+    return dd_md_record_read_at(dd_md_fd, META_DATA_FILE_RECORD, record);
+}
+
 static const char *dd_check(struct dump_dir *dd)
 {
-    dd->dd_time = parse_time_file_at(dd->dd_fd, FILENAME_TIME);
+    struct dd_md_record record;
+    dd_md_record_load(dd, &record);
+
+    if (dd_md_record_valid(dd, &record, DD_MD_RECORD_TIME))
+        dd->dd_time = (time_t)record.time;
+    else
+        dd->dd_time = parse_time_file_at(dd->dd_fd, FILENAME_TIME);
     if (dd->dd_time < 0)
     {
         log_debug("Missing file: "FILENAME_TIME);
@@ -409,7 +745,10 @@ static const char *dd_check(struct dump_dir *dd)
     int load_flags = DD_LOAD_TEXT_RETURN_NULL_ON_FAILURE;
     if (g_verbose < 2) load_flags |= DD_FAIL_QUIETLY_ENOENT;
 
-    dd->dd_type = load_text_file_at(dd->dd_fd, FILENAME_TYPE, load_flags);
+    if (dd_md_record_valid(dd, &record, DD_MD_RECORD_TYPE))
+        dd->dd_type = xstrdup(record.type);
+    else
+        dd->dd_type = load_text_file_at(dd->dd_fd, FILENAME_TYPE, load_flags);
     if (!dd->dd_type || (strlen(dd->dd_type) == 0))
     {
         log_debug("Missing or empty file: "FILENAME_TYPE);
@@ -711,6 +1050,155 @@ finito:
     return ret;
 }
 
+/* Sets the member from its file. The file is stamped before it is read, so
+ * a concurrent modification makes the stamp stale rather than the value.
+ */
+static void dd_md_record_load_file(struct dd_md_record *record, int dir_fd, int member)
+{
+    const char *name = s_record_members[member];
+
+    struct dd_md_stamp stamp;
+    if (!dd_md_stamp_file(dir_fd, name, &stamp))
+    {
+        dd_md_record_unset(record, member);
+        return;
+    }
+
+    char *value = load_text_file_at(dir_fd, name,
+            DD_LOAD_TEXT_RETURN_NULL_ON_FAILURE | DD_FAIL_QUIETLY_ENOENT | DD_FAIL_QUIETLY_EACCES);
+    dd_md_record_set(record, name, value);
+    free(value);
+
+    record->stamps[member] = stamp;
+}
+
+/* Fills the record from the element files. Used when the record does not
+ * exist yet, e.g. in old dump directories.
+ */
+static void dd_md_record_load_elements(struct dump_dir *dd, int dd_md_fd, struct dd_md_record *record)
+{
+    for (unsigned i = 0; i < DD_MD_RECORD_MEMBERS; ++i)
+        dd_md_record_load_file(record, dd_md_record_member_dir_fd(dd, dd_md_fd, i), i);
+}
+
+/* Removes the record, readers will fall back to the element files. */
+static void dd_md_record_drop(struct dump_dir *dd)
+{
+    const int dd_md_fd = dd_get_meta_data_dir_fd(dd, /*no create*/0);
+    if (dd_md_fd < 0)
+        return;
+
+    if (unlinkat(dd_md_fd, META_DATA_FILE_RECORD, /*only files*/0) != 0 && errno != ENOENT)
+        perror_msg("Can't remove meta-data '%s'", META_DATA_FILE_RECORD);
+}
+
+/* Must be called by all writers after they modified one of the elements
+ * mirrored in the record.
+ *
+ * Pass NULL as data if the element was deleted or if its value is not known
+ * (e.g. the element was written through a file descriptor). The corresponding
+ * member is then omitted and readers use the element file.
+ *
+ * If the record cannot be written, it is removed so that it never contains
+ * stale values.
+ */
+static void dd_md_record_update(struct dump_dir *dd, const char *name, const char *data)
+{
+    if (!dd_md_record_is_tracked(name))
+        return;
+
+    if (!dd->locked)
+    {
+        dd_md_record_drop(dd);
+        return;
+    }
+
+    const int dd_md_fd = dd_get_meta_data_dir_fd(dd, DD_MD_GET_CREATE);
+    if (dd_md_fd < 0)
+        return;
+
+    struct dd_md_record record;
+    if (dd_md_record_read_at(dd_md_fd, META_DATA_FILE_RECORD, &record) < 0)
+        dd_md_record_load_elements(dd, dd_md_fd, &record);
+    else
+        dd_md_record_validate(dd, &record);
+
+    const int member = dd_md_record_member(name);
+    dd_md_record_set(&record, name, data);
+    if (data == NULL
+        || !dd_md_stamp_file(dd_md_record_member_dir_fd(dd, dd_md_fd, member), name, &record.stamps[member]))
+        dd_md_record_unset(&record, member);
+
+    struct strbuf *buf = strbuf_new();
+    strbuf_append_strf(buf, "version="META_DATA_RECORD_VERSION"\n"
+                            "generation=%llu\n", record.generation + 1);
+    if (record.time >= 0)
+        strbuf_append_strf(buf, FILENAME_TIME"=%lld\n", record.time);
+    if (record.last_occurrence >= 0)
+        strbuf_append_strf(buf, FILENAME_LAST_OCCURRENCE"=%lld\n", record.last_occurrence);
+    if (record.count >= 0)
+        strbuf_append_strf(buf, FILENAME_COUNT"=%lld\n", record.count);
+    if (record.owner >= 0)
+        strbuf_append_strf(buf, META_DATA_FILE_OWNER"=%lld\n", record.owner);
+    if (record.type[0] != '\0')
+        strbuf_append_strf(buf, FILENAME_TYPE"=%s\n", record.type);
+
+    for (unsigned i = 0; i < DD_MD_RECORD_MEMBERS; ++i)
+    {
+        const struct dd_md_stamp *stamp = record.stamps + i;
+        if (dd_md_record_has(&record, i) && stamp->valid)
+            strbuf_append_strf(buf, "stamp.%s=%llu %llu %lld.%09lld\n", s_record_members[i],
+                               stamp->ino, stamp->size, stamp->ctime_sec, stamp->ctime_nsec);
+    }
+
+    if (dd_meta_data_save_text(dd, META_DATA_FILE_RECORD, buf->buf) < 0)
+        dd_md_record_drop(dd);
+
+    strbuf_free(buf);
+}
+
+unsigned long long dd_get_meta_data_generation(struct dump_dir *dd)
+{
+    struct dd_md_record record;
+    dd_md_record_load(dd, &record);
+    return record.generation;
+}
+
+int dd_save_cached_text(struct dump_dir *dd, const char *name, const char *data)
+{
+    if (!str_is_correct_filename(name))
+    {
+        error_msg("Cannot save cached data. '%s' is not a valid file name", name);
+        return -EINVAL;
+    }
+
+    char *md_name = xasprintf(META_DATA_CACHE_PREFIX"%s", name);
+    const int ret = dd_meta_data_save_text(dd, md_name, data);
+    free(md_name);
+    return ret;
+}
+
+char *dd_load_cached_text(struct dump_dir *dd, const char *name)
+{
+    if (!str_is_correct_filename(name))
+        return NULL;
+
+    const int dd_md_fd = dd_get_meta_data_dir_fd(dd, /*no create*/0);
+    if (dd_md_fd < 0)
+        return NULL;
+
+    char *md_name = xasprintf(META_DATA_CACHE_PREFIX"%s", name);
+    const int fd = secure_openat_read(dd_md_fd, md_name);
+    free(md_name);
+    if (fd < 0)
+        return NULL;
+
+    /* Unlike elements, cached data is returned exactly as it was saved */
+    char *data = xmalloc_read(fd, NULL);
+    close(fd);
+    return data;
+}
+
 int dd_set_owner(struct dump_dir *dd, uid_t owner)
 {
     /* I was tempted to use the keyword static, but we should have reentracy
@@ -724,6 +1212,7 @@ int dd_set_owner(struct dump_dir *dd, uid_t owner)
     const int ret = dd_meta_data_save_text(dd, META_DATA_FILE_OWNER, long_str);
     if (ret < 0)
         error_msg("The dump dir owner wasn't set to '%s'", long_str);
+    dd_md_record_update(dd, META_DATA_FILE_OWNER, ret < 0 ? NULL : long_str);
     return ret;
 }
 
@@ -748,6 +1237,11 @@ uid_t dd_get_owner(struct dump_dir *dd)
         return dd->dd_uid;
     }
 
+    struct dd_md_record record;
+    if (dd_md_record_load(dd, &record) == 0
+        && dd_md_record_valid(dd, &record, DD_MD_RECORD_OWNER))
+        return (uid_t)record.owner;
+
     unsigned long long owner = 0;
 
     int ret = read_number_from_file_at(dd_md_fd, META_DATA_FILE_OWNER, "UID",
@@ -785,7 +1279,12 @@ time_t dd_get_last_occurrence(struct dump_dir *dd)
     /* Do not touch errno in case of errors, because this function claims
      * to set errno only to ENODATA */
     const int old_errno = errno;
-    time_t last_occurrence = parse_time_file_at(dd->dd_fd, FILENAME_LAST_OCCURRENCE);
+    struct dd_md_record record;
+    dd_md_record_load(dd, &record);
+
+    time_t last_occurrence = (time_t)record.last_occurrence;
+    if (!dd_md_record_valid(dd, &record, DD_MD_RECORD_LAST_OCCURRENCE))
+        last_occurrence = parse_time_file_at(dd->dd_fd, FILENAME_LAST_OCCURRENCE);
 
     if (last_occurrence < first_occurrence)
     {
@@ -1895,7 +2394,8 @@ void dd_save_text(struct dump_dir *dd, const char *name, const char *data)
     if (!dd_validate_element_name(name))
         error_msg_and_die("Cannot save text. '%s' is not a valid file name", name);
 
-    save_binary_file_at(dd->dd_fd, name, data, strlen(data), dd->dd_uid, dd->dd_gid, dd->mode);
+    const bool saved = save_binary_file_at(dd->dd_fd, name, data, strlen(data), dd->dd_uid, dd->dd_gid, dd->mode);
+    dd_md_record_update(dd, name, saved ? data : NULL);
 }
 
 void dd_save_binary(struct dump_dir* dd, const char* name, const char* data, unsigned size)
@@ -1906,7 +2406,13 @@ void dd_save_binary(struct dump_dir* dd, const char* name, const char* data, uns
     if (!dd_validate_element_name(name))
         error_msg_and_die("Cannot save binary. '%s' is not a valid file name", name);
 
-    save_binary_file_at(dd->dd_fd, name, data, size, dd->dd_uid, dd->dd_gid, dd->mode);
+    const bool saved = save_binary_file_at(dd->dd_fd, name, data, size, dd->dd_uid, dd->dd_gid, dd->mode);
+    if (dd_md_record_is_tracked(name))
+    {
+        char *text = saved ? xstrndup(data, size) : NULL;
+        dd_md_record_update(dd, name, text);
+        free(text);
+    }
 }
 
 int dd_item_stat(struct dump_dir *dd, const char *name, struct stat *statbuf)
@@ -1970,6 +2476,8 @@ int dd_delete_item(struct dump_dir *dd, const char *name)
             perror_msg("Can't delete file '%s'", name);
     }
 
+    dd_md_record_update(dd, name, NULL);
+
     return res;
 }
 
@@ -1988,12 +2496,64 @@ int dd_open_item(struct dump_dir *dd, const char *name, int flag)
         error_msg_and_die("dump_dir is not locked"); /* bug */
 
     if (flag == O_RDWR)
+    {
+        /* The new value is unknown, let readers use the element file */
+        dd_md_record_update(dd, name, NULL);
         return create_new_file_at(dd->dd_fd, O_RDWR, name, dd->dd_uid, dd->dd_gid, dd->mode);
+    }
 
     error_msg("invalid open item flag");
     return -ENOTSUP;
 }
 
+void *dd_map_item(struct dump_dir *dd, const char *name, size_t *size)
+{
+    if (!dd_validate_element_name(name))
+    {
+        error_msg("Cannot map item. '%s' is not a valid file name", name);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    const int fd = secure_openat_read(dd->dd_fd, name);
+    if (fd < 0)
+    {
+        errno = -fd;
+        return NULL;
+    }
+
+    void *data = mmap_fd_read(fd, size);
+    const int err = errno;
+    /* The mapping stays valid after the descriptor is closed */
+    close(fd);
+    errno = err;
+
+    return data;
+}
+
+void dd_unmap_item(void *data, size_t size)
+{
+    munmap_fd_read(data, size);
+}
+
+int dd_hash_item(struct dump_dir *dd, const char *name, int algorithm, uint8_t *result)
+{
+    if (!dd_validate_element_name(name))
+    {
+        error_msg("Cannot hash item. '%s' is not a valid file name", name);
+        return -EINVAL;
+    }
+
+    const int fd = secure_openat_read(dd->dd_fd, name);
+    if (fd < 0)
+        return fd;
+
+    const int r = hash_fd(fd, algorithm == DD_HASH_SHA256 ? HASH_SHA256 : HASH_SHA1, result);
+    close(fd);
+
+    return r;
+}
+
 FILE *dd_open_item_file(struct dump_dir *dd, const char *name, int flag)
 {
     const int item_fd = dd_open_item(dd, name, flag);
@@ -2352,6 +2912,7 @@ int dd_copy_file(struct dump_dir *dd, const char *name, const char *source_path)
     log_debug("copying '%s' to '%s' at '%s'", source_path, name, dd->dd_dirname);
 
     unlinkat(dd->dd_fd, name, /*remove only files*/0);
+    dd_md_record_update(dd, name, NULL);
     off_t copied = copy_file_ext_at(source_path, dd->dd_fd, name, DEFAULT_DUMP_DIR_MODE,
             dd->dd_uid, dd->dd_gid, O_RDONLY, O_WRONLY | O_TRUNC | O_EXCL | O_CREAT);
 
@@ -2371,6 +2932,7 @@ int dd_copy_file_at(struct dump_dir *dd, const char *name, int src_dir_fd, const
     log_debug("copying file '%s' to element '%s' at '%s'", src_name, name, dd->dd_dirname);
 
     unlinkat(dd->dd_fd, name, /*remove only files*/0);
+    dd_md_record_update(dd, name, NULL);
     off_t copied = copy_file_ext_2at(src_dir_fd, src_name, dd->dd_fd, name,
             DEFAULT_DUMP_DIR_MODE,
             dd->dd_uid, dd->dd_gid,
@@ -2393,6 +2955,7 @@ int dd_copy_file_unpack(struct dump_dir *dd, const char *name, const char *sourc
     log_debug("unpacking '%s' to '%s' at '%s'", source_path, name, dd->dd_dirname);
 
     unlinkat(dd->dd_fd, name, /*remove only files*/0);
+    dd_md_record_update(dd, name, NULL);
     off_t copied = decompress_file_ext_at(source_path, dd->dd_fd, name, DEFAULT_DUMP_DIR_MODE,
             dd->dd_uid, dd->dd_gid, O_RDONLY, O_WRONLY | O_TRUNC | O_EXCL | O_CREAT);
 
@@ -2529,6 +3092,7 @@ off_t dd_copy_fd(struct dump_dir *dd, const char *name, int fd, int copy_flags,
     log_debug("Saving data from file descriptor %d to '%s' at '%s'", fd, name, dd->dd_dirname);
 
     unlinkat(dd->dd_fd, name, /*remove only files*/0);
+    dd_md_record_update(dd, name, NULL);
     off_t read = copyfd_ext_at(fd, dd->dd_fd, name, DEFAULT_DUMP_DIR_MODE,
             dd->dd_uid, dd->dd_gid, O_WRONLY | O_CREAT | O_EXCL, copy_flags, maxsize);
 
@@ -21,6 +21,21 @@
 
 GHashTable *g_event_config_list;
 static GHashTable *g_event_config_symlinks;
+/* All definitions have been loaded by load_event_config_data(), otherwise
+ * g_event_config_list holds only the definitions loaded on demand */
+static bool g_event_config_list_complete;
+/* Definitions removed by reload_event_config(), callers might still hold
+ * pointers to them */
+static GList *g_removed_event_configs;
+
+struct event_options
+{
+    /* event_option_t in the order of definition */
+    GList *list;
+    GList *tail;
+    /* eo_name -> link of list */
+    GHashTable *links;
+};
 
 invalid_option_t *new_invalid_option(void)
 {
@@ -81,7 +96,52 @@ void ec_set_long_desc(event_config_t *ec, const char *long_descr)
 
 bool ec_is_configurable(event_config_t* ec)
 {
-    return g_list_length(ec->options) > 0;
+    return ec_get_options(ec) != NULL;
+}
+
+GList *ec_get_options(event_config_t *ec)
+{
+    return ec->ec_options ? ec->ec_options->list : NULL;
+}
+
+event_option_t *ec_get_option(event_config_t *ec, const char *name)
+{
+    if (ec->ec_options == NULL)
+        return NULL;
+
+    GList *elem = g_hash_table_lookup(ec->ec_options->links, name);
+    return elem ? elem->data : NULL;
+}
+
+event_option_t *ec_set_option(event_config_t *ec, event_option_t *opt)
+{
+    struct event_options *options = ec->ec_options;
+    if (options == NULL)
+    {
+        options = ec->ec_options = xzalloc(sizeof(*options));
+        options->links = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+
+    GList *elem = g_hash_table_lookup(options->links, opt->eo_name);
+    if (elem)
+    {
+        event_option_t *old_opt = elem->data;
+        elem->data = opt;
+        /* The key is owned by the option */
+        g_hash_table_replace(options->links, opt->eo_name, elem);
+        return old_opt;
+    }
+
+    /* g_list_append() would walk the whole list */
+    elem = g_list_append(NULL, opt);
+    if (options->tail)
+        g_list_concat(options->tail, elem);
+    else
+        options->list = elem;
+    options->tail = elem;
+
+    g_hash_table_insert(options->links, opt->eo_name, elem);
+    return NULL;
 }
 
 void ec_print(event_config_t *ec)
@@ -109,7 +169,7 @@ bool ec_restricted_access_enabled(event_config_t *ec)
         return false;
     }
 
-    event_option_t *eo = get_event_option_from_list(ec->ec_restricted_access_option, ec->options);
+    event_option_t *eo = ec_get_option(ec, ec->ec_restricted_access_option);
     if (eo == NULL)
     {
         log_warning("Event '%s' supports restricted access but the option is not defined", ec_get_name(ec));
@@ -161,7 +221,12 @@ void free_event_config(event_config_t *p)
     free(p->ec_exclude_items_always);
     free(p->ec_restricted_access_option);
     g_list_free_full(p->ec_imported_event_names, free);
-    g_list_free_full(p->options, (GDestroyNotify)free_event_option);
+    if (p->ec_options)
+    {
+        g_hash_table_destroy(p->ec_options->links);
+        g_list_free_full(p->ec_options->list, (GDestroyNotify)free_event_option);
+        free(p->ec_options);
+    }
 
     free(p);
 }
@@ -181,87 +246,210 @@ event_option_t *get_event_option_from_list(const char *name, GList *options)
     return NULL;
 }
 
+static event_config_t *lookup_event_config(const char *name)
+{
+    if (!g_event_config_list)
+        return NULL;
+    if (g_event_config_symlinks)
+    {
+        char *link = g_hash_table_lookup(g_event_config_symlinks, name);
+        if (link)
+            name = link;
+    }
+    return g_hash_table_lookup(g_event_config_list, name);
+}
+
+static void init_event_config_data(void)
+{
+    if (!g_event_config_list)
+        g_event_config_list = g_hash_table_new_full(
+                /*hash_func*/ g_str_hash,
+                /*key_equal_func:*/ g_str_equal,
+                /*key_destroy_func:*/ free,
+                /*value_destroy_func:*/ (GDestroyNotify) free_event_config
+        );
+    if (!g_event_config_symlinks)
+        g_event_config_symlinks = g_hash_table_new_full(
+                /*hash_func*/ g_str_hash,
+                /*key_equal_func:*/ g_str_equal,
+                /*key_destroy_func:*/ free,
+                /*value_destroy_func:*/ free
+        );
+}
+
+/* Loads option values of the event from its conf file */
+static void load_event_config_values(event_config_t *event_config, const char *fullpath)
+{
+    map_string_t *keys_and_values = new_map_string();
+
+    load_conf_file(fullpath, keys_and_values, /*skipKeysWithoutValue:*/ false);
+
+    /* Insert or replace every key/value from keys_and_values to event_config->option */
+    map_string_iter_t iter;
+    const char *name;
+    const char *value;
+    init_map_string_iter(&iter, keys_and_values);
+    while (next_map_string_iter(&iter, &name, &value))
+    {
+        event_option_t *opt = ec_get_option(event_config, name);
+        if (opt)
+        {
+            // log_warning("conf: replacing '%s' value:'%s'->'%s'", name, opt->value, value);
+            free(opt->eo_value);
+            opt->eo_value = xstrdup(value);
+        }
+        else
+        {
+            // log_warning("conf: new value %s='%s'", name, value);
+            opt = new_event_option();
+            opt->eo_name = xstrdup(name);
+            opt->eo_value = xstrdup(value);
+            ec_set_option(event_config, opt);
+        }
+    }
+
+    free_map_string(keys_and_values);
+}
+
 static void load_config_files(const char *dir_path)
 {
     GList *conf_files = get_file_list(dir_path, "conf");
     while (conf_files != NULL)
     {
         file_obj_t *file = (file_obj_t *)conf_files->data;
-        char *fullpath = file->fullpath;
-        char *filename = file->filename;
 
-        event_config_t *event_config = get_event_config(filename);
+        event_config_t *event_config = lookup_event_config(file->filename);
         bool new_config = (!event_config);
         if (new_config)
-            event_config = new_event_config(filename);
+            event_config = new_event_config(file->filename);
+
+        load_event_config_values(event_config, file->fullpath);
+
+        if (new_config)
+            g_hash_table_replace(g_event_config_list, xstrdup(ec_get_name(event_config)), event_config);
+
+        free_file_obj(file);
+        conf_files = g_list_delete_link(conf_files, conf_files);
+    }
+}
+
+static char *get_user_event_config_dir(void)
+{
+    return concat_path_file(g_get_user_cache_dir(), "abrt/events");
+}
+
+/* The tests use their own event definitions */
+static const char *get_events_dir(void)
+{
+    const char *events_dir = getenv("LIBREPORT_DEBUG_EVENTS_DIR");
+    return events_dir ? events_dir : EVENTS_DIR;
+}
+
+static const char *get_events_conf_dir(void)
+{
+    const char *events_conf_dir = getenv("LIBREPORT_DEBUG_EVENTS_CONF_DIR");
+    return events_conf_dir ? events_conf_dir : EVENTS_CONF_DIR;
+}
+
+/* Reads the definition of one event from the same files as
+ * load_event_config_data() does, the directories are not listed at all */
+static event_config_t *read_event_config(const char *name)
+{
+    if (!str_is_correct_filename(name))
+        return NULL;
 
-        map_string_t *keys_and_values = new_map_string();
+    event_config_t *event_config = NULL;
 
-        load_conf_file(fullpath, keys_and_values, /*skipKeysWithoutValue:*/ false);
+    char *path = xasprintf("%s/%s.xml", get_events_dir(), name);
+    if (access(path, F_OK) == 0)
+    {
+        event_config = new_event_config(name);
+        load_event_description_from_file(event_config, path);
+    }
+    free(path);
 
-        /* Insert or replace every key/value from keys_and_values to event_config->option */
-        map_string_iter_t iter;
-        const char *name;
-        const char *value;
-        init_map_string_iter(&iter, keys_and_values);
-        while (next_map_string_iter(&iter, &name, &value))
+    char *user_dir = get_user_event_config_dir();
+    const char *const conf_dirs[] = { get_events_conf_dir(), user_dir, NULL };
+    for (const char *const *dir = conf_dirs; *dir; ++dir)
+    {
+        path = xasprintf("%s/%s.conf", *dir, name);
+        if (access(path, F_OK) == 0)
         {
-            event_option_t *opt;
-            GList *elem = g_list_find_custom(event_config->options, name,
-                                            cmp_event_option_name_with_string);
-            if (elem)
-            {
-                opt = elem->data;
-                // log_warning("conf: replacing '%s' value:'%s'->'%s'", name, opt->value, value);
-                free(opt->eo_value);
-            }
-            else
-            {
-                // log_warning("conf: new value %s='%s'", name, value);
-                opt = new_event_option();
-                opt->eo_name = xstrdup(name);
-            }
-            opt->eo_value = xstrdup(value);
-            if (!elem)
-                event_config->options = g_list_append(event_config->options, opt);
+            if (!event_config)
+                event_config = new_event_config(name);
+            load_event_config_values(event_config, path);
         }
+        free(path);
+    }
+    free(user_dir);
 
-        free_map_string(keys_and_values);
+    return event_config;
+}
 
-        if (new_config)
-            g_hash_table_replace(g_event_config_list, xstrdup(ec_get_name(event_config)), event_config);
+static event_config_t *load_one_event_config(const char *name)
+{
+    event_config_t *event_config = read_event_config(name);
+    if (event_config)
+    {
+        log_debug("Loaded definition of event '%s'", name);
+        init_event_config_data();
+        g_hash_table_replace(g_event_config_list, xstrdup(name), event_config);
+    }
 
-        free_file_obj(file);
-        conf_files = g_list_delete_link(conf_files, conf_files);
+    return event_config;
+}
+
+bool reload_event_config(const char *name)
+{
+    event_config_t *event_config = lookup_event_config(name);
+    /* Not loaded yet, get_event_config() will read the current files */
+    if (!event_config && !g_event_config_list_complete)
+        return false;
+
+    event_config_t *reloaded = read_event_config(name);
+    if (!reloaded)
+    {
+        if (!event_config)
+            return false;
+
+        log_info("Event '%s' has been removed", name);
+        /* Keep the definition alive, callers might still hold it */
+        gpointer key = NULL;
+        g_hash_table_lookup_extended(g_event_config_list, ec_get_name(event_config), &key, NULL);
+        g_hash_table_steal(g_event_config_list, key);
+        free(key);
+        g_removed_event_configs = g_list_prepend(g_removed_event_configs, event_config);
+        return true;
     }
+
+    log_info("Reloaded definition of event '%s'", name);
+    if (!event_config)
+    {
+        g_hash_table_replace(g_event_config_list, xstrdup(name), reloaded);
+        return true;
+    }
+
+    /* Swap the contents, so pointers to the event stay valid */
+    event_config_t old = *event_config;
+    *event_config = *reloaded;
+    *reloaded = old;
+    free_event_config(reloaded);
+
+    return true;
 }
 
 /* (Re)loads data from /etc/abrt/events/foo.{xml,conf} and $XDG_CACHE_HOME/abrt/events/foo.conf */
 GHashTable *load_event_config_data(void)
 {
     free_event_config_data();
+    init_event_config_data();
 
-    if (!g_event_config_list)
-        g_event_config_list = g_hash_table_new_full(
-                /*hash_func*/ g_str_hash,
-                /*key_equal_func:*/ g_str_equal,
-                /*key_destroy_func:*/ free,
-                /*value_destroy_func:*/ (GDestroyNotify) free_event_config
-        );
-    if (!g_event_config_symlinks)
-        g_event_config_symlinks = g_hash_table_new_full(
-                /*hash_func*/ g_str_hash,
-                /*key_equal_func:*/ g_str_equal,
-                /*key_destroy_func:*/ free,
-                /*value_destroy_func:*/ free
-        );
-
-    GList *event_files = get_file_list(EVENTS_DIR, "xml");
+    GList *event_files = get_file_list(get_events_dir(), "xml");
     while (event_files)
     {
         file_obj_t *file = (file_obj_t *)event_files->data;
 
-        event_config_t *event_config = get_event_config(file->filename);
+        event_config_t *event_config = lookup_event_config(file->filename);
         bool new_config = (!event_config);
         if (new_config)
            event_config = new_event_config(file->filename);
@@ -283,13 +471,13 @@ GHashTable *load_event_config_data(void)
      *
      * https://fedorahosted.org/abrt/wiki/AbrtConfiguration#Adjustingpluginconfiguration
      */
-    load_config_files(EVENTS_CONF_DIR);
+    load_config_files(get_events_conf_dir());
 
-    char *cachedir;
-    cachedir = concat_path_file(g_get_user_cache_dir(), "abrt/events");
+    char *cachedir = get_user_event_config_dir();
     load_config_files(cachedir);
     free(cachedir);
 
+    g_event_config_list_complete = true;
     return g_event_config_list;
 }
 
@@ -306,66 +494,62 @@ void free_event_config_data(void)
         g_hash_table_destroy(g_event_config_symlinks);
         g_event_config_symlinks = NULL;
     }
+    g_list_free_full(g_removed_event_configs, (GDestroyNotify)free_event_config);
+    g_removed_event_configs = NULL;
+    g_event_config_list_complete = false;
 }
 
 event_config_t *get_event_config(const char *name)
 {
-    if (!g_event_config_list)
-        return NULL;
-    if (g_event_config_symlinks)
-    {
-        char *link = g_hash_table_lookup(g_event_config_symlinks, name);
-        if (link)
-            name = link;
-    }
-    return g_hash_table_lookup(g_event_config_list, name);
+    event_config_t *event_config = lookup_event_config(name);
+    if (!event_config && !g_event_config_list_complete)
+        event_config = load_one_event_config(name);
+
+    return event_config;
 }
 
-GList *export_event_config(const char *event_name)
+/* The exported names are kept in a hash table as well, so the list is not
+ * searched for every option */
+static void export_event_config_names(const char *event_name, GList **env_list, GHashTable *exported)
 {
-    GList *env_list = NULL;
-
     event_config_t *config = get_event_config(event_name);
-    if (config)
-    {
-        GList *imported = config->ec_imported_event_names;
-        while (imported)
-        {
-            GList *exported = export_event_config(/*Event name*/imported->data);
-            while (exported)
-            {
-                if (!g_list_find_custom(env_list, exported->data, (GCompareFunc)strcmp))
-                    /* It is not necessary to make a copy of opt->eo_name */
-                    /* since its memory is owned by event_option_t and it */
-                    /* has global scope */
-                    env_list = g_list_prepend(env_list, exported->data);
-
-                exported = g_list_remove_link(exported, exported);
-            }
-
-            imported = g_list_next(imported);
-        }
+    if (!config)
+        return;
 
-        GList *lopt;
-        for (lopt = config->options; lopt; lopt = lopt->next)
-        {
-            event_option_t *opt = lopt->data;
-            if (!opt->eo_value)
-                continue;
+    for (GList *imported = config->ec_imported_event_names; imported; imported = g_list_next(imported))
+        export_event_config_names(/*Event name*/imported->data, env_list, exported);
 
-            log_debug("Exporting '%s=%s'", opt->eo_name, opt->eo_value);
+    GList *lopt;
+    for (lopt = ec_get_options(config); lopt; lopt = lopt->next)
+    {
+        event_option_t *opt = lopt->data;
+        if (!opt->eo_value)
+            continue;
 
-            /* Add the exported key only if it is not in the list */
-            if (!g_list_find_custom(env_list, opt->eo_name, (GCompareFunc)strcmp))
-                /* It is not necessary to make a copy of opt->eo_name */
-                /* since its memory is owned by opt and it has global scope */
-                env_list = g_list_prepend(env_list, opt->eo_name);
+        log_debug("Exporting '%s=%s'", opt->eo_name, opt->eo_value);
 
-            /* setenv() makes copies of strings */
-            xsetenv(opt->eo_name, opt->eo_value);
+        /* Add the exported key only if it is not in the list */
+        if (!g_hash_table_contains(exported, opt->eo_name))
+        {
+            /* It is not necessary to make a copy of opt->eo_name */
+            /* since its memory is owned by opt and it has global scope */
+            g_hash_table_add(exported, opt->eo_name);
+            *env_list = g_list_prepend(*env_list, opt->eo_name);
         }
+
+        /* setenv() makes copies of strings */
+        xsetenv(opt->eo_name, opt->eo_value);
     }
+}
+
+GList *export_event_config(const char *event_name)
+{
+    GList *env_list = NULL;
+    GHashTable *exported = g_hash_table_new(g_str_hash, g_str_equal);
+
+    export_event_config_names(event_name, &env_list, exported);
 
+    g_hash_table_destroy(exported);
     return env_list;
 }
 
@@ -451,7 +635,7 @@ GList *get_options_with_err_msg(const char *event_name)
 
     GList *iter, *err_list = NULL;
 
-    for (iter = config->options; iter; iter = iter->next)
+    for (iter = ec_get_options(config); iter; iter = iter->next)
     {
         event_option_t *opt = (event_option_t *)iter->data;
         char *err = validate_event_option(opt);
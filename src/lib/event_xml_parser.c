@@ -18,6 +18,7 @@
 */
 #include "event_config.h"
 #include "internal_libreport.h"
+#include "definition_cache.h"
 
 #define EVENT_ELEMENT           "event"
 #define LABEL_ELEMENT           "label"
@@ -117,13 +118,6 @@ static char *get_element_lang(struct my_parse_data *parse_data, const gchar **at
     return NULL;
 }
 
-static int cmp_event_option_name_with_string(gconstpointer a, gconstpointer b)
-{
-    const event_option_t *evopt = a;
-    /* "When it is not a match?" */
-    return !evopt->eo_name || strcmp(evopt->eo_name, (char *)b) != 0;
-}
-
 static void consume_cur_option(struct my_parse_data *parse_data)
 {
     event_option_t *opt = parse_data->cur_option.values;
@@ -138,13 +132,12 @@ static void consume_cur_option(struct my_parse_data *parse_data)
      * (strcmp would segfault, etc), so provide invented name:
      */
     if (!opt->eo_name)
-        opt->eo_name = xasprintf("%u", (unsigned)g_list_length(event_config->values->options));
+        opt->eo_name = xasprintf("%u", (unsigned)g_list_length(ec_get_options(event_config->values)));
 
-    GList *elem = g_list_find_custom(event_config->values->options, opt->eo_name, cmp_event_option_name_with_string);
-    if (elem)
+    event_option_t *old_opt = ec_set_option(event_config->values, opt);
+    if (old_opt)
     {
-        /* we already have option with such name */
-        event_option_t *old_opt = elem->data;
+        /* we already had option with such name */
         if (old_opt->eo_value)
         {
             /* ...and it already has a value, which
@@ -156,12 +149,6 @@ static void consume_cur_option(struct my_parse_data *parse_data)
         }
         //log_warning("xml: replacing '%s' value:'%s'->'%s'", opt->eo_name, old_opt->eo_value, opt->eo_value);
         free_event_option(old_opt);
-        elem->data = opt;
-    }
-    else
-    {
-        //log_warning("xml: new value %s='%s'", opt->eo_name, opt->eo_value);
-        event_config->values->options = g_list_append(event_config->values->options, opt);
     }
 }
 
@@ -540,19 +527,12 @@ static void error(GMarkupParseContext *context,
     error_msg("error in XML parsing");
 }
 
-/* this function takes 2 parameters
- * ui -> pointer to event_config_t
- * filename -> filename to read
- * event_config_t contains list of options, which is malloced by hits function
- * and must be freed by the caller
- */
-
-void load_event_description_from_file(event_config_t *event_config, const char* filename)
+void parse_event_description_file(event_config_t *event_config, const char *filename,
+                                  const char *locale)
 {
     log_info("loading event: '%s'", filename);
     struct my_parse_data parse_data = { {event_config, false, false, false}, {NULL, false, false}, NULL, NULL };
-    parse_data.cur_locale = xstrdup(setlocale(LC_ALL, NULL));
-    strchrnul(parse_data.cur_locale, '.')[0] = '\0';
+    parse_data.cur_locale = xstrdup(locale);
 
     GMarkupParser parser;
     memset(&parser, 0, sizeof(parser)); /* just in case */
@@ -584,3 +564,18 @@ void load_event_description_from_file(event_config_t *event_config, const char*
     free(parse_data.attribute_lang); /* just in case */
     free(parse_data.cur_locale);
 }
+
+/* this function takes 2 parameters
+ * ui -> pointer to event_config_t
+ * filename -> filename to read
+ * event_config_t contains list of options, which is malloced by hits function
+ * and must be freed by the caller
+ */
+
+void load_event_description_from_file(event_config_t *event_config, const char* filename)
+{
+    char *locale = definition_cache_locale();
+    if (!definition_cache_load_event(event_config, filename, locale))
+        parse_event_description_file(event_config, filename, locale);
+    free(locale);
+}
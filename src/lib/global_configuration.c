@@ -31,54 +31,63 @@ static const char *const s_recognized_options[] = {
 
 static map_string_t *s_global_settings;
 
+static const char *s_default_dirs[] = {
+    CONF_DIR,
+    NULL,
+    NULL,
+};
+
+static int s_default_dir_flags[] = {
+    CONF_DIR_FLAG_NONE,
+    CONF_DIR_FLAG_OPTIONAL,
+    -1,
+};
+
 bool load_global_configuration(void)
 {
-    static const char *dirs[] = {
-        CONF_DIR,
-        NULL,
-        NULL,
-    };
-
-    static int dir_flags[] = {
-        CONF_DIR_FLAG_NONE,
-        CONF_DIR_FLAG_OPTIONAL,
-        -1,
-    };
-
-    if (dirs[1] == NULL)
-        dirs[1] = get_user_conf_base_dir();
-
-    return load_global_configuration_from_dirs(dirs, dir_flags);
+    if (s_default_dirs[1] == NULL)
+        s_default_dirs[1] = get_user_conf_base_dir();
+
+    return load_global_configuration_from_dirs(s_default_dirs, s_default_dir_flags);
 }
 
-bool load_global_configuration_from_dirs(const char *dirs[], int dir_flags[])
+static map_string_t *load_global_settings(const char *dirs[], int dir_flags[])
 {
-    if (s_global_settings == NULL)
+    map_string_t *settings = new_map_string();
+
+    bool ret = load_conf_file_from_dirs_ext("libreport.conf", dirs, dir_flags, settings,
+                                           /*don't skip without value*/ false);
+    if (!ret)
     {
-        s_global_settings = new_map_string();
+        error_msg("Failed to load libreport global configuration");
+        free_map_string(settings);
+        return NULL;
+    }
 
-        bool ret = load_conf_file_from_dirs_ext("libreport.conf", dirs, dir_flags, s_global_settings,
-                                               /*don't skip without value*/ false);
-        if (!ret)
+    map_string_iter_t iter;
+    init_map_string_iter(&iter, settings);
+    const char *key, *value;
+    while(next_map_string_iter(&iter, &key, &value))
+    {
+        /* Die to avoid security leaks in case where someone made a typo in a option name */
+        if (!is_in_string_list(key, s_recognized_options))
         {
-            error_msg("Failed to load libreport global configuration");
-            free_global_configuration();
-            return false;
+            error_msg("libreport global configuration contains unrecognized option : '%s'", key);
+            free_map_string(settings);
+            return NULL;
         }
+    }
 
-        map_string_iter_t iter;
-        init_map_string_iter(&iter, s_global_settings);
-        const char *key, *value;
-        while(next_map_string_iter(&iter, &key, &value))
-        {
-            /* Die to avoid security leaks in case where someone made a typo in a option name */
-            if (!is_in_string_list(key, s_recognized_options))
-            {
-                error_msg("libreport global configuration contains unrecognized option : '%s'", key);
-                free_global_configuration();
-                return false;
-            }
-        }
+    return settings;
+}
+
+bool load_global_configuration_from_dirs(const char *dirs[], int dir_flags[])
+{
+    if (s_global_settings == NULL)
+    {
+        s_global_settings = load_global_settings(dirs, dir_flags);
+        if (s_global_settings == NULL)
+            return false;
     }
     else
         log_notice("libreport global configuration already loaded");
@@ -86,6 +95,28 @@ bool load_global_configuration_from_dirs(const char *dirs[], int dir_flags[])
     return true;
 }
 
+bool reload_global_configuration(void)
+{
+    if (s_global_settings == NULL)
+        return false;
+
+    if (s_default_dirs[1] == NULL)
+        s_default_dirs[1] = get_user_conf_base_dir();
+
+    /* The previous configuration is better than none */
+    map_string_t *settings = load_global_settings(s_default_dirs, s_default_dir_flags);
+    if (settings == NULL)
+    {
+        error_msg("Keeping the previous libreport global configuration");
+        return false;
+    }
+
+    free_map_string(s_global_settings);
+    s_global_settings = settings;
+    log_info("Reloaded libreport global configuration");
+    return true;
+}
+
 void free_global_configuration(void)
 {
     if (s_global_settings != NULL)
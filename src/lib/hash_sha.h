@@ -0,0 +1,49 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#ifndef HASH_SHA_H_
+#define HASH_SHA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Processes 'blocks' 64-byte blocks of 'data' and updates the host endian
+ * 'hash' state words (5 for SHA-1, 8 for SHA-256).
+ */
+typedef void (*sha_blocks_fn)(uint32_t *hash, const uint8_t *data, size_t blocks);
+
+/* Portable implementations (hash_sha1.c) */
+void sha1_blocks_generic(uint32_t *hash, const uint8_t *data, size_t blocks);
+void sha256_blocks_generic(uint32_t *hash, const uint8_t *data, size_t blocks);
+const uint32_t *sha256_round_constants(void);
+
+/* Returns the fastest implementation the CPU supports (hash_sha_hw.c)
+ *
+ * @param algorithm HASH_SHA1 or HASH_SHA256
+ */
+sha_blocks_fn sha_get_blocks_fn(int algorithm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -34,6 +34,7 @@
  */
 #include <byteswap.h>
 #include "internal_libreport.h"
+#include "hash_sha.h"
 
 #if defined(__BIG_ENDIAN__) && __BIG_ENDIAN__
 # define SHA1_BIG_ENDIAN 1
@@ -56,13 +57,18 @@
 
 
 /* Generic 64-byte helpers for 64-byte block hashes */
-static void common64_hash(sha1_ctx_t *ctx, const void *buffer, size_t len);
-static void common64_end(sha1_ctx_t *ctx, int swap_needed);
+static void common64_hash(sha1_ctx_t *ctx, const void *buffer, size_t len, sha_blocks_fn process_blocks);
+static void common64_end(sha1_ctx_t *ctx, int swap_needed, sha_blocks_fn process_blocks);
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
 
 
 /* sha1 specific code */
 
-static void sha1_process_block64(sha1_ctx_t *ctx)
+static void sha1_process_block64(uint32_t *hash, const uint8_t *block)
 {
 	static const uint32_t rconsts[] = {
 		0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6
@@ -75,16 +81,13 @@ static void sha1_process_block64(sha1_ctx_t *ctx)
 	/* On-stack work buffer frees up one register in the main loop
 	 * which otherwise will be needed to hold ctx pointer */
 	for (i = 0; i < 16; i++)
-		if (SHA1_BIG_ENDIAN)
-			W[i] = W[i+16] = ((uint32_t*)ctx->wbuffer)[i];
-		else
-			W[i] = W[i+16] = bswap_32(((uint32_t*)ctx->wbuffer)[i]);
+		W[i] = W[i+16] = load_be32(block + i * 4);
 
-	a = ctx->hash[0];
-	b = ctx->hash[1];
-	c = ctx->hash[2];
-	d = ctx->hash[3];
-	e = ctx->hash[4];
+	a = hash[0];
+	b = hash[1];
+	c = hash[2];
+	d = hash[3];
+	e = hash[4];
 
 	/* 4 rounds of 20 operations each */
 	cnt = 0;
@@ -122,11 +125,19 @@ static void sha1_process_block64(sha1_ctx_t *ctx)
 		} while (--j >= 0);
 	}
 
-	ctx->hash[0] += a;
-	ctx->hash[1] += b;
-	ctx->hash[2] += c;
-	ctx->hash[3] += d;
-	ctx->hash[4] += e;
+	hash[0] += a;
+	hash[1] += b;
+	hash[2] += c;
+	hash[3] += d;
+	hash[4] += e;
+}
+
+void sha1_blocks_generic(uint32_t *hash, const uint8_t *data, size_t blocks)
+{
+	while (blocks--) {
+		sha1_process_block64(hash, data);
+		data += 64;
+	}
 }
 
 void sha1_begin(sha1_ctx_t *ctx)
@@ -137,23 +148,18 @@ void sha1_begin(sha1_ctx_t *ctx)
 	ctx->hash[3] = 0x10325476;
 	ctx->hash[4] = 0xc3d2e1f0;
 	ctx->total64 = 0;
-	/* for sha256: ctx->process_block = sha1_process_block64; */
 }
 
 void sha1_hash(sha1_ctx_t *ctx, const void *buffer, size_t len)
 {
-        common64_hash(ctx, buffer, len);
+	common64_hash(ctx, buffer, len, sha_get_blocks_fn(HASH_SHA1));
 }
 
-/* May be used also for sha256 */
-void sha1_end(sha1_ctx_t *ctx, void *resbuf)
+static void sha_end_common(sha1_ctx_t *ctx, void *resbuf, unsigned hash_size, sha_blocks_fn process_blocks)
 {
-	unsigned hash_size;
-
 	/* SHA stores total in BE, need to swap on LE arches: */
-	common64_end(ctx, /*swap_needed:*/ SHA1_LITTLE_ENDIAN);
+	common64_end(ctx, /*swap_needed:*/ SHA1_LITTLE_ENDIAN, process_blocks);
 
-	hash_size = 5; /* (ctx->process_block == sha1_process_block64) ? 5 : 8; */
 	/* This way we do not impose alignment constraints on resbuf: */
 	if (SHA1_LITTLE_ENDIAN) {
 		unsigned i;
@@ -163,23 +169,140 @@ void sha1_end(sha1_ctx_t *ctx, void *resbuf)
 	memcpy(resbuf, ctx->hash, sizeof(ctx->hash[0]) * hash_size);
 }
 
+void sha1_end(sha1_ctx_t *ctx, void *resbuf)
+{
+	sha_end_common(ctx, resbuf, 5, sha_get_blocks_fn(HASH_SHA1));
+}
 
-/* Generic 64-byte helpers for 64-byte block hashes */
 
-/*#define PROCESS_BLOCK(ctx) ctx->process_block(ctx)*/
-#define PROCESS_BLOCK(ctx) sha1_process_block64(ctx)
+/* sha256 specific code */
+
+static const uint32_t sha256_K[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+const uint32_t *sha256_round_constants(void)
+{
+	return sha256_K;
+}
+
+static void sha256_process_block64(uint32_t *hash, const uint8_t *block)
+{
+	unsigned t;
+	uint32_t W[64], a, b, c, d, e, f, g, h;
+
+	/* Operators defined in FIPS 180-2:4.1.2.  */
+#define Ch(x, y, z) ((x & y) ^ (~x & z))
+#define Maj(x, y, z) ((x & y) ^ (x & z) ^ (y & z))
+#define S0(x) (rotr32(x, 2) ^ rotr32(x, 13) ^ rotr32(x, 22))
+#define S1(x) (rotr32(x, 6) ^ rotr32(x, 11) ^ rotr32(x, 25))
+#define R0(x) (rotr32(x, 7) ^ rotr32(x, 18) ^ (x >> 3))
+#define R1(x) (rotr32(x, 17) ^ rotr32(x, 19) ^ (x >> 10))
+
+	/* Compute the message schedule according to FIPS 180-2:6.2.2 step 2.  */
+	for (t = 0; t < 16; ++t)
+		W[t] = load_be32(block + t * 4);
+
+	for (/*t = 16*/; t < 64; ++t)
+		W[t] = R1(W[t - 2]) + W[t - 7] + R0(W[t - 15]) + W[t - 16];
+
+	a = hash[0];
+	b = hash[1];
+	c = hash[2];
+	d = hash[3];
+	e = hash[4];
+	f = hash[5];
+	g = hash[6];
+	h = hash[7];
+
+	/* The actual computation according to FIPS 180-2:6.2.2 step 3.  */
+	for (t = 0; t < 64; ++t) {
+		uint32_t T1 = h + S1(e) + Ch(e, f, g) + sha256_K[t] + W[t];
+		uint32_t T2 = S0(a) + Maj(a, b, c);
+		h = g;
+		g = f;
+		f = e;
+		e = d + T1;
+		d = c;
+		c = b;
+		b = a;
+		a = T1 + T2;
+	}
+#undef Ch
+#undef Maj
+#undef S0
+#undef S1
+#undef R0
+#undef R1
+
+	hash[0] += a;
+	hash[1] += b;
+	hash[2] += c;
+	hash[3] += d;
+	hash[4] += e;
+	hash[5] += f;
+	hash[6] += g;
+	hash[7] += h;
+}
+
+void sha256_blocks_generic(uint32_t *hash, const uint8_t *data, size_t blocks)
+{
+	while (blocks--) {
+		sha256_process_block64(hash, data);
+		data += 64;
+	}
+}
+
+void sha256_begin(sha256_ctx_t *ctx)
+{
+	static const uint32_t init256[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+	};
+	memcpy(ctx->hash, init256, sizeof(init256));
+	ctx->total64 = 0;
+}
+
+void sha256_hash(sha256_ctx_t *ctx, const void *buffer, size_t len)
+{
+	common64_hash(ctx, buffer, len, sha_get_blocks_fn(HASH_SHA256));
+}
+
+void sha256_end(sha256_ctx_t *ctx, void *resbuf)
+{
+	sha_end_common(ctx, resbuf, 8, sha_get_blocks_fn(HASH_SHA256));
+}
+
+
+/* Generic 64-byte helpers for 64-byte block hashes */
 
 /* Feed data through a temporary buffer.
  * The internal buffer remembers previous data until it has 64
- * bytes worth to pass on.
+ * bytes worth to pass on. Whole blocks are passed on directly
+ * from the caller's buffer.
  */
-static void common64_hash(sha1_ctx_t *ctx, const void *buffer, size_t len)
+static void common64_hash(sha1_ctx_t *ctx, const void *buffer, size_t len, sha_blocks_fn process_blocks)
 {
 	unsigned bufpos = ctx->total64 & 63;
 
 	ctx->total64 += len;
 
-	while (1) {
+	if (bufpos != 0) {
 		unsigned remaining = 64 - bufpos;
 		if (remaining > len)
 			remaining = len;
@@ -188,18 +311,23 @@ static void common64_hash(sha1_ctx_t *ctx, const void *buffer, size_t len)
 		len -= remaining;
 		buffer = (const char *)buffer + remaining;
 		bufpos += remaining;
-		/* clever way to do "if (bufpos != 64) break; ... ; bufpos = 0;" */
-		bufpos -= 64;
-		if (bufpos != 0)
-			break;
+		if (bufpos != 64)
+			return;
 		/* Buffer is filled up, process it */
-		PROCESS_BLOCK(ctx);
-		/*bufpos = 0; - already is */
+		process_blocks(ctx->hash, ctx->wbuffer, 1);
 	}
+
+	if (len >= 64) {
+		process_blocks(ctx->hash, buffer, len / 64);
+		buffer = (const char *)buffer + (len & ~(size_t)63);
+		len &= 63;
+	}
+
+	memcpy(ctx->wbuffer, buffer, len);
 }
 
 /* Process the remaining bytes in the buffer */
-static void common64_end(sha1_ctx_t *ctx, int swap_needed)
+static void common64_end(sha1_ctx_t *ctx, int swap_needed, sha_blocks_fn process_blocks)
 {
 	unsigned bufpos = ctx->total64 & 63;
 	/* Pad the buffer to the next 64-byte boundary with 0x80,0,0,0... */
@@ -218,7 +346,7 @@ static void common64_end(sha1_ctx_t *ctx, int swap_needed)
 			/* wbuffer is suitably aligned for this */
 			*(uint64_t *) (&ctx->wbuffer[64 - 8]) = t;
 		}
-		PROCESS_BLOCK(ctx);
+		process_blocks(ctx->hash, ctx->wbuffer, 1);
 		if (remaining >= 8)
 			break;
 		bufpos = 0;
@@ -243,3 +371,52 @@ const char *str_to_sha1str(char result[SHA1_RESULT_LEN*2 + 1], const char *str)
     bin2hex(result, (void*)hash_bytes, SHA1_RESULT_LEN)[0] = '\0';
     return result;
 }
+
+/* Data not backed by a regular file are read in chunks of this size */
+#define HASH_FD_BUFFER_SIZE (1024 * 1024)
+
+int hash_fd(int fd, int algorithm, uint8_t *result)
+{
+    sha1_ctx_t ctx;
+    if (algorithm == HASH_SHA1)
+        sha1_begin(&ctx);
+    else
+        sha256_begin(&ctx);
+
+    size_t size;
+    void *data = mmap_fd_read(fd, &size);
+    if (data != NULL)
+    {
+        if (algorithm == HASH_SHA1)
+            sha1_hash(&ctx, data, size);
+        else
+            sha256_hash(&ctx, data, size);
+        munmap_fd_read(data, size);
+    }
+    else
+    {
+        char *buf = xmalloc(HASH_FD_BUFFER_SIZE);
+        ssize_t r;
+        while ((r = full_read(fd, buf, HASH_FD_BUFFER_SIZE)) > 0)
+        {
+            if (algorithm == HASH_SHA1)
+                sha1_hash(&ctx, buf, r);
+            else
+                sha256_hash(&ctx, buf, r);
+        }
+        const int err = errno;
+        free(buf);
+
+        if (r < 0)
+            return -err;
+    }
+
+    if (algorithm == HASH_SHA1)
+    {
+        sha1_end(&ctx, result);
+        return SHA1_RESULT_LEN;
+    }
+
+    sha256_end(&ctx, result);
+    return SHA256_RESULT_LEN;
+}
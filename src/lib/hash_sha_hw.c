@@ -0,0 +1,301 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    SHA-1 and SHA-256 block functions using the x86 SHA extensions (SHA-NI).
+    The round structure follows the reference code published by Intel.
+
+    The group loops must be fully unrolled to keep the message words in
+    registers, hence the unroll pragmas.
+
+    The functions are compiled with target attributes, so the rest of
+    libreport does not need any special compiler flags, and they are selected
+    at run time only if the CPU supports the instructions.
+*/
+#include "internal_libreport.h"
+#include "hash_sha.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define HAVE_SHA_X86 1
+# include <cpuid.h>
+# include <immintrin.h>
+#endif
+
+#if HAVE_SHA_X86
+
+#define SHA_X86_TARGET __attribute__((target("sha,sse4.1")))
+
+static bool cpu_has_sha_ni(void)
+{
+    unsigned eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0, NULL) < 7)
+        return false;
+
+    /* SSE4.1 for the shuffles and blends */
+    __cpuid(1, eax, ebx, ecx, edx);
+    if (!(ecx & bit_SSE4_1))
+        return false;
+
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return ebx & (1 << 29); /* SHA */
+}
+
+SHA_X86_TARGET
+static void sha1_blocks_shani(uint32_t *hash, const uint8_t *data, size_t blocks)
+{
+    const __m128i MASK = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    __m128i ABCD, ABCD_SAVE, E0, E0_SAVE, E1;
+    __m128i MSG0, MSG1, MSG2, MSG3;
+
+    ABCD = _mm_loadu_si128((const __m128i *)hash);
+    ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+    E0 = _mm_set_epi32(hash[4], 0, 0, 0);
+
+/* Four rounds; E_IN carries the message words, E_OUT receives ABCD */
+#define ROUNDS4(E_IN, E_OUT, MSG, FUNC) \
+    do { \
+        E_IN = _mm_sha1nexte_epu32(E_IN, MSG); \
+        E_OUT = ABCD; \
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E_IN, FUNC); \
+    } while (0)
+
+    while (blocks--)
+    {
+        ABCD_SAVE = ABCD;
+        E0_SAVE = E0;
+
+        MSG0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 0)), MASK);
+        MSG1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), MASK);
+        MSG2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), MASK);
+        MSG3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), MASK);
+
+        /* Rounds 0-3 */
+        E0 = _mm_add_epi32(E0, MSG0);
+        E1 = ABCD;
+        ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+
+        /* Rounds 4-7 */
+        ROUNDS4(E1, E0, MSG1, 0);
+        MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+
+        /* Rounds 8-11 */
+        ROUNDS4(E0, E1, MSG2, 0);
+        MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+        MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+        /* Rounds 12-15 */
+        MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+        ROUNDS4(E1, E0, MSG3, 0);
+        MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+        MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+        /* Rounds 16-19 */
+        MSG1 = _mm_sha1msg2_epu32(MSG1, MSG0);
+        ROUNDS4(E0, E1, MSG0, 0);
+        MSG3 = _mm_sha1msg1_epu32(MSG3, MSG0);
+        MSG2 = _mm_xor_si128(MSG2, MSG0);
+
+        /* Rounds 20-23 */
+        MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+        ROUNDS4(E1, E0, MSG1, 1);
+        MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+        MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+        /* Rounds 24-27 */
+        MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+        ROUNDS4(E0, E1, MSG2, 1);
+        MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+        MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+        /* Rounds 28-31 */
+        MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+        ROUNDS4(E1, E0, MSG3, 1);
+        MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+        MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+        /* Rounds 32-35 */
+        MSG1 = _mm_sha1msg2_epu32(MSG1, MSG0);
+        ROUNDS4(E0, E1, MSG0, 1);
+        MSG3 = _mm_sha1msg1_epu32(MSG3, MSG0);
+        MSG2 = _mm_xor_si128(MSG2, MSG0);
+
+        /* Rounds 36-39 */
+        MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+        ROUNDS4(E1, E0, MSG1, 1);
+        MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+        MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+        /* Rounds 40-43 */
+        MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+        ROUNDS4(E0, E1, MSG2, 2);
+        MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+        MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+        /* Rounds 44-47 */
+        MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+        ROUNDS4(E1, E0, MSG3, 2);
+        MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+        MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+        /* Rounds 48-51 */
+        MSG1 = _mm_sha1msg2_epu32(MSG1, MSG0);
+        ROUNDS4(E0, E1, MSG0, 2);
+        MSG3 = _mm_sha1msg1_epu32(MSG3, MSG0);
+        MSG2 = _mm_xor_si128(MSG2, MSG0);
+
+        /* Rounds 52-55 */
+        MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+        ROUNDS4(E1, E0, MSG1, 2);
+        MSG0 = _mm_sha1msg1_epu32(MSG0, MSG1);
+        MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+        /* Rounds 56-59 */
+        MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+        ROUNDS4(E0, E1, MSG2, 2);
+        MSG1 = _mm_sha1msg1_epu32(MSG1, MSG2);
+        MSG0 = _mm_xor_si128(MSG0, MSG2);
+
+        /* Rounds 60-63 */
+        MSG0 = _mm_sha1msg2_epu32(MSG0, MSG3);
+        ROUNDS4(E1, E0, MSG3, 3);
+        MSG2 = _mm_sha1msg1_epu32(MSG2, MSG3);
+        MSG1 = _mm_xor_si128(MSG1, MSG3);
+
+        /* Rounds 64-67 */
+        MSG1 = _mm_sha1msg2_epu32(MSG1, MSG0);
+        ROUNDS4(E0, E1, MSG0, 3);
+        MSG3 = _mm_sha1msg1_epu32(MSG3, MSG0);
+        MSG2 = _mm_xor_si128(MSG2, MSG0);
+
+        /* Rounds 68-71 */
+        MSG2 = _mm_sha1msg2_epu32(MSG2, MSG1);
+        ROUNDS4(E1, E0, MSG1, 3);
+        MSG3 = _mm_xor_si128(MSG3, MSG1);
+
+        /* Rounds 72-75 */
+        MSG3 = _mm_sha1msg2_epu32(MSG3, MSG2);
+        ROUNDS4(E0, E1, MSG2, 3);
+
+        /* Rounds 76-79 */
+        ROUNDS4(E1, E0, MSG3, 3);
+
+        E0 = _mm_sha1nexte_epu32(E0, E0_SAVE);
+        ABCD = _mm_add_epi32(ABCD, ABCD_SAVE);
+
+        data += 64;
+    }
+#undef ROUNDS4
+
+    ABCD = _mm_shuffle_epi32(ABCD, 0x1B);
+    _mm_storeu_si128((__m128i *)hash, ABCD);
+    hash[4] = _mm_extract_epi32(E0, 3);
+}
+
+SHA_X86_TARGET
+static void sha256_blocks_shani(uint32_t *hash, const uint8_t *data, size_t blocks)
+{
+    const __m128i MASK = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    const uint32_t *K = sha256_round_constants();
+    __m128i STATE0, STATE1, ABEF_SAVE, CDGH_SAVE, MSG, TMP;
+    __m128i M[4];
+
+    TMP = _mm_loadu_si128((const __m128i *)&hash[0]);
+    STATE1 = _mm_loadu_si128((const __m128i *)&hash[4]);
+    TMP = _mm_shuffle_epi32(TMP, 0xB1);          /* CDAB */
+    STATE1 = _mm_shuffle_epi32(STATE1, 0x1B);    /* EFGH */
+    STATE0 = _mm_alignr_epi8(TMP, STATE1, 8);    /* ABEF */
+    STATE1 = _mm_blend_epi16(STATE1, TMP, 0xF0); /* CDGH */
+
+    while (blocks--)
+    {
+        ABEF_SAVE = STATE0;
+        CDGH_SAVE = STATE1;
+
+        for (unsigned i = 0; i < 4; ++i)
+            M[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + i * 16)), MASK);
+
+        /* 16 groups of 4 rounds; M[g % 4] holds the message words of group g */
+#pragma GCC unroll 16
+        for (unsigned g = 0; g < 16; ++g)
+        {
+            MSG = _mm_add_epi32(M[g % 4], _mm_loadu_si128((const __m128i *)&K[g * 4]));
+            STATE1 = _mm_sha256rnds2_epu32(STATE1, STATE0, MSG);
+
+            if (g >= 3 && g <= 14)
+            {
+                TMP = _mm_alignr_epi8(M[g % 4], M[(g + 3) % 4], 4);
+                M[(g + 1) % 4] = _mm_add_epi32(M[(g + 1) % 4], TMP);
+                M[(g + 1) % 4] = _mm_sha256msg2_epu32(M[(g + 1) % 4], M[g % 4]);
+            }
+
+            MSG = _mm_shuffle_epi32(MSG, 0x0E);
+            STATE0 = _mm_sha256rnds2_epu32(STATE0, STATE1, MSG);
+
+            if (g >= 1 && g <= 12)
+                M[(g + 3) % 4] = _mm_sha256msg1_epu32(M[(g + 3) % 4], M[g % 4]);
+        }
+
+        STATE0 = _mm_add_epi32(STATE0, ABEF_SAVE);
+        STATE1 = _mm_add_epi32(STATE1, CDGH_SAVE);
+
+        data += 64;
+    }
+
+    TMP = _mm_shuffle_epi32(STATE0, 0x1B);       /* FEBA */
+    STATE1 = _mm_shuffle_epi32(STATE1, 0xB1);    /* DCHG */
+    STATE0 = _mm_blend_epi16(TMP, STATE1, 0xF0); /* DCBA */
+    STATE1 = _mm_alignr_epi8(STATE1, TMP, 8);    /* ABEF */
+
+    _mm_storeu_si128((__m128i *)&hash[0], STATE0);
+    _mm_storeu_si128((__m128i *)&hash[4], STATE1);
+}
+
+#endif /* HAVE_SHA_X86 */
+
+static bool hw_acceleration_disabled;
+
+void hash_set_hw_acceleration(bool enable)
+{
+    hw_acceleration_disabled = !enable;
+}
+
+static sha_blocks_fn select_blocks_fn(int algorithm, bool allow_hw)
+{
+    if (allow_hw)
+    {
+#if HAVE_SHA_X86
+        if (cpu_has_sha_ni())
+            return algorithm == HASH_SHA1 ? sha1_blocks_shani : sha256_blocks_shani;
+#endif
+    }
+
+    return algorithm == HASH_SHA1 ? sha1_blocks_generic : sha256_blocks_generic;
+}
+
+sha_blocks_fn sha_get_blocks_fn(int algorithm)
+{
+    /* Detection results never change, so racing threads store the same values */
+    static sha_blocks_fn cached[2][2];
+
+    const int slot = algorithm == HASH_SHA1 ? 0 : 1;
+    const int disabled = hw_acceleration_disabled;
+    if (cached[disabled][slot] == NULL)
+        cached[disabled][slot] = select_blocks_fn(algorithm, !disabled);
+
+    return cached[disabled][slot];
+}
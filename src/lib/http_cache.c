@@ -0,0 +1,554 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "internal_libreport.h"
+#include "http_cache.h"
+
+#define HTTP_CACHE_DIR_NAME       "libreport"
+#define HTTP_CACHE_PROXIES        "proxies"
+#define HTTP_CACHE_TLS_SESSIONS   "tls-sessions"
+#define HTTP_CACHE_DUPLICATES     "duplicates"
+/* The files are always read and rewritten as a whole */
+#define HTTP_CACHE_MAX_SIZE       (256 * 1024)
+
+/* A cache file consists of lines in the form "EXPIRES KEY VALUE", where
+ * EXPIRES is UNIX time stamp and neither KEY nor VALUE contain white spaces.
+ */
+struct http_cache_entry
+{
+    time_t expires;
+    char *value;
+};
+
+static void
+free_http_cache_entry(struct http_cache_entry *entry)
+{
+    free(entry->value);
+    free(entry);
+}
+
+static void
+http_cache_set(GHashTable *entries, const char *key, char *value, time_t expires)
+{
+    struct http_cache_entry *entry = xmalloc(sizeof(*entry));
+    entry->expires = expires;
+    entry->value = value;
+    g_hash_table_replace(entries, xstrdup(key), entry);
+}
+
+static bool
+is_private_file(const struct stat *sb)
+{
+    return sb->st_uid == geteuid() && (sb->st_mode & 0077) == 0;
+}
+
+static unsigned
+load_ttl(const char *env_name)
+{
+    const char *value = getenv(env_name);
+    if (value == NULL || value[0] == '\0')
+        return 0;
+
+    errno = 0;
+    char *endptr;
+    const unsigned long ttl = strtoul(value, &endptr, /* base */ 10);
+    if (errno != 0 || *endptr != '\0' || !isdigit(value[0]) || ttl > UINT_MAX)
+    {
+        log_notice("Ignoring invalid value of %s: '%s'", env_name, value);
+        return 0;
+    }
+
+    return (unsigned)ttl;
+}
+
+unsigned http_cache_ttl(void)
+{
+    return load_ttl(HTTP_CACHE_TTL_ENV);
+}
+
+unsigned duplicate_cache_ttl(void)
+{
+    return load_ttl(DUPLICATE_CACHE_TTL_ENV);
+}
+
+char *http_cache_host_key(const char *url)
+{
+    const char *authority = strstr(url, "://");
+    if (authority == NULL)
+        return xstrdup(url);
+
+    authority += strlen("://");
+    const char *const end = authority + strcspn(authority, "/?#");
+    const char *host = memrchr(authority, '@', end - authority);
+    host = host ? host + 1 : authority;
+
+    return xasprintf("%.*s%.*s", (int)(authority - url), url, (int)(end - host), host);
+}
+
+/* Returns a file descriptor of the cache directory or -1. */
+static int
+http_cache_open_dir(bool create)
+{
+    char *path = concat_path_file(g_get_user_cache_dir(), HTTP_CACHE_DIR_NAME);
+
+    int dir_fd = -1;
+    if (create && g_mkdir_with_parents(path, 0700) != 0)
+    {
+        log_notice("Can't create HTTP cache directory '%s': %s", path, strerror(errno));
+        goto finito;
+    }
+
+    dir_fd = open(path, O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (dir_fd < 0)
+    {
+        if (errno != ENOENT)
+            log_notice("Can't open HTTP cache directory '%s': %s", path, strerror(errno));
+        goto finito;
+    }
+
+    struct stat sb;
+    if (fstat(dir_fd, &sb) != 0 || !is_private_file(&sb))
+    {
+        log_notice("Ignoring HTTP cache directory '%s' accessible by other users", path);
+        close(dir_fd);
+        dir_fd = -1;
+    }
+
+finito:
+    free(path);
+    return dir_fd;
+}
+
+/* Returns all not expired entries of the cache file. */
+static GHashTable *
+http_cache_load(int dir_fd, const char *name)
+{
+    GHashTable *entries = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                                free, (GDestroyNotify)free_http_cache_entry);
+
+    const int fd = openat(dir_fd, name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno != ENOENT)
+            log_notice("Can't open HTTP cache '%s': %s", name, strerror(errno));
+        return entries;
+    }
+
+    char *data = NULL;
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || !S_ISREG(sb.st_mode) || !is_private_file(&sb))
+        log_notice("Ignoring HTTP cache '%s' accessible by other users", name);
+    else
+    {
+        size_t size = HTTP_CACHE_MAX_SIZE;
+        data = xmalloc_read(fd, &size);
+    }
+    close(fd);
+
+    if (data == NULL)
+        return entries;
+
+    const time_t now = time(NULL);
+    char *saveptr = NULL;
+    for (char *line = strtok_r(data, "\n", &saveptr); line; line = strtok_r(NULL, "\n", &saveptr))
+    {
+        char *key = strchr(line, ' ');
+        if (key == NULL)
+            continue;
+        *key++ = '\0';
+
+        char *value = strchr(key, ' ');
+        if (value == NULL)
+            continue;
+        *value++ = '\0';
+
+        errno = 0;
+        char *endptr;
+        const long long expires = strtoll(line, &endptr, /* base */ 10);
+        if (errno != 0 || *endptr != '\0' || expires <= now)
+            continue;
+
+        http_cache_set(entries, key, xstrdup(value), (time_t)expires);
+    }
+
+    free(data);
+    return entries;
+}
+
+/* Atomically replaces the cache file. Concurrent writers may lose their
+ * updates which is acceptable for a cache.
+ */
+static void
+http_cache_store(int dir_fd, const char *name, GHashTable *entries)
+{
+    struct strbuf *buf = strbuf_new();
+
+    GHashTableIter iter;
+    gpointer key, value;
+    g_hash_table_iter_init(&iter, entries);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        const struct http_cache_entry *entry = value;
+        strbuf_append_strf(buf, "%lld %s %s\n", (long long)entry->expires, (const char *)key, entry->value);
+    }
+
+    char *tmp_name = xasprintf("~%s.%ld.tmp", name, (long)getpid());
+
+    const int fd = openat(dir_fd, tmp_name, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        log_notice("Can't create HTTP cache '%s': %s", tmp_name, strerror(errno));
+        goto finito;
+    }
+
+    const bool written = full_write(fd, buf->buf, buf->len) == buf->len;
+    if (close(fd) != 0 || !written)
+    {
+        log_notice("Can't write HTTP cache '%s'", tmp_name);
+        unlinkat(dir_fd, tmp_name, /*only files*/0);
+        goto finito;
+    }
+
+    if (renameat(dir_fd, tmp_name, dir_fd, name) != 0)
+    {
+        log_notice("Can't replace HTTP cache '%s': %s", name, strerror(errno));
+        unlinkat(dir_fd, tmp_name, /*only files*/0);
+    }
+
+finito:
+    free(tmp_name);
+    strbuf_free(buf);
+}
+
+GList *http_cache_get_proxy_list(const char *url, bool *found)
+{
+    *found = false;
+
+    if (http_cache_ttl() == 0)
+        return NULL;
+
+    const int dir_fd = http_cache_open_dir(/*create*/false);
+    if (dir_fd < 0)
+        return NULL;
+
+    GHashTable *entries = http_cache_load(dir_fd, HTTP_CACHE_PROXIES);
+    close(dir_fd);
+
+    GList *proxies = NULL;
+    char *key = http_cache_host_key(url);
+    const struct http_cache_entry *entry = g_hash_table_lookup(entries, key);
+    if (entry != NULL)
+    {
+        log_debug("Using cached proxies for '%s': %s", key, entry->value);
+        *found = true;
+
+        /* "-" stands for an empty list */
+        if (strcmp(entry->value, "-") != 0)
+        {
+            char **list = g_strsplit(entry->value, ",", -1);
+            for (char **proxy = list; *proxy; ++proxy)
+                if ((*proxy)[0] != '\0')
+                    proxies = g_list_append(proxies, xstrdup(*proxy));
+            g_strfreev(list);
+        }
+    }
+
+    free(key);
+    g_hash_table_destroy(entries);
+    return proxies;
+}
+
+void http_cache_put_proxy_list(const char *url, GList *proxies)
+{
+    const unsigned ttl = http_cache_ttl();
+    if (ttl == 0)
+        return;
+
+    char *key = http_cache_host_key(url);
+    struct strbuf *value = strbuf_new();
+
+    /* Values that cannot be represented are not cached */
+    if (strpbrk(key, " \t\n") != NULL)
+        goto finito;
+
+    for (GList *li = proxies; li; li = g_list_next(li))
+    {
+        const char *proxy = li->data;
+        if (strpbrk(proxy, ", \t\n") != NULL)
+            goto finito;
+
+        strbuf_append_strf(value, "%s%s", value->len ? "," : "", proxy);
+    }
+
+    if (value->len == 0)
+        strbuf_append_char(value, '-');
+
+    const int dir_fd = http_cache_open_dir(/*create*/true);
+    if (dir_fd < 0)
+        goto finito;
+
+    GHashTable *entries = http_cache_load(dir_fd, HTTP_CACHE_PROXIES);
+    http_cache_set(entries, key, strbuf_free_nobuf(value), time(NULL) + ttl);
+    value = NULL;
+    http_cache_store(dir_fd, HTTP_CACHE_PROXIES, entries);
+    g_hash_table_destroy(entries);
+    close(dir_fd);
+
+finito:
+    if (value)
+        strbuf_free(value);
+    free(key);
+}
+
+/* The tracker URL and the product may contain white spaces */
+static char *
+duplicate_cache_key(const char *tracker_url, const char *product, const char *duphash)
+{
+    char *key_str = xasprintf("%s\n%s\n%s", tracker_url, product ? product : "", duphash);
+    char *key = xmalloc(SHA1_RESULT_LEN * 2 + 1);
+    str_to_sha1str(key, key_str);
+    free(key_str);
+    return key;
+}
+
+bool duplicate_cache_get(const char *tracker_url, const char *product, const char *duphash,
+                         int *bug_id, char **status)
+{
+    if (duplicate_cache_ttl() == 0)
+        return false;
+
+    const int dir_fd = http_cache_open_dir(/*create*/false);
+    if (dir_fd < 0)
+        return false;
+
+    GHashTable *entries = http_cache_load(dir_fd, HTTP_CACHE_DUPLICATES);
+    close(dir_fd);
+
+    bool found = false;
+    char *key = duplicate_cache_key(tracker_url, product, duphash);
+    const struct http_cache_entry *entry = g_hash_table_lookup(entries, key);
+    if (entry != NULL)
+    {
+        /* "ID,STATUS" */
+        errno = 0;
+        char *endptr;
+        const long id = strtol(entry->value, &endptr, /* base */ 10);
+        if (errno == 0 && *endptr == ',' && endptr != entry->value && id >= 0 && id <= INT_MAX)
+        {
+            log_debug("Using cached duplicate of '%s': %s", duphash, entry->value);
+            *bug_id = (int)id;
+            if (status)
+                *status = xstrdup(endptr + 1);
+            found = true;
+        }
+    }
+
+    free(key);
+    g_hash_table_destroy(entries);
+    return found;
+}
+
+/* Replaces or removes (value == NULL) the entry */
+static void
+duplicate_cache_update(const char *tracker_url, const char *product, const char *duphash,
+                       char *value, unsigned ttl)
+{
+    const int dir_fd = http_cache_open_dir(/*create*/value != NULL);
+    if (dir_fd < 0)
+    {
+        free(value);
+        return;
+    }
+
+    GHashTable *entries = http_cache_load(dir_fd, HTTP_CACHE_DUPLICATES);
+    char *key = duplicate_cache_key(tracker_url, product, duphash);
+
+    bool changed = true;
+    if (value != NULL)
+        http_cache_set(entries, key, value, time(NULL) + ttl);
+    else
+        changed = g_hash_table_remove(entries, key);
+
+    if (changed)
+        http_cache_store(dir_fd, HTTP_CACHE_DUPLICATES, entries);
+
+    free(key);
+    g_hash_table_destroy(entries);
+    close(dir_fd);
+}
+
+void duplicate_cache_put(const char *tracker_url, const char *product, const char *duphash,
+                         int bug_id, const char *status)
+{
+    const unsigned ttl = duplicate_cache_ttl();
+    if (ttl == 0)
+        return;
+
+    char *value = xasprintf("%d,%s", bug_id, status ? status : "");
+    /* The value must not contain white spaces */
+    for (char *c = value; *c; ++c)
+        if (isspace(*c))
+            *c = '_';
+
+    duplicate_cache_update(tracker_url, product, duphash, value, ttl);
+}
+
+void duplicate_cache_drop(const char *tracker_url, const char *product, const char *duphash)
+{
+    /* Dropping works even if the cache has been disabled since */
+    duplicate_cache_update(tracker_url, product, duphash, /*value*/NULL, 0);
+}
+
+#if LIBCURL_VERSION_NUM >= 0x080c00
+/* curl_easy_ssls_export() and curl_easy_ssls_import() are available since
+ * curl-8.12.0
+ *
+ * The value of a TLS session entry is "KEY,SHMAC,DATA", all Base64 encoded or
+ * "-" if the part is missing. Curl provides either the session key or its
+ * salted hash.
+ */
+struct tls_export_ctx
+{
+    GHashTable *entries;
+    time_t now;
+    unsigned ttl;
+    unsigned count;
+};
+
+static gchar *
+base64_or_dash(const unsigned char *data, size_t len)
+{
+    return data != NULL && len != 0 ? g_base64_encode(data, len) : g_strdup("-");
+}
+
+static CURLcode
+export_tls_session(CURL *handle, void *userptr, const char *session_key,
+                   const unsigned char *shmac, size_t shmac_len,
+                   const unsigned char *sdata, size_t sdata_len,
+                   curl_off_t valid_until, int ietf_tls_id,
+                   const char *alpn, size_t earlydata_max)
+{
+    struct tls_export_ctx *ctx = userptr;
+
+    if (sdata == NULL || sdata_len == 0 || (session_key == NULL && shmac_len == 0))
+        return CURLE_OK;
+
+    gchar *key = base64_or_dash((const unsigned char *)session_key, session_key ? strlen(session_key) : 0);
+    gchar *mac = base64_or_dash(shmac, shmac_len);
+    gchar *data = base64_or_dash(sdata, sdata_len);
+
+    time_t expires = ctx->now + ctx->ttl;
+    if (valid_until > 0 && valid_until < expires)
+        expires = valid_until;
+
+    if (expires > ctx->now)
+    {
+        http_cache_set(ctx->entries, session_key ? key : mac,
+                       xasprintf("%s,%s,%s", key, mac, data), expires);
+        ++ctx->count;
+    }
+
+    g_free(data);
+    g_free(mac);
+    g_free(key);
+    return CURLE_OK;
+}
+
+void http_cache_export_tls_sessions(CURL *handle)
+{
+    const unsigned ttl = http_cache_ttl();
+    if (ttl == 0)
+        return;
+
+    const int dir_fd = http_cache_open_dir(/*create*/true);
+    if (dir_fd < 0)
+        return;
+
+    struct tls_export_ctx ctx = {
+        .entries = http_cache_load(dir_fd, HTTP_CACHE_TLS_SESSIONS),
+        .now = time(NULL),
+        .ttl = ttl,
+        .count = 0,
+    };
+
+    const CURLcode err = curl_easy_ssls_export(handle, export_tls_session, &ctx);
+    if (err != CURLE_OK)
+        log_debug("Can't export TLS sessions: %s", curl_easy_strerror(err));
+    else if (ctx.count != 0)
+        http_cache_store(dir_fd, HTTP_CACHE_TLS_SESSIONS, ctx.entries);
+
+    g_hash_table_destroy(ctx.entries);
+    close(dir_fd);
+}
+
+void http_cache_import_tls_sessions(CURL *handle)
+{
+    if (http_cache_ttl() == 0)
+        return;
+
+    const int dir_fd = http_cache_open_dir(/*create*/false);
+    if (dir_fd < 0)
+        return;
+
+    GHashTable *entries = http_cache_load(dir_fd, HTTP_CACHE_TLS_SESSIONS);
+    close(dir_fd);
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, entries);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        const struct http_cache_entry *entry = value;
+        char **parts = g_strsplit(entry->value, ",", 3);
+        if (g_strv_length(parts) == 3)
+        {
+            gsize key_len = 0, mac_len = 0, data_len = 0;
+            guchar *key = strcmp(parts[0], "-") != 0 ? g_base64_decode(parts[0], &key_len) : NULL;
+            guchar *mac = strcmp(parts[1], "-") != 0 ? g_base64_decode(parts[1], &mac_len) : NULL;
+            guchar *data = g_base64_decode(parts[2], &data_len);
+
+            /* The session key is a string */
+            char *session_key = key ? xstrndup((const char *)key, key_len) : NULL;
+
+            const CURLcode err = curl_easy_ssls_import(handle, session_key, mac, mac_len, data, data_len);
+            if (err != CURLE_OK)
+                log_debug("Can't import TLS session: %s", curl_easy_strerror(err));
+
+            free(session_key);
+            g_free(data);
+            g_free(mac);
+            g_free(key);
+        }
+        g_strfreev(parts);
+    }
+
+    g_hash_table_destroy(entries);
+}
+
+#else
+
+void http_cache_export_tls_sessions(CURL *handle)
+{
+    /* This version of curl cannot export TLS sessions */
+}
+
+void http_cache_import_tls_sessions(CURL *handle)
+{
+}
+
+#endif
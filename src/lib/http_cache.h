@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#ifndef HTTP_CACHE_H_
+#define HTTP_CACHE_H_
+
+/* On-disk cache of proxy decisions, TLS sessions and duplicate searches
+ *
+ * Reporters are short-lived processes, so nothing survives between two
+ * reporters run in one workflow. The cache lets them share the proxy lists
+ * resolved by libproxy and resume TLS sessions instead of doing a full
+ * handshake.
+ *
+ * The cache is disabled unless the environment variable
+ * LIBREPORT_HTTP_CACHE_TTL holds a positive number of seconds. The cache
+ * files are stored in $XDG_CACHE_HOME/libreport and are ignored if they are
+ * not owned by the current user or are accessible by others.
+ */
+
+#include <stdbool.h>
+#include <glib.h>
+#include <curl/curl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_CACHE_TTL_ENV "LIBREPORT_HTTP_CACHE_TTL"
+#define DUPLICATE_CACHE_TTL_ENV "LIBREPORT_DUPLICATE_CACHE_TTL"
+
+/* Returns the configured life time of cache entries in seconds or 0 if the
+ * cache is disabled. */
+unsigned http_cache_ttl(void);
+
+/* Returns "scheme://host[:port]" of the url, the userinfo is removed. */
+char *http_cache_host_key(const char *url);
+
+/* Looks up the proxy list of the url's host.
+ *
+ * @param found Set to true if the cache has a valid entry; the returned NULL
+ * then means no proxy.
+ * @returns A list of malloced strings.
+ */
+GList *http_cache_get_proxy_list(const char *url, bool *found);
+
+/* Stores the proxy list of the url's host. NULL means no proxy. */
+void http_cache_put_proxy_list(const char *url, GList *proxies);
+
+/* Adds the cached TLS sessions to the handle's session cache. */
+void http_cache_import_tls_sessions(CURL *handle);
+
+/* Stores the TLS sessions from the handle's session cache. */
+void http_cache_export_tls_sessions(CURL *handle);
+
+/* Results of duplicate searches
+ *
+ * Reporters remember the bug a problem with the duphash was reported to, so
+ * they do not have to search for the duplicates again. The cache has its own
+ * life time, set by the environment variable LIBREPORT_DUPLICATE_CACHE_TTL,
+ * because a bug can be closed or moved in the meantime.
+ *
+ * The product identifies the search scope within the tracker, e.g. product,
+ * version and component.
+ */
+unsigned duplicate_cache_ttl(void);
+
+/* @param status If not NULL, set to the malloced status of the bug.
+ * @returns true if the cache has a valid entry
+ */
+bool duplicate_cache_get(const char *tracker_url, const char *product, const char *duphash,
+                         int *bug_id, char **status);
+
+void duplicate_cache_put(const char *tracker_url, const char *product, const char *duphash,
+                         int bug_id, const char *status);
+
+/* Removes the entry, e.g. when the user forces a new search. */
+void duplicate_cache_drop(const char *tracker_url, const char *product, const char *duphash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
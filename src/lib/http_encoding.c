@@ -0,0 +1,210 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+# include <zstd.h>
+#endif
+
+#include "internal_libreport.h"
+#include "libreport_curl.h"
+#include "http_encoding.h"
+
+#define HTTP_ENCODING_BUFFER_SIZE (16 * 1024)
+
+struct http_encoder
+{
+    int encoding;
+    z_stream zs;
+#ifdef HAVE_ZSTD
+    ZSTD_CCtx *zcctx;
+#endif
+};
+
+int post_encoding_from_string(const char *str)
+{
+    if (str == NULL || str[0] == '\0'
+        || strcasecmp(str, "none") == 0 || strcasecmp(str, "identity") == 0)
+        return POST_ENCODING_IDENTITY;
+
+    if (strcasecmp(str, "gzip") == 0)
+        return POST_ENCODING_GZIP;
+
+#ifdef HAVE_ZSTD
+    if (strcasecmp(str, "zstd") == 0)
+        return POST_ENCODING_ZSTD;
+#endif
+
+    return -1;
+}
+
+const char *http_encoding_name(int encoding)
+{
+    switch (encoding)
+    {
+        case POST_ENCODING_GZIP:
+            return "gzip";
+#ifdef HAVE_ZSTD
+        case POST_ENCODING_ZSTD:
+            return "zstd";
+#endif
+        default:
+            return NULL;
+    }
+}
+
+http_encoder_t *http_encoder_new(int encoding)
+{
+    http_encoder_t *encoder = xzalloc(sizeof(*encoder));
+    encoder->encoding = encoding;
+
+    switch (encoding)
+    {
+        case POST_ENCODING_GZIP:
+            /* 16 + MAX_WBITS = gzip header and trailer instead of zlib's */
+            if (deflateInit2(&encoder->zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                             16 + MAX_WBITS, /*memLevel*/8, Z_DEFAULT_STRATEGY) != Z_OK)
+                error_msg_and_die("Can't initialize gzip compression");
+            break;
+#ifdef HAVE_ZSTD
+        case POST_ENCODING_ZSTD:
+            encoder->zcctx = ZSTD_createCCtx();
+            if (encoder->zcctx == NULL)
+                error_msg_and_die("Can't initialize zstd compression");
+            break;
+#endif
+        default:
+            error_msg_and_die("Bug: unsupported HTTP encoding %d", encoding);
+    }
+
+    return encoder;
+}
+
+void http_encoder_free(http_encoder_t *encoder)
+{
+    if (encoder == NULL)
+        return;
+
+    if (encoder->encoding == POST_ENCODING_GZIP)
+        deflateEnd(&encoder->zs);
+#ifdef HAVE_ZSTD
+    else if (encoder->encoding == POST_ENCODING_ZSTD)
+        ZSTD_freeCCtx(encoder->zcctx);
+#endif
+
+    free(encoder);
+}
+
+void http_encoder_reset(http_encoder_t *encoder)
+{
+    if (encoder->encoding == POST_ENCODING_GZIP)
+        deflateReset(&encoder->zs);
+#ifdef HAVE_ZSTD
+    else if (encoder->encoding == POST_ENCODING_ZSTD)
+        ZSTD_CCtx_reset(encoder->zcctx, ZSTD_reset_session_only);
+#endif
+}
+
+static bool
+gzip_process(z_stream *zs, const void *data, size_t len, bool finish, GByteArray *out)
+{
+    unsigned char buffer[HTTP_ENCODING_BUFFER_SIZE];
+
+    /* zlib's avail_in is only unsigned */
+    const unsigned char *in = data;
+    do
+    {
+        const size_t piece = MIN(len, UINT_MAX);
+        zs->next_in = (unsigned char *)in;
+        zs->avail_in = piece;
+        in += piece;
+        len -= piece;
+
+        const int flush = (finish && len == 0) ? Z_FINISH : Z_NO_FLUSH;
+        int r;
+        do
+        {
+            zs->next_out = buffer;
+            zs->avail_out = sizeof(buffer);
+            r = deflate(zs, flush);
+            if (r == Z_STREAM_ERROR)
+                return false;
+
+            g_byte_array_append(out, buffer, sizeof(buffer) - zs->avail_out);
+        }
+        while (zs->avail_out == 0 || (flush == Z_FINISH && r != Z_STREAM_END));
+    }
+    while (len != 0);
+
+    return true;
+}
+
+#ifdef HAVE_ZSTD
+static bool
+zstd_process(ZSTD_CCtx *zcctx, const void *data, size_t len, bool finish, GByteArray *out)
+{
+    unsigned char buffer[HTTP_ENCODING_BUFFER_SIZE];
+
+    ZSTD_inBuffer input = { data, len, 0 };
+    const ZSTD_EndDirective mode = finish ? ZSTD_e_end : ZSTD_e_continue;
+    size_t remaining;
+    do
+    {
+        ZSTD_outBuffer output = { buffer, sizeof(buffer), 0 };
+        remaining = ZSTD_compressStream2(zcctx, &output, &input, mode);
+        if (ZSTD_isError(remaining))
+        {
+            log_notice("zstd compression failed: %s", ZSTD_getErrorName(remaining));
+            return false;
+        }
+
+        g_byte_array_append(out, buffer, output.pos);
+    }
+    while (finish ? remaining != 0 : input.pos != input.size);
+
+    return true;
+}
+#endif
+
+bool http_encoder_process(http_encoder_t *encoder, const void *data, size_t len,
+                          bool finish, GByteArray *out)
+{
+    if (encoder->encoding == POST_ENCODING_GZIP)
+        return gzip_process(&encoder->zs, data, len, finish, out);
+#ifdef HAVE_ZSTD
+    if (encoder->encoding == POST_ENCODING_ZSTD)
+        return zstd_process(encoder->zcctx, data, len, finish, out);
+#endif
+
+    return false;
+}
+
+GByteArray *http_encode(int encoding, const void *data, size_t len)
+{
+    http_encoder_t *encoder = http_encoder_new(encoding);
+    GByteArray *out = g_byte_array_sized_new(len / 4 + 64);
+
+    if (!http_encoder_process(encoder, data, len, /*finish*/true, out))
+    {
+        g_byte_array_free(out, TRUE);
+        out = NULL;
+    }
+
+    http_encoder_free(encoder);
+    return out;
+}
@@ -0,0 +1,63 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#ifndef HTTP_ENCODING_H_
+#define HTTP_ENCODING_H_
+
+/* Compression of HTTP request bodies (Content-Encoding)
+ *
+ * The encodings are POST_ENCODING_* from libreport_curl.h. gzip is always
+ * available, zstd only if libreport was built with libzstd.
+ */
+
+#include <stdbool.h>
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Returns the Content-Encoding token of the encoding or NULL for identity
+ * and for the encodings libreport was built without, whose requests are sent
+ * uncompressed */
+const char *http_encoding_name(int encoding);
+
+typedef struct http_encoder http_encoder_t;
+
+http_encoder_t *http_encoder_new(int encoding);
+void http_encoder_free(http_encoder_t *encoder);
+
+/* Starts a new stream */
+void http_encoder_reset(http_encoder_t *encoder);
+
+/* Compresses the data and appends the output to out. Set finish to true with
+ * the last piece of data (may be empty) to get the rest of the output.
+ *
+ * @returns false on errors
+ */
+bool http_encoder_process(http_encoder_t *encoder, const void *data, size_t len,
+                          bool finish, GByteArray *out);
+
+/* Compresses the whole data at once */
+GByteArray *http_encode(int encoding, const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
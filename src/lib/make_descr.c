@@ -26,26 +26,123 @@ static bool rejected_name(const char *name, char **v, int flags)
     return r;
 }
 
+/*
+ * The description is written in small chunks through a buffer to a writer
+ * callback, so it never has to be held in memory as a whole.
+ */
+struct description_output
+{
+    description_writer_t writer;
+    void *param;
+    unsigned long max_size; ///< 0 means unlimited
+    unsigned long size;     ///< bytes accepted so far
+    bool truncated;
+    int error;              ///< the first error returned by the writer
+    size_t buf_len;
+    char buf[4096];
+};
+
+static void output_flush(struct description_output *out)
+{
+    if (out->buf_len == 0)
+        return;
+
+    if (out->error == 0)
+        out->error = out->writer(out->param, out->buf, out->buf_len);
+    out->buf_len = 0;
+}
+
+static void output_write_raw(struct description_output *out, const char *data, size_t len)
+{
+    if (out->buf_len + len > sizeof(out->buf))
+    {
+        output_flush(out);
+        if (len > sizeof(out->buf))
+        {
+            if (out->error == 0)
+                out->error = out->writer(out->param, data, len);
+            return;
+        }
+    }
+
+    memcpy(out->buf + out->buf_len, data, len);
+    out->buf_len += len;
+}
+
+/* Returns true if nothing more can be written */
+static bool output_done(const struct description_output *out)
+{
+    return out->truncated || out->error != 0;
+}
+
+static void output_write(struct description_output *out, const char *data, size_t len)
+{
+    if (output_done(out))
+        return;
+
+    if (out->max_size != 0 && out->size + len > out->max_size)
+    {
+        size_t fits = out->max_size - out->size;
+        /* Do not split UTF-8 characters */
+        while (fits > 0 && ((unsigned char)data[fits] & 0xC0) == 0x80)
+            --fits;
+
+        output_write_raw(out, data, fits);
+        output_write_raw(out, DESCRIPTION_TRUNCATED_MARK, strlen(DESCRIPTION_TRUNCATED_MARK));
+        out->size = out->max_size;
+        out->truncated = true;
+        return;
+    }
+
+    output_write_raw(out, data, len);
+    out->size += len;
+}
+
+static void output_write_str(struct description_output *out, const char *str)
+{
+    output_write(out, str, strlen(str));
+}
+
+static void output_printf(struct description_output *out, const char *format, ...)
+{
+    if (output_done(out))
+        return;
+
+    va_list p;
+    va_start(p, format);
+    char *str = xvasprintf(format, p);
+    va_end(p);
+
+    output_write_str(out, str);
+    free(str);
+}
+
+/* Returns false if the content is not a multi-line text */
 static
-char *make_description_item_multiline(const char *name, const char *content)
+bool write_description_item_multiline(struct description_output *out, bool separate,
+                                      const char *name, const char *content)
 {
     char *eol = strchr(content, '\n');
     if (!eol)
-        return NULL;
+        return false;
+
+    if (separate)
+        output_write_str(out, "\n");
 
-    struct strbuf *buf = strbuf_new();
-    strbuf_append_str(buf, name);
-    strbuf_append_str(buf, ":\n");
-    for (;;)
+    output_write_str(out, name);
+    output_write_str(out, ":\n");
+    while (!output_done(out))
     {
         eol = strchrnul(content, '\n');
-        strbuf_append_strf(buf, ":%.*s\n", (int)(eol - content), content);
+        output_write_str(out, ":");
+        output_write(out, content, eol - content);
+        output_write_str(out, "\n");
         if (*eol == '\0' || eol[1] == '\0')
             break;
         content = eol + 1;
     }
 
-    return strbuf_free_nobuf(buf);
+    return true;
 }
 
 static int list_cmp(const char *s1, const char *s2)
@@ -74,13 +171,9 @@ static int list_cmp(const char *s1, const char *s2)
     return s1_index - s2_index;
 }
 
-char *make_description(problem_data_t *problem_data, char **names_to_skip,
-                       unsigned max_text_size, unsigned desc_flags)
+static void write_description(struct description_output *out, problem_data_t *problem_data,
+                              char **names_to_skip, unsigned max_text_size, unsigned desc_flags)
 {
-    INITIALIZE_LIBREPORT();
-
-    struct strbuf *buf_dsc = strbuf_new();
-
     const char *type = problem_data_get_content_or_NULL(problem_data,
                                                             FILENAME_TYPE);
 
@@ -125,18 +218,18 @@ char *make_description(problem_data_t *problem_data, char **names_to_skip,
                 const char *crash_func = problem_data_get_content_or_NULL(problem_data,
                                                                           FILENAME_CRASH_FUNCTION);
                 if((done = (bool)crash_func))
-                    strbuf_append_strf(buf_dsc, "%s: %*s%s(): %s\n", key, pad, "", crash_func, output);
+                    output_printf(out, "%s: %*s%s(): %s\n", key, pad, "", crash_func, output);
             }
             else if (strcmp(FILENAME_UID, key) == 0)
             {
                 const char *username = problem_data_get_content_or_NULL(problem_data,
                                                                           FILENAME_USERNAME);
                 if((done = (bool)username))
-                    strbuf_append_strf(buf_dsc, "%s: %*s%s (%s)\n", key, pad, "", output, username);
+                    output_printf(out, "%s: %*s%s (%s)\n", key, pad, "", output, username);
             }
 
             if (!done)
-                strbuf_append_strf(buf_dsc, "%s: %*s%s\n", key, pad, "", output);
+                output_printf(out, "%s: %*s%s\n", key, pad, "", output);
 
             empty = false;
             free(formatted);
@@ -146,7 +239,7 @@ char *make_description(problem_data_t *problem_data, char **names_to_skip,
     if (desc_flags & MAKEDESC_SHOW_URLS)
     {
         if (problem_data_get_content_or_NULL(problem_data, FILENAME_NOT_REPORTABLE) != NULL)
-            strbuf_append_strf(buf_dsc, "%s%*s%s\n", _("Reported:"), 16 - strlen(_("Reported:")), "" , _("cannot be reported"));
+            output_printf(out, "%s%*s%s\n", _("Reported:"), 16 - strlen(_("Reported:")), "" , _("cannot be reported"));
         else
         {
             const char *reported_to = problem_data_get_content_or_NULL(problem_data, FILENAME_REPORTED_TO);
@@ -166,7 +259,7 @@ char *make_description(problem_data_t *problem_data, char **names_to_skip,
                     if (report->url == NULL)
                         continue;
 
-                    strbuf_append_strf(buf_dsc, "%s%s\n", prefix, report->url);
+                    output_printf(out, "%s%s\n", prefix, report->url);
 
                     if (prefix == first_prefix)
                     {   /* Only the first URL is prefixed by 'Reported:' */
@@ -213,7 +306,7 @@ char *make_description(problem_data_t *problem_data, char **names_to_skip,
              || ((item->flags & CD_FLAG_TXT) && strlen(item->content) > max_text_size)
             ) {
                 if (append_empty_line)
-                    strbuf_append_char(buf_dsc, '\n');
+                    output_write_str(out, "\n");
                 append_empty_line = false;
 
                 unsigned long size = 0;
@@ -224,7 +317,7 @@ char *make_description(problem_data_t *problem_data, char **names_to_skip,
                  */
                 int pad = 16 - (strlen(key) + 2);
                 if (pad < 0) pad = 0;
-                strbuf_append_strf(buf_dsc,
+                output_printf(out,
                         (!stat_err ? "%s: %*s%s file, %lu bytes\n" : "%s: %*s%s file\n"),
                         key,
                         pad, "",
@@ -268,17 +361,10 @@ char *make_description(problem_data_t *problem_data, char **names_to_skip,
                     || (!strcmp(type, "Kerneloops") && !strcmp(key, FILENAME_BACKTRACE))))
             {
                 char *formatted = problem_item_format(item);
-                char *output = make_description_item_multiline(key, formatted ? formatted : item->content);
 
-                if (output)
-                {
-                    if (!empty)
-                        strbuf_append_str(buf_dsc, "\n");
-
-                    strbuf_append_str(buf_dsc, output);
+                if (write_description_item_multiline(out, /*separate:*/ !empty, key,
+                                                     formatted ? formatted : item->content))
                     empty = false;
-                    free(output);
-                }
 
                 free(formatted);
             }
@@ -286,10 +372,67 @@ char *make_description(problem_data_t *problem_data, char **names_to_skip,
     }
 
     g_list_free(list);
+}
+
+int make_description_cb(description_writer_t writer, void *param,
+                        problem_data_t *problem_data, char **names_to_skip,
+                        unsigned max_text_size, unsigned desc_flags,
+                        unsigned long max_size)
+{
+    INITIALIZE_LIBREPORT();
+
+    struct description_output *out = xzalloc(sizeof(*out));
+    out->writer = writer;
+    out->param = param;
+    out->max_size = max_size;
+
+    write_description(out, problem_data, names_to_skip, max_text_size, desc_flags);
+    output_flush(out);
+
+    if (out->truncated)
+        log_info("The description was truncated to %lu bytes", max_size);
+
+    const int r = out->error;
+    free(out);
+    return r;
+}
+
+static int write_to_strbuf(void *param, const char *data, size_t len)
+{
+    strbuf_append_strn((struct strbuf *)param, data, len);
+    return 0;
+}
+
+static int write_to_fd(void *param, const char *data, size_t len)
+{
+    if (full_write(*(int *)param, data, len) != (ssize_t)len)
+    {
+        const int r = -errno;
+        perror_msg("Can't write the description");
+        return r;
+    }
+    return 0;
+}
+
+char *make_description(problem_data_t *problem_data, char **names_to_skip,
+                       unsigned max_text_size, unsigned desc_flags)
+{
+    struct strbuf *buf_dsc = strbuf_new();
+
+    make_description_cb(write_to_strbuf, buf_dsc, problem_data, names_to_skip,
+                        max_text_size, desc_flags, /*unlimited*/ 0);
 
     return strbuf_free_nobuf(buf_dsc);
 }
 
+int make_description_fd(int fd, problem_data_t *problem_data, char **names_to_skip,
+                        unsigned max_text_size, unsigned desc_flags,
+                        unsigned long max_size)
+{
+    return make_description_cb(write_to_fd, &fd, problem_data, names_to_skip,
+                               max_text_size, desc_flags, max_size);
+}
+
 /* Items we don't want to include to bz / logger */
 static const char *const blacklisted_items[] = {
     CD_DUMPDIR        ,
@@ -319,3 +462,16 @@ char* make_description_logger(problem_data_t *problem_data, unsigned max_text_si
                 MAKEDESC_SHOW_FILES | MAKEDESC_SHOW_MULTILINE
     );
 }
+
+int make_description_logger_fd(int fd, problem_data_t *problem_data, unsigned max_text_size,
+                               unsigned long max_size)
+{
+    return make_description_fd(
+                fd,
+                problem_data,
+                (char**)blacklisted_items,
+                max_text_size,
+                MAKEDESC_SHOW_FILES | MAKEDESC_SHOW_MULTILINE,
+                max_size
+    );
+}
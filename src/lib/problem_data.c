@@ -23,6 +23,7 @@ static void free_problem_item(void *ptr)
     if (ptr)
     {
         struct problem_item *item = (struct problem_item *)ptr;
+        problem_item_unmap(item);
         free(item->content);
         free(item);
     }
@@ -78,6 +79,80 @@ int problem_item_get_size(struct problem_item *item, unsigned long *size)
     return 0;
 }
 
+const char *problem_item_get_data(struct problem_item *item, size_t *size)
+{
+    if (item->flags & CD_FLAG_MAPPED)
+    {
+        *size = item->mapped_size;
+        return item->mapped_data;
+    }
+
+    if (item->flags & CD_FLAG_TXT)
+    {
+        *size = strlen(item->content);
+        return item->content;
+    }
+
+    /* else if (item->flags & CD_FLAG_BIN) */
+
+    /* The same checks as dd_map_item(): the item is opened relative to its
+     * directory by secure_openat_read(), hence no symbolic links, no hard
+     * links and no FIFOs */
+    char *dir_name = xstrdup(item->content);
+    char *base_name = strrchr(dir_name, '/');
+    if (base_name == NULL || base_name[1] == '\0')
+    {
+        free(dir_name);
+        errno = EINVAL;
+        return NULL;
+    }
+    *base_name++ = '\0';
+
+    const int dir_fd = open(dir_name[0] != '\0' ? dir_name : "/", O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (dir_fd < 0)
+    {
+        free(dir_name);
+        return NULL;
+    }
+
+    const int fd = secure_openat_read(dir_fd, base_name);
+    close(dir_fd);
+    free(dir_name);
+    if (fd < 0)
+    {
+        errno = -fd;
+        return NULL;
+    }
+
+    void *data = mmap_fd_read(fd, size);
+    const int err = errno;
+    close(fd);
+
+    if (data == NULL)
+    {
+        errno = err;
+        return NULL;
+    }
+
+    item->mapped_data = data;
+    item->mapped_size = *size;
+    item->size = *size;
+    item->flags |= CD_FLAG_MAPPED;
+
+    return data;
+}
+
+void problem_item_unmap(struct problem_item *item)
+{
+    if (!(item->flags & CD_FLAG_MAPPED))
+        return;
+
+    munmap_fd_read(item->mapped_data, item->mapped_size);
+    item->mapped_data = NULL;
+    item->mapped_size = 0;
+    item->flags &= ~CD_FLAG_MAPPED;
+}
+
 /* problem_data["name"] = { "content", CD_FLAG_foo_bits } */
 
 problem_data_t *problem_data_new(void)
@@ -494,6 +569,49 @@ int problem_data_load_dump_dir_element(struct dump_dir *dd, const char *name, ch
     return _problem_data_load_dump_dir_element(dd, name, content, type_flags, fd);
 }
 
+static bool is_excluded_element(const char *short_name, char **excluding)
+{
+    if (excluding && is_in_string_list(short_name, (const char *const *)excluding))
+    {
+        //log_warning("Excluded:'%s'", short_name);
+        return true;
+    }
+
+    if (short_name[0] == '#'
+     || (short_name[0] && short_name[strlen(short_name) - 1] == '~')
+    ) {
+        //log_warning("Excluded (editor backup file):'%s'", short_name);
+        return true;
+    }
+
+    return false;
+}
+
+static int get_text_element_flags(const char *short_name, int flags)
+{
+    if (is_editable_file(short_name))
+        flags |= CD_FLAG_ISEDITABLE;
+    else
+        flags |= CD_FLAG_ISNOTEDITABLE;
+
+    static const char *const list_files[] = {
+        FILENAME_UID       ,
+        FILENAME_PACKAGE   ,
+        FILENAME_CMDLINE   ,
+        FILENAME_TIME      ,
+        FILENAME_COUNT     ,
+        FILENAME_REASON    ,
+        NULL
+    };
+    if (is_in_string_list(short_name, list_files))
+        flags |= CD_FLAG_LIST;
+
+    if (strcmp(short_name, FILENAME_TIME) == 0)
+        flags |= CD_FLAG_UNIXTIME;
+
+    return flags;
+}
+
 void problem_data_load_from_dump_dir(problem_data_t *problem_data, struct dump_dir *dd, char **excluding)
 {
     char *short_name;
@@ -502,18 +620,8 @@ void problem_data_load_from_dump_dir(problem_data_t *problem_data, struct dump_d
     dd_init_next_file(dd);
     while (dd_get_next_file(dd, &short_name, &full_name))
     {
-        if (excluding && is_in_string_list(short_name, (const char *const *)excluding))
-        {
-            //log_warning("Excluded:'%s'", short_name);
+        if (is_excluded_element(short_name, excluding))
             goto next;
-        }
-
-        if (short_name[0] == '#'
-         || (short_name[0] && short_name[strlen(short_name) - 1] == '~')
-        ) {
-            //log_warning("Excluded (editor backup file):'%s'", short_name);
-            goto next;
-        }
 
         char *content = NULL;
         int flags = 0;
@@ -525,27 +633,7 @@ void problem_data_load_from_dump_dir(problem_data_t *problem_data, struct dump_d
         }
 
         if (flags & CD_FLAG_TXT)
-        {
-            if (is_editable_file(short_name))
-                flags |= CD_FLAG_ISEDITABLE;
-            else
-                flags |= CD_FLAG_ISNOTEDITABLE;
-
-            static const char *const list_files[] = {
-                FILENAME_UID       ,
-                FILENAME_PACKAGE   ,
-                FILENAME_CMDLINE   ,
-                FILENAME_TIME      ,
-                FILENAME_COUNT     ,
-                FILENAME_REASON    ,
-                NULL
-            };
-            if (is_in_string_list(short_name, list_files))
-                flags |= CD_FLAG_LIST;
-
-            if (strcmp(short_name, FILENAME_TIME) == 0)
-                flags |= CD_FLAG_UNIXTIME;
-        }
+            flags = get_text_element_flags(short_name, flags);
         else
         {
             content = full_name;
@@ -564,6 +652,108 @@ void problem_data_load_from_dump_dir(problem_data_t *problem_data, struct dump_d
     }
 }
 
+/* Parallel loading
+ *
+ * Every element costs several synchronous syscalls (open, fstat, reopen,
+ * read the probe, seek, read the rest, close). On network file systems
+ * the latency of those round trips dominates, so the elements are loaded
+ * by a small pool of threads and the results are added to problem data
+ * in the calling thread.
+ */
+
+/* Below this number of elements threads are not worth the overhead */
+#define LOAD_PARALLEL_MIN_ELEMENTS 8
+#define LOAD_PARALLEL_MAX_THREADS  8
+
+struct load_job
+{
+    struct dump_dir *dd;
+    char *name;
+    char *content;
+    int flags;
+    int error;
+};
+
+static void load_job_run(gpointer data, gpointer user_data)
+{
+    struct load_job *job = data;
+
+    job->error = _problem_data_load_dump_dir_element(job->dd, job->name, &job->content, &job->flags, /*fd*/NULL);
+}
+
+void problem_data_load_from_dump_dir_parallel(problem_data_t *problem_data, struct dump_dir *dd, char **excluding)
+{
+    /* Collect names with a single pass over the directory.
+     * is_regular_file_at() needs no stat call if the file system provides d_type.
+     */
+    if (dd_init_next_file(dd) == NULL)
+        return;
+
+    GPtrArray *jobs = g_ptr_array_new();
+    struct dirent *dent;
+    while ((dent = readdir(dd->next_dir)) != NULL)
+    {
+        if (!is_regular_file_at(dent, dd->dd_fd))
+            continue;
+
+        if (is_excluded_element(dent->d_name, excluding))
+            continue;
+
+        struct load_job *job = xzalloc(sizeof(*job));
+        job->dd = dd;
+        job->name = xstrdup(dent->d_name);
+        g_ptr_array_add(jobs, job);
+    }
+    dd_clear_next_file(dd);
+
+    GThreadPool *pool = NULL;
+    if (jobs->len >= LOAD_PARALLEL_MIN_ELEMENTS)
+    {
+        const int threads = MIN(jobs->len / 2, LOAD_PARALLEL_MAX_THREADS);
+        GError *error = NULL;
+        pool = g_thread_pool_new(load_job_run, NULL, threads, /*exclusive*/TRUE, &error);
+        if (pool == NULL)
+        {
+            log_notice("Can't create a thread pool, loading elements serially: %s", error->message);
+            g_error_free(error);
+        }
+    }
+
+    for (unsigned i = 0; i < jobs->len; ++i)
+    {
+        if (pool != NULL)
+            g_thread_pool_push(pool, g_ptr_array_index(jobs, i), NULL);
+        else
+            load_job_run(g_ptr_array_index(jobs, i), NULL);
+    }
+
+    if (pool != NULL)
+        /* Wait for all jobs to finish */
+        g_thread_pool_free(pool, /*immediate*/FALSE, /*wait*/TRUE);
+
+    for (unsigned i = 0; i < jobs->len; ++i)
+    {
+        struct load_job *job = g_ptr_array_index(jobs, i);
+
+        if (job->error < 0)
+            error_msg("Failed to load element %s: %s", job->name, strerror(-job->error));
+        else if (job->flags & CD_FLAG_TXT)
+            problem_data_add(problem_data, job->name, job->content,
+                    get_text_element_flags(job->name, job->flags));
+        else
+        {
+            char *full_name = concat_path_file(dd->dd_dirname, job->name);
+            problem_data_add(problem_data, job->name, full_name, job->flags);
+            free(full_name);
+        }
+
+        free(job->content);
+        free(job->name);
+        free(job);
+    }
+    g_ptr_array_free(jobs, TRUE);
+}
+
 problem_data_t *create_problem_data_from_dump_dir(struct dump_dir *dd)
 {
     problem_data_t *problem_data = problem_data_new();
@@ -578,7 +768,7 @@ problem_data_t *create_problem_data_for_reporting(const char *dump_dir_name)
         return NULL; /* dd_opendir already emitted error msg */
     string_vector_ptr_t exclude_items = get_global_always_excluded_elements();
     problem_data_t *problem_data = problem_data_new();
-    problem_data_load_from_dump_dir(problem_data, dd, exclude_items);
+    problem_data_load_from_dump_dir_parallel(problem_data, dd, exclude_items);
     dd_close(dd);
     string_vector_free(exclude_items);
     return problem_data;
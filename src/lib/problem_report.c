@@ -98,14 +98,20 @@
  *   }
  * }
  */
+struct summary_template;
+
 struct section_t {
     char *name;      ///< name or output text (%summar, 'Package version:');
     GList *items;    ///< list of file names and special items (%reporter, %binar, ...)
     GList *children; ///< list of sub sections (struct section_t)
+    struct summary_template *summary; ///< compiled items of %summary
 };
 
 typedef struct section_t section_t;
 
+static struct summary_template *summary_template_compile(const char *format);
+static void summary_template_free(struct summary_template *self);
+
 static section_t *
 section_new(const char *name)
 {
@@ -113,6 +119,7 @@ section_new(const char *name)
     self->name = xstrdup(name);
     self->items = NULL;
     self->children = NULL;
+    self->summary = NULL;
 
     return self;
 }
@@ -126,6 +133,7 @@ section_free(section_t *self)
     free(self->name);
     g_list_free_full(self->items, free);
     g_list_free_full(self->children, (GDestroyNotify)section_free);
+    summary_template_free(self->summary);
 
     free(self);
 }
@@ -271,6 +279,8 @@ load_stream(FILE *fp)
 
         sec = section_new(line);
         sec->items = item_list;
+        if (summary_line)
+            sec->summary = summary_template_compile(item_list->data);
 
         if (sec->name[0] == '%')
         {
@@ -303,80 +313,118 @@ load_stream(FILE *fp)
 
 /* Summary generation */
 
+/*
+ * The %summary format is compiled once when the format is loaded to a list of
+ * instructions and every report is rendered from the instructions.
+ *
+ * "[abrt] %package%[[: %reason%]]" ->
+ * { LITERAL "[abrt] ", ITEM "package", OPT_BEGIN, LITERAL ": ", ITEM "reason", OPT_END }
+ */
+enum summary_op_type
+{
+    SUMMARY_OP_LITERAL,   ///< text without escapes
+    SUMMARY_OP_ITEM,      ///< content of a text item, text is its interned name
+    SUMMARY_OP_OPT_BEGIN, ///< '[[' start of an optional group
+    SUMMARY_OP_OPT_END,   ///< ']]' end of an optional group
+};
+
+struct summary_op
+{
+    enum summary_op_type so_type;
+    const char *so_text;
+    unsigned so_len;      ///< length of literal text
+};
+
+struct summary_template
+{
+    char *st_format;            ///< source format string
+    char *st_literals;          ///< storage of unescaped literal runs
+    struct summary_op *st_ops;
+    unsigned st_ops_cnt;
+};
+
 #define MAX_OPT_DEPTH 10
-static int
-format_percented_string(const char *str, problem_data_t *pd, FILE *result)
+static struct summary_template *
+summary_template_compile(const char *format)
 {
-    long old_pos[MAX_OPT_DEPTH] = { 0 };
-    int okay[MAX_OPT_DEPTH] = { 1 };
-    long len = 0;
+    const size_t format_len = strlen(format);
+
+    struct summary_template *self = xzalloc(sizeof(*self));
+    self->st_format = xstrdup(format);
+    /* Unescaped literals are never longer than the format and every
+     * instruction consumes at least one character of the format.
+     */
+    self->st_literals = xmalloc(format_len + 1);
+    self->st_ops = xmalloc((format_len + 1) * sizeof(self->st_ops[0]));
+
+    char *lit = self->st_literals;
+    struct summary_op *literal = NULL;
     int opt_depth = 1;
+    const char *str = format;
 
-    while (*str) {
-        switch (*str) {
-        default:
-            putc(*str, result);
-            len++;
-            str++;
-            break;
+    while (*str)
+    {
+        enum summary_op_type type = SUMMARY_OP_LITERAL;
+        const char *item_name = NULL;
+
+        switch (*str)
+        {
         case '\\':
             if (str[1])
                 str++;
-            putc(*str, result);
-            len++;
-            str++;
             break;
         case '[':
             if (str[1] == '[' && opt_depth < MAX_OPT_DEPTH)
             {
-                old_pos[opt_depth] = len;
-                okay[opt_depth] = 1;
+                type = SUMMARY_OP_OPT_BEGIN;
                 opt_depth++;
                 str += 2;
-            } else {
-                putc(*str, result);
-                len++;
-                str++;
             }
             break;
         case ']':
             if (str[1] == ']' && opt_depth > 1)
             {
+                type = SUMMARY_OP_OPT_END;
                 opt_depth--;
-                if (!okay[opt_depth])
-                {
-                    if (fseek(result, old_pos[opt_depth], SEEK_SET) < 0)
-                        perror_msg_and_die("fseek");
-                    len = old_pos[opt_depth];
-                }
                 str += 2;
-            } else {
-                putc(*str, result);
-                len++;
-                str++;
             }
             break;
         case '%': ;
-            char *nextpercent = strchr(++str, '%');
+            const char *nextpercent = strchr(str + 1, '%');
             if (!nextpercent)
             {
-                error_msg_and_die("Unterminated %%element%%: '%s'", str - 1);
+                error_msg_and_die("Unterminated %%element%%: '%s'", str);
             }
 
-            *nextpercent = '\0';
-            const problem_item *item = problem_data_get_item_or_NULL(pd, str);
-            *nextpercent = '%';
+            char *name = xstrndup(str + 1, nextpercent - (str + 1));
+            item_name = g_intern_string(name);
+            free(name);
 
-            if (item && (item->flags & CD_FLAG_TXT))
-            {
-                fputs(item->content, result);
-                len += strlen(item->content);
-            }
-            else
-                okay[opt_depth - 1] = 0;
+            type = SUMMARY_OP_ITEM;
             str = nextpercent + 1;
             break;
         }
+
+        if (type == SUMMARY_OP_LITERAL)
+        {
+            /* Join adjacent characters into one literal run */
+            if (literal == NULL)
+            {
+                literal = &self->st_ops[self->st_ops_cnt++];
+                literal->so_type = SUMMARY_OP_LITERAL;
+                literal->so_text = lit;
+                literal->so_len = 0;
+            }
+            *lit++ = *str++;
+            literal->so_len++;
+            continue;
+        }
+
+        literal = NULL;
+        struct summary_op *op = &self->st_ops[self->st_ops_cnt++];
+        op->so_type = type;
+        op->so_text = item_name;
+        op->so_len = 0;
     }
 
     if (opt_depth > 1)
@@ -384,18 +432,88 @@ format_percented_string(const char *str, problem_data_t *pd, FILE *result)
         error_msg_and_die("Unbalanced [[ ]] bracket");
     }
 
+    return self;
+}
+
+static void
+summary_template_free(struct summary_template *self)
+{
+    if (self == NULL)
+        return;
+
+    free(self->st_format);
+    free(self->st_literals);
+    free(self->st_ops);
+    free(self);
+}
+
+static void
+summary_template_render(const struct summary_template *self, problem_data_t *pd, struct strbuf *result)
+{
+    int old_len[MAX_OPT_DEPTH] = { 0 };
+    int okay[MAX_OPT_DEPTH] = { 1 };
+    int opt_depth = 1;
+
+    for (unsigned i = 0; i < self->st_ops_cnt; ++i)
+    {
+        const struct summary_op *op = &self->st_ops[i];
+        switch (op->so_type)
+        {
+        case SUMMARY_OP_LITERAL:
+            strbuf_append_strn(result, op->so_text, op->so_len);
+            break;
+        case SUMMARY_OP_ITEM: ;
+            const problem_item *item = problem_data_get_item_or_NULL(pd, op->so_text);
+            if (item && (item->flags & CD_FLAG_TXT))
+                strbuf_append_str(result, item->content);
+            else
+                okay[opt_depth - 1] = 0;
+            break;
+        case SUMMARY_OP_OPT_BEGIN:
+            old_len[opt_depth] = result->len;
+            okay[opt_depth] = 1;
+            opt_depth++;
+            break;
+        case SUMMARY_OP_OPT_END:
+            opt_depth--;
+            if (!okay[opt_depth])
+            {
+                /* Drop the whole group */
+                result->len = old_len[opt_depth];
+                result->buf[result->len] = '\0';
+            }
+            break;
+        }
+    }
+
     if (!okay[0])
     {
         error_msg("Undefined variable outside of [[ ]] bracket");
     }
-
-    return 0;
 }
 
 /* BZ comment generation */
 
+/* Returns how many more bytes are worth appending to a section limited to
+ * max_size bytes. One byte over the limit is enough for truncate_section(). */
 static int
-append_text(struct strbuf *result, const char *item_name, const char *content, bool print_item_name)
+section_room(const struct strbuf *result, size_t max_size)
+{
+    if (max_size == 0)
+        return INT_MAX;
+
+    if ((size_t)result->len > max_size)
+        return 0;
+
+    return MIN(max_size - result->len + 1, INT_MAX);
+}
+
+/* Appends the item. Once the section is longer than max_size (if not 0), the
+ * rest of the item is not appended, so the section never gets much longer
+ * than the limit. */
+static int
+append_text(struct strbuf *result, const char *item_name, const char *content, bool print_item_name,
+            size_t max_size)
 {
     char *eol = strchrnul(content, '\n');
     if (eol[0] == '\0' || eol[1] == '\0')
@@ -406,13 +524,13 @@ append_text(struct strbuf *result, const char *item_name, const char *content, b
             pad = 0;
         if (print_item_name)
             strbuf_append_strf(result,
-                    eol[0] == '\0' ? "%s: %*s%s\n" : "%s: %*s%s",
-                    item_name, pad, "", content
+                    eol[0] == '\0' ? "%s: %*s%.*s\n" : "%s: %*s%.*s",
+                    item_name, pad, "", section_room(result, max_size), content
             );
         else
             strbuf_append_strf(result,
-                    eol[0] == '\0' ? "%s\n" : "%s",
-                    content
+                    eol[0] == '\0' ? "%.*s\n" : "%.*s",
+                    section_room(result, max_size), content
             );
     }
     else
@@ -422,11 +540,15 @@ append_text(struct strbuf *result, const char *item_name, const char *content, b
             strbuf_append_strf(result, "%s:\n", item_name);
         for (;;)
         {
+            const int room = section_room(result, max_size);
+            if (room == 0)
+                break;
+
             eol = strchrnul(content, '\n');
             strbuf_append_strf(result,
                     /* For %bare_multiline_item, we don't want to print colons */
                     (print_item_name ? ":%.*s\n" : "%.*s\n"),
-                    (int)(eol - content), content
+                    (int)MIN(eol - content, room), content
             );
             if (eol[0] == '\0' || eol[1] == '\0')
                 break;
@@ -436,8 +558,73 @@ append_text(struct strbuf *result, const char *item_name, const char *content, b
     return 1;
 }
 
+/*
+ * Short backtraces are cached in the dump directory as
+ * "<key>\n<short backtrace>" where the key is a hash of all inputs of the
+ * short backtrace. Parsing of large backtraces is slow and the short
+ * backtrace is generated for every report of the problem.
+ *
+ * Formatting has no side effects unless the caller passes its dump directory
+ * to problem_formatter_generate_report_ext(); the cache is written only if
+ * the caller holds the lock.
+ */
+#define SHORT_BACKTRACE_CACHE "short_backtrace"
+
+static void
+short_backtrace_cache_key(char key[SHA1_RESULT_LEN*2 + 1], const char *type,
+                          const char *source_name, const char *content, int max_frames)
+{
+    char frames[sizeof(int)*3 + 2];
+    snprintf(frames, sizeof(frames), "%d", max_frames);
+
+    sha1_ctx_t ctx;
+    sha1_begin(&ctx);
+    /* Include the terminating '\0' to separate the inputs */
+    sha1_hash(&ctx, type, strlen(type) + 1);
+    sha1_hash(&ctx, source_name, strlen(source_name) + 1);
+    sha1_hash(&ctx, frames, strlen(frames) + 1);
+    sha1_hash(&ctx, content, strlen(content));
+
+    uint8_t hash[SHA1_RESULT_LEN];
+    sha1_end(&ctx, hash);
+    *bin2hex(key, (const char *)hash, SHA1_RESULT_LEN) = '\0';
+}
+
+static char *
+short_backtrace_cache_load(struct dump_dir *dd, const char *key)
+{
+    char *cached = dd_load_cached_text(dd, SHORT_BACKTRACE_CACHE);
+    if (cached == NULL)
+        return NULL;
+
+    const size_t key_len = strlen(key);
+    if (strncmp(cached, key, key_len) != 0 || cached[key_len] != '\n')
+    {
+        log_debug("Cached short backtrace is out of date");
+        free(cached);
+        return NULL;
+    }
+
+    overlapping_strcpy(cached, cached + key_len + 1);
+    return cached;
+}
+
+static void
+short_backtrace_cache_save(struct dump_dir *dd, const char *key, const char *short_backtrace)
+{
+    /* Only the caller holding the lock may write to the dump directory */
+    if (!dd->locked)
+        return;
+
+    char *data = xasprintf("%s\n%s", key, short_backtrace);
+    if (dd_save_cached_text(dd, SHORT_BACKTRACE_CACHE, data) == 0)
+        log_debug("Short backtrace cached in '%s'", dd->dd_dirname);
+    free(data);
+}
+
 static int
-append_short_backtrace(struct strbuf *result, problem_data_t *problem_data, bool print_item_name, problem_report_settings_t *settings)
+append_short_backtrace(struct strbuf *result, problem_data_t *problem_data, bool print_item_name, problem_report_settings_t *settings,
+                       struct dump_dir *dd)
 {
     const problem_item *backtrace_item = problem_data_get_item_or_NULL(problem_data,
                                                                        FILENAME_BACKTRACE);
@@ -479,6 +666,22 @@ append_short_backtrace(struct strbuf *result, problem_data_t *problem_data, bool
         }
 
         const char *content = backtrace_item ? backtrace_item->content : core_stacktrace_item->content;
+
+        char cache_key[SHA1_RESULT_LEN*2 + 1];
+        if (dd != NULL)
+        {
+            short_backtrace_cache_key(cache_key, type,
+                    backtrace_item ? FILENAME_BACKTRACE : FILENAME_CORE_BACKTRACE,
+                    content, settings->prs_shortbt_max_frames);
+
+            truncated = short_backtrace_cache_load(dd, cache_key);
+            if (truncated != NULL)
+            {
+                log_debug("Using cached short backtrace");
+                goto append;
+            }
+        }
+
         struct sr_stacktrace *backtrace = sr_stacktrace_parse(report_type, content, &error_msg);
 
         if (!backtrace)
@@ -501,24 +704,30 @@ append_short_backtrace(struct strbuf *result, problem_data_t *problem_data, bool
             log_warning(_("Can't generate stacktrace description (no crash thread?)"));
             return 0;
         }
+
+        if (dd != NULL)
+            short_backtrace_cache_save(dd, cache_key, truncated);
     }
     else
     {
         log_debug("'backtrace' is small enough to be included as is");
     }
 
+ append:
     /* full item content  */
     append_text(result,
                 /*item_name:*/ truncated ? "truncated_backtrace" : FILENAME_BACKTRACE,
                 /*content:*/   truncated ? truncated             : backtrace_item->content,
-                print_item_name
+                print_item_name,
+                settings->prs_max_section_size
     );
     free(truncated);
     return 1;
 }
 
 static int
-append_item(struct strbuf *result, const char *item_name, problem_data_t *pd, GList *comment_fmt_spec, problem_report_settings_t *settings)
+append_item(struct strbuf *result, const char *item_name, problem_data_t *pd, GList *comment_fmt_spec, problem_report_settings_t *settings,
+            struct dump_dir *dd)
 {
     bool print_item_name = (strncmp(item_name, "%bare_", strlen("%bare_")) != 0);
     if (!print_item_name)
@@ -534,7 +743,7 @@ append_item(struct strbuf *result, const char *item_name, problem_data_t *pd, GL
 
         char *formatted = problem_item_format(item);
         char *content = formatted ? formatted : item->content;
-        append_text(result, item_name, content, print_item_name);
+        append_text(result, item_name, content, print_item_name, settings->prs_max_section_size);
         free(formatted);
         return 1; /* "I printed something" */
     }
@@ -543,11 +752,12 @@ append_item(struct strbuf *result, const char *item_name, problem_data_t *pd, GL
 
     /* Compat with previously-existed ad-hockery: %short_backtrace */
     if (strcmp(item_name, "%short_backtrace") == 0)
-        return append_short_backtrace(result, pd, print_item_name, settings);
+        return append_short_backtrace(result, pd, print_item_name, settings, dd);
 
     /* Compat with previously-existed ad-hockery: %reporter */
     if (strcmp(item_name, "%reporter") == 0)
-        return append_text(result, "reporter", PACKAGE"-"VERSION, print_item_name);
+        return append_text(result, "reporter", PACKAGE"-"VERSION, print_item_name,
+                           settings->prs_max_section_size);
 
     /* %oneline,%multiline,%text */
     bool oneline   = (strcmp(item_name+1, "oneline"  ) == 0);
@@ -585,12 +795,17 @@ append_item(struct strbuf *result, const char *item_name, problem_data_t *pd, GL
         if (is_explicit_or_forbidden(name, comment_fmt_spec))
             continue;
 
+        /* Do not format the remaining items of a full section */
+        if (section_room(result, settings->prs_max_section_size) == 0)
+            break;
+
         char *formatted = problem_item_format(item);
         char *content = formatted ? formatted : item->content;
         char *eol = strchrnul(content, '\n');
         bool is_oneline = (eol[0] == '\0' || eol[1] == '\0');
         if (oneline == is_oneline)
-            printed |= append_text(result, name, content, print_item_name);
+            printed |= append_text(result, name, content, print_item_name,
+                                   settings->prs_max_section_size);
         free(formatted);
     }
     if (text && oneline)
@@ -606,15 +821,35 @@ append_item(struct strbuf *result, const char *item_name, problem_data_t *pd, GL
     return printed;
 }
 
-#define add_to_section_output(format, ...) \
-    do { \
-    for (; empty_lines > 0; --empty_lines) fputc('\n', result); \
-    empty_lines = 0; \
-    fprintf(result, format, __VA_ARGS__); \
-    } while (0)
+static void
+flush_empty_lines(struct strbuf *result, int *empty_lines)
+{
+    for (; *empty_lines > 0; --*empty_lines)
+        strbuf_append_char(result, '\n');
+    *empty_lines = 0;
+}
+
+/* Returns true if the output has been truncated to max_size */
+static bool
+truncate_section(struct strbuf *result, size_t max_size)
+{
+    if (max_size == 0 || (size_t)result->len <= max_size)
+        return false;
+
+    /* Do not split UTF-8 characters */
+    size_t len = max_size;
+    while (len > 0 && ((unsigned char)result->buf[len] & 0xC0) == 0x80)
+        --len;
+
+    result->len = len;
+    result->buf[len] = '\0';
+    strbuf_append_str(result, DESCRIPTION_TRUNCATED_MARK);
+    return true;
+}
 
 static void
-format_section(section_t *section, problem_data_t *pd, GList *comment_fmt_spec, FILE *result, problem_report_settings_t *settings)
+format_section(section_t *section, problem_data_t *pd, GList *comment_fmt_spec, struct strbuf *result, problem_report_settings_t *settings,
+               struct dump_dir *dd)
 {
     int empty_lines = -1;
 
@@ -623,8 +858,19 @@ format_section(section_t *section, problem_data_t *pd, GList *comment_fmt_spec,
         section_t *child = (section_t *)iter->data;
         if (child->items)
         {
-            /* "Text: item[,item]..." */
-            struct strbuf *output = strbuf_new();
+            /* "Text: item[,item]..."
+             *
+             * The text and the pending empty lines are written in advance and
+             * dropped if no item is printed.
+             */
+            const int mark = result->len;
+            const int pending_empty_lines = empty_lines;
+
+            flush_empty_lines(result, &empty_lines);
+            if (child->name[0])
+                strbuf_append_strf(result, "%s:\n", child->name);
+
+            const int items_start = result->len;
             GList *item = child->items;
             while (item)
             {
@@ -632,14 +878,15 @@ format_section(section_t *section, problem_data_t *pd, GList *comment_fmt_spec,
                 item = item->next;
                 if (str[0] == '-') /* "-name", ignore it */
                     continue;
-                append_item(output, str, pd, comment_fmt_spec, settings);
+                append_item(result, str, pd, comment_fmt_spec, settings, dd);
             }
 
-            if (output->len != 0)
-                add_to_section_output((child->name[0] ? "%s:\n%s" : "%s%s"),
-                                      child->name, output->buf);
-
-            strbuf_free(output);
+            if (result->len == items_start)
+            {
+                result->len = mark;
+                result->buf[mark] = '\0';
+                empty_lines = pending_empty_lines;
+            }
         }
         else
         {
@@ -647,11 +894,20 @@ format_section(section_t *section, problem_data_t *pd, GList *comment_fmt_spec,
 
             /* Filter out trailint empty lines */
             if (child->name[0] != '\0')
-                add_to_section_output("%s\n", child->name);
+            {
+                flush_empty_lines(result, &empty_lines);
+                strbuf_append_strf(result, "%s\n", child->name);
+            }
             /* Do not count empty lines, if output wasn't yet produced */
             else if (empty_lines >= 0)
                 ++empty_lines;
         }
+
+        if (truncate_section(result, settings->prs_max_section_size))
+        {
+            log_info("Section '%s' truncated to %zu bytes", section->name, settings->prs_max_section_size);
+            break;
+        }
     }
 }
 
@@ -1034,8 +1290,9 @@ struct problem_formatter
 {
     GList *pf_sections;         ///< parsed sections (struct section_t)
     GList *pf_extra_sections;   ///< user configured sections (struct extra_section)
-    char  *pf_default_summary;  ///< default summary format
+    struct summary_template *pf_default_summary; ///< default summary format
     problem_report_settings_t pf_settings; ///< settings for report generating
+    char pf_digest[SHA1_RESULT_LEN*2 + 1]; ///< SHA-1 of the loaded format
 };
 
 static problem_report_settings_t
@@ -1044,6 +1301,7 @@ problem_report_settings_init(void)
     problem_report_settings_t settings = {
         .prs_shortbt_max_frames = 10,
         .prs_shortbt_max_text_size = CD_TEXT_ATT_SIZE_BZ,
+        .prs_max_section_size = 0,
     };
 
     return settings;
@@ -1064,8 +1322,9 @@ problem_formatter_new(void)
 {
     problem_formatter_t *self = xzalloc(sizeof(*self));
 
-    self->pf_default_summary = xstrdup("%reason%");
+    self->pf_default_summary = summary_template_compile("%reason%");
     self->pf_settings = problem_report_settings_init();
+    str_to_sha1str(self->pf_digest, "");
 
     return self;
 }
@@ -1082,7 +1341,7 @@ problem_formatter_free(problem_formatter_t *self)
     g_list_free_full(self->pf_extra_sections, (GDestroyNotify)extra_section_free);
     self->pf_extra_sections = DESTROYED_POINTER;
 
-    free(self->pf_default_summary);
+    summary_template_free(self->pf_default_summary);
     self->pf_default_summary = DESTROYED_POINTER;
 
     free(self);
@@ -1155,10 +1414,9 @@ problem_formatter_validate(problem_formatter_t *self)
     return retval;
 }
 
-int
-problem_formatter_load_string(problem_formatter_t *self, const char *fmt)
+static int
+problem_formatter_load_buffer(problem_formatter_t *self, const char *fmt, size_t len)
 {
-    const size_t len = strlen(fmt);
     if (len != 0)
     {
         FILE *fp = fmemopen((void *)fmt, len, "r");
@@ -1172,31 +1430,52 @@ problem_formatter_load_string(problem_formatter_t *self, const char *fmt)
         fclose(fp);
     }
 
+    sha1_ctx_t ctx;
+    uint8_t hash[SHA1_RESULT_LEN];
+    sha1_begin(&ctx);
+    sha1_hash(&ctx, fmt, len);
+    sha1_end(&ctx, hash);
+    *bin2hex(self->pf_digest, (const char *)hash, SHA1_RESULT_LEN) = '\0';
+
     return problem_formatter_validate(self);
 }
 
+int
+problem_formatter_load_string(problem_formatter_t *self, const char *fmt)
+{
+    return problem_formatter_load_buffer(self, fmt, strlen(fmt));
+}
+
 int
 problem_formatter_load_file(problem_formatter_t *self, const char *path)
 {
-    FILE *fp = stdin;
-    if (strcmp(path, "-") != 0)
-    {
-        fp = fopen(path, "r");
-        if (!fp)
-            return -ENOENT;
-    }
+    /* Read the whole file to compute the digest of the format, the format
+     * is a text and the read buffer is NUL-terminated */
+    char *fmt = NULL;
+    if (strcmp(path, "-") == 0)
+        fmt = xmalloc_read(STDIN_FILENO, /*maxsize:*/ NULL);
+    else
+        fmt = xmalloc_open_read_close(path, /*maxsize:*/ NULL);
 
-    self->pf_sections = load_stream(fp);
+    if (fmt == NULL)
+        return -ENOENT;
 
-    if (fp != stdin)
-        fclose(fp);
+    const int retval = problem_formatter_load_buffer(self, fmt, strlen(fmt));
+    free(fmt);
+    return retval;
+}
 
-    return problem_formatter_validate(self);
+/* Sections are rendered to a string buffer and written to the report's stream
+ * at once */
+static void
+write_to_buffer(problem_report_buffer *buffer, const struct strbuf *output)
+{
+    if (output->len != 0)
+        fwrite(output->buf, 1, output->len, buffer);
 }
 
-// generates report
-int
-problem_formatter_generate_report(const problem_formatter_t *self, problem_data_t *data, problem_report_t **report)
+static problem_report_t *
+problem_formatter_render_report(const problem_formatter_t *self, problem_data_t *data, struct dump_dir *dd)
 {
     problem_report_settings_t settings = problem_formatter_get_settings(self);
 
@@ -1205,6 +1484,7 @@ problem_formatter_generate_report(const problem_formatter_t *self, problem_data_
     for (GList *iter = self->pf_extra_sections; iter; iter = g_list_next(iter))
         problem_report_add_custom_section(pr, ((struct extra_section *)iter->data)->pfes_name);
 
+    struct strbuf *output = strbuf_new();
     bool has_summary = false;
     for (GList *iter = self->pf_sections; iter; iter = g_list_next(iter))
     {
@@ -1214,8 +1494,10 @@ problem_formatter_generate_report(const problem_formatter_t *self, problem_data_
         if (strcmp(section->name, "%summary") == 0)
         {
             has_summary = true;
-            format_percented_string((const char *)section->items->data, data,
-                                    problem_report_get_buffer(pr, PR_SEC_SUMMARY));
+            strbuf_clear(output);
+            summary_template_render(section->summary, data, output);
+            truncate_section(output, settings.prs_max_section_size);
+            write_to_buffer(problem_report_get_buffer(pr, PR_SEC_SUMMARY), output);
         }
         /* %attach as well */
         else if (strcmp(section->name, "%attach") == 0)
@@ -1229,7 +1511,9 @@ problem_formatter_generate_report(const problem_formatter_t *self, problem_data_
             if (buffer != NULL)
             {
                 log_debug("Formatting section : '%s'", section->name);
-                format_section(section, data, self->pf_sections, buffer, &settings);
+                strbuf_clear(output);
+                format_section(section, data, self->pf_sections, output, &settings, dd);
+                write_to_buffer(buffer, output);
             }
             else
                 log_warning("Unsupported section '%s'", section->name);
@@ -1238,10 +1522,251 @@ problem_formatter_generate_report(const problem_formatter_t *self, problem_data_
 
     if (!has_summary) {
         log_debug("Problem format misses section '%%summary'. Using the default one : '%s'.",
-                    self->pf_default_summary);
+                    self->pf_default_summary->st_format);
+
+        strbuf_clear(output);
+        summary_template_render(self->pf_default_summary, data, output);
+        truncate_section(output, settings.prs_max_section_size);
+        write_to_buffer(problem_report_get_buffer(pr, PR_SEC_SUMMARY), output);
+    }
+
+    strbuf_free(output);
+
+    return pr;
+}
+
+/*
+ * Rendered report cache
+ *
+ * The reporters of a workflow often use the same format for the same problem.
+ * The rendered report is cached in the dump directory under a name derived
+ * from the format digest:
+ *
+ * <key>\n
+ * S <section name> <length>\n<section text>
+ * A <length>\n<attachment name>
+ *
+ * The key is a hash of everything the report is rendered from: the format,
+ * the extra sections, the settings, the locale and all problem elements.
+ * Like the short backtrace cache, it is written only to a locked dump
+ * directory passed by the caller.
+ */
+#define REPORT_CACHE_VERSION "1"
+
+static void
+sha1_hash_str(sha1_ctx_t *ctx, const char *str)
+{
+    /* Include the terminating '\0' to separate the inputs */
+    sha1_hash(ctx, str, strlen(str) + 1);
+}
+
+static void
+report_cache_key(const problem_formatter_t *self, problem_data_t *data, char key[SHA1_RESULT_LEN*2 + 1])
+{
+    sha1_ctx_t ctx;
+    sha1_begin(&ctx);
+
+    sha1_hash_str(&ctx, REPORT_CACHE_VERSION);
+    sha1_hash_str(&ctx, PACKAGE"-"VERSION);
+    sha1_hash_str(&ctx, self->pf_digest);
+
+    const char *locale = setlocale(LC_ALL, NULL);
+    sha1_hash_str(&ctx, locale ? locale : "");
+
+    for (GList *iter = self->pf_extra_sections; iter; iter = g_list_next(iter))
+    {
+        const struct extra_section *section = iter->data;
+        sha1_hash_str(&ctx, section->pfes_name);
+    }
 
-        format_percented_string(self->pf_default_summary,
-                   data, problem_report_get_buffer(pr, PR_SEC_SUMMARY));
+    char *settings = xasprintf("%d %zu %zu",
+            self->pf_settings.prs_shortbt_max_frames,
+            self->pf_settings.prs_shortbt_max_text_size,
+            self->pf_settings.prs_max_section_size);
+    sha1_hash_str(&ctx, settings);
+    free(settings);
+
+    GList *names = g_hash_table_get_keys(data);
+    names = g_list_sort(names, (GCompareFunc)strcmp);
+    for (GList *iter = names; iter; iter = g_list_next(iter))
+    {
+        const struct problem_item *item = g_hash_table_lookup(data, iter->data);
+        const char type = (item->flags & CD_FLAG_TXT) ? 'T' : ((item->flags & CD_FLAG_BIN) ? 'B' : '-');
+
+        sha1_hash_str(&ctx, iter->data);
+        sha1_hash(&ctx, &type, 1);
+        sha1_hash_str(&ctx, item->content);
+    }
+    g_list_free(names);
+
+    uint8_t hash[SHA1_RESULT_LEN];
+    sha1_end(&ctx, hash);
+    *bin2hex(key, (const char *)hash, SHA1_RESULT_LEN) = '\0';
+}
+
+static char *
+report_cache_name(const problem_formatter_t *self)
+{
+    return xasprintf("report-%.16s", self->pf_digest);
+}
+
+static bool
+report_cache_parse(const char *cached, problem_report_t *pr)
+{
+    GList *attachments = NULL;
+
+    while (*cached)
+    {
+        const char type = cached[0];
+        if (cached[1] != ' ')
+            goto fail;
+        cached += 2;
+
+        char *name = NULL;
+        if (type == 'S')
+        {
+            const char *space = strchr(cached, ' ');
+            if (space == NULL)
+                goto fail;
+            name = xstrndup(cached, space - cached);
+            cached = space + 1;
+        }
+        else if (type != 'A')
+            goto fail;
+
+        char *end = NULL;
+        errno = 0;
+        const unsigned long len = strtoul(cached, &end, 10);
+        if (errno != 0 || end == cached || *end != '\n' || strnlen(end + 1, len) != len)
+        {
+            free(name);
+            goto fail;
+        }
+        cached = end + 1;
+
+        if (type == 'S')
+        {
+            problem_report_buffer *buffer = problem_report_get_buffer(pr, name);
+            free(name);
+            if (buffer == NULL)
+                goto fail;
+            fwrite(cached, 1, len, buffer);
+        }
+        else
+            attachments = g_list_append(attachments, xstrndup(cached, len));
+
+        cached += len;
+    }
+
+    problem_report_set_attachments(pr, attachments);
+    return true;
+
+fail:
+    log_notice("Cached report is corrupted");
+    g_list_free_full(attachments, free);
+    return false;
+}
+
+static problem_report_t *
+report_cache_load(const problem_formatter_t *self, struct dump_dir *dd, const char *key)
+{
+    char *name = report_cache_name(self);
+    char *cached = dd_load_cached_text(dd, name);
+    free(name);
+
+    if (cached == NULL)
+        return NULL;
+
+    problem_report_t *pr = NULL;
+    const size_t key_len = strlen(key);
+    if (strncmp(cached, key, key_len) != 0 || cached[key_len] != '\n')
+    {
+        log_debug("Cached report is out of date");
+        goto finito;
+    }
+
+    pr = problem_report_new();
+    for (GList *iter = self->pf_extra_sections; iter; iter = g_list_next(iter))
+        problem_report_add_custom_section(pr, ((struct extra_section *)iter->data)->pfes_name);
+
+    if (!report_cache_parse(cached + key_len + 1, pr))
+    {
+        problem_report_free(pr);
+        pr = NULL;
+    }
+
+finito:
+    free(cached);
+    return pr;
+}
+
+static void
+report_cache_append_section(struct strbuf *buf, const char *name, const char *text)
+{
+    strbuf_append_strf(buf, "S %s %zu\n", name, strlen(text));
+    strbuf_append_str(buf, text);
+}
+
+static void
+report_cache_save(const problem_formatter_t *self, struct dump_dir *dd, const char *key,
+                  const problem_report_t *pr)
+{
+    /* Only the caller holding the lock may write to the dump directory */
+    if (!dd->locked)
+        return;
+
+    struct strbuf *buf = strbuf_new();
+    strbuf_append_strf(buf, "%s\n", key);
+
+    report_cache_append_section(buf, PR_SEC_SUMMARY, problem_report_get_summary(pr));
+    report_cache_append_section(buf, PR_SEC_DESCRIPTION, problem_report_get_description(pr));
+    for (GList *iter = self->pf_extra_sections; iter; iter = g_list_next(iter))
+    {
+        const char *name = ((struct extra_section *)iter->data)->pfes_name;
+        report_cache_append_section(buf, name, problem_report_get_section(pr, name));
+    }
+
+    for (GList *iter = problem_report_get_attachments(pr); iter; iter = g_list_next(iter))
+    {
+        strbuf_append_strf(buf, "A %zu\n", strlen(iter->data));
+        strbuf_append_str(buf, iter->data);
+    }
+
+    char *name = report_cache_name(self);
+    if (dd_save_cached_text(dd, name, buf->buf) == 0)
+        log_debug("Rendered report cached in '%s'", dd->dd_dirname);
+    free(name);
+
+    strbuf_free(buf);
+}
+
+// generates report
+int
+problem_formatter_generate_report(const problem_formatter_t *self, problem_data_t *data, problem_report_t **report)
+{
+    return problem_formatter_generate_report_ext(self, data, /*dump dir:*/ NULL, report);
+}
+
+int
+problem_formatter_generate_report_ext(const problem_formatter_t *self, problem_data_t *data,
+                                      struct dump_dir *dd, problem_report_t **report)
+{
+    if (dd == NULL)
+    {
+        *report = problem_formatter_render_report(self, data, NULL);
+        return 0;
+    }
+
+    char key[SHA1_RESULT_LEN*2 + 1];
+    report_cache_key(self, data, key);
+
+    problem_report_t *pr = report_cache_load(self, dd, key);
+    if (pr != NULL)
+        log_debug("Using cached report");
+    else
+    {
+        pr = problem_formatter_render_report(self, data, dd);
+        report_cache_save(self, dd, key, pr);
     }
 
     *report = pr;
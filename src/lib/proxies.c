@@ -18,13 +18,14 @@
 */
 #include "internal_libreport.h"
 #include "proxies.h"
+#include "http_cache.h"
 
 #ifdef HAVE_PROXY
 #include <proxy.h>
 
 static pxProxyFactory *px_factory;
 
-GList *get_proxy_list(const char *url)
+static GList *lookup_proxy_list(const char *url)
 {
     int i;
     GList *l;
@@ -57,6 +58,21 @@ GList *get_proxy_list(const char *url)
     return l;
 }
 
+GList *get_proxy_list(const char *url)
+{
+    /* libproxy may need to download and evaluate a PAC file, the decisions
+     * are therefore shared by reporters run one after another */
+    bool cached = false;
+    GList *l = http_cache_get_proxy_list(url, &cached);
+    if (cached)
+        return l;
+
+    l = lookup_proxy_list(url);
+    http_cache_put_proxy_list(url, l);
+
+    return l;
+}
+
 #else
 
 GList *get_proxy_list(const char *url)
@@ -114,6 +114,48 @@ ssize_t full_write(int fd, const void *buf, size_t len)
     return total;
 }
 
+/* Writes all iovecs, restarting after short writes.
+ * NB: modifies the iov array while advancing over already written data.
+ */
+ssize_t full_writev(int fd, struct iovec *iov, int iovcnt)
+{
+    ssize_t cc;
+    ssize_t total;
+
+    total = 0;
+
+    while (iovcnt)
+    {
+        do {
+            cc = writev(fd, iov, iovcnt);
+        } while (cc < 0 && errno == EINTR);
+
+        if (cc < 0)
+        {
+            if (total)
+                return total;
+            return cc;  /* writev() returns -1 on failure. */
+        }
+
+        total += cc;
+
+        /* skip fully written entries, advance into the partially written one */
+        while (iovcnt && (size_t)cc >= iov->iov_len)
+        {
+            cc -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt)
+        {
+            iov->iov_base = (char *)iov->iov_base + cc;
+            iov->iov_len -= cc;
+        }
+    }
+
+    return total;
+}
+
 ssize_t full_write_str(int fd, const char *buf)
 {
     return full_write(fd, buf, strlen(buf));
@@ -170,6 +212,49 @@ void* xmalloc_read(int fd, size_t *maxsz_p)
     return buf;
 }
 
+/* Maps entire regular file read-only. Meant for consumers which only stream
+ * or hash data, big files then don't have to be copied to the heap.
+ * Empty files can't be mmaped; a pointer to "" with size 0 is returned.
+ * Returns NULL and sets errno on errors.
+ */
+void *mmap_fd_read(int fd, size_t *size)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        return NULL;
+
+    if (!S_ISREG(st.st_mode))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    if ((uintmax_t)st.st_size > SIZE_MAX)
+    {
+        errno = EFBIG;
+        return NULL;
+    }
+
+    *size = st.st_size;
+    if (*size == 0)
+        return (void *)"";
+
+    void *data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+        return NULL;
+
+    /* Consumers read the data from the beginning to the end */
+    madvise(data, *size, MADV_SEQUENTIAL);
+
+    return data;
+}
+
+void munmap_fd_read(void *data, size_t size)
+{
+    if (data != NULL && size != 0)
+        munmap(data, size);
+}
+
 void* xmalloc_open_read_close(const char *filename, size_t *maxsz_p)
 {
     char *buf;
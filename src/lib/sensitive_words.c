@@ -0,0 +1,409 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include "internal_libreport.h"
+#include "sensitive_words.h"
+
+#define NO_NODE -1
+
+/* A node of the trie of all words, the root is the node 0 */
+struct sw_node
+{
+    int child;      /* the first child */
+    int sibling;    /* the next child of the parent */
+    int fail;       /* the longest proper suffix which is a node */
+    int dict;       /* the longest proper suffix which ends a word */
+    int word;       /* the first word ending here */
+    unsigned char byte;
+};
+
+struct sw_word
+{
+    char *text;
+    size_t len;
+    bool ignored;
+    int next;       /* the next word ending in the same node */
+};
+
+struct sensitive_words
+{
+    int flags;
+    struct sw_node *nodes;
+    unsigned nodes_cnt;
+    unsigned nodes_size;
+    struct sw_word *words;
+    unsigned words_cnt;
+    /* Transitions from the root, most scanned characters do not start a word */
+    int root_next[256];
+};
+
+/* An occurrence of an ignored word */
+struct sw_range
+{
+    size_t start;
+    size_t end;
+};
+
+/* Writes the lower case form of the character to folded if it has the same
+ * length, so offsets in the folded text are offsets in the text.
+ *
+ * @returns the length of the character
+ */
+static size_t fold_char(const char *text, size_t len, char *folded)
+{
+    const unsigned char c = text[0];
+    if (c < 0x80)
+    {
+        folded[0] = g_ascii_tolower(c);
+        return 1;
+    }
+
+    const gunichar uc = g_utf8_get_char_validated(text, len);
+    if (uc == (gunichar)-1 || uc == (gunichar)-2)
+    {
+        /* Not UTF-8, process it byte by byte */
+        folded[0] = c;
+        return 1;
+    }
+
+    const size_t clen = g_utf8_skip[c];
+    const gunichar lc = g_unichar_tolower(uc);
+    if ((size_t)g_unichar_to_utf8(lc, NULL) == clen)
+        g_unichar_to_utf8(lc, folded);
+    else
+        memcpy(folded, text, clen);
+
+    return clen;
+}
+
+static char *fold_word(const char *word, size_t len)
+{
+    char *folded = xmalloc(len + 1);
+    for (size_t i = 0; i < len; )
+        i += fold_char(word + i, len - i, folded + i);
+    folded[len] = '\0';
+
+    return folded;
+}
+
+static int find_child(const sensitive_words_t *self, int node, unsigned char byte)
+{
+    int child = self->nodes[node].child;
+    while (child != NO_NODE && self->nodes[child].byte != byte)
+        child = self->nodes[child].sibling;
+
+    return child;
+}
+
+static int add_node(sensitive_words_t *self, int parent, unsigned char byte)
+{
+    if (self->nodes_cnt == self->nodes_size)
+    {
+        self->nodes_size = self->nodes_size ? self->nodes_size * 2 : 64;
+        self->nodes = xrealloc(self->nodes, self->nodes_size * sizeof(*self->nodes));
+    }
+
+    const int node = self->nodes_cnt++;
+    self->nodes[node].child = NO_NODE;
+    self->nodes[node].sibling = NO_NODE;
+    self->nodes[node].fail = 0;
+    self->nodes[node].dict = NO_NODE;
+    self->nodes[node].word = NO_NODE;
+    self->nodes[node].byte = byte;
+
+    if (parent != NO_NODE)
+    {
+        self->nodes[node].sibling = self->nodes[parent].child;
+        self->nodes[parent].child = node;
+    }
+
+    return node;
+}
+
+static void add_word(sensitive_words_t *self, const char *word, bool ignored)
+{
+    const size_t len = strlen(word);
+    if (len == 0)
+        return;
+
+    /* Ignored words are matched exactly, the match is verified in the text */
+    char *key = (self->flags & SENSITIVE_WORDS_CASE_INSENSITIVE)
+                ? fold_word(word, len)
+                : xstrdup(word);
+
+    int node = 0;
+    for (size_t i = 0; i < len; ++i)
+    {
+        const unsigned char byte = key[i];
+        int child = find_child(self, node, byte);
+        if (child == NO_NODE)
+            child = add_node(self, node, byte);
+        node = child;
+    }
+    free(key);
+
+    /* Drop duplicates, the default lists contain words in several cases */
+    for (int w = self->nodes[node].word; w != NO_NODE; w = self->words[w].next)
+        if (self->words[w].ignored == ignored
+            && (!ignored || strcmp(self->words[w].text, word) == 0))
+            return;
+
+    self->words = xrealloc(self->words, (self->words_cnt + 1) * sizeof(*self->words));
+    struct sw_word *sw = self->words + self->words_cnt;
+    sw->text = xstrdup(word);
+    sw->len = len;
+    sw->ignored = ignored;
+    sw->next = self->nodes[node].word;
+    self->nodes[node].word = self->words_cnt++;
+}
+
+static void build_links(sensitive_words_t *self)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(self->root_next); ++i)
+        self->root_next[i] = 0;
+
+    /* Breadth-first, the links point to shorter nodes */
+    int *queue = xmalloc(self->nodes_cnt * sizeof(*queue));
+    unsigned head = 0;
+    unsigned tail = 0;
+
+    for (int child = self->nodes[0].child; child != NO_NODE; child = self->nodes[child].sibling)
+    {
+        self->root_next[self->nodes[child].byte] = child;
+        queue[tail++] = child;
+    }
+
+    while (head < tail)
+    {
+        const int node = queue[head++];
+
+        for (int child = self->nodes[node].child; child != NO_NODE; child = self->nodes[child].sibling)
+        {
+            const unsigned char byte = self->nodes[child].byte;
+
+            int fail = self->nodes[node].fail;
+            int next = find_child(self, fail, byte);
+            while (next == NO_NODE && fail != 0)
+            {
+                fail = self->nodes[fail].fail;
+                next = find_child(self, fail, byte);
+            }
+
+            const int target = next == NO_NODE ? 0 : next;
+            self->nodes[child].fail = target;
+            self->nodes[child].dict = self->nodes[target].word != NO_NODE
+                                      ? target
+                                      : self->nodes[target].dict;
+            queue[tail++] = child;
+        }
+    }
+
+    free(queue);
+}
+
+sensitive_words_t *sensitive_words_new(GList *words, GList *ignored_words, int flags)
+{
+    sensitive_words_t *self = xzalloc(sizeof(*self));
+    self->flags = flags;
+    add_node(self, NO_NODE, '\0');
+
+    for (GList *iter = words; iter; iter = g_list_next(iter))
+        add_word(self, iter->data, /*ignored*/false);
+    for (GList *iter = ignored_words; iter; iter = g_list_next(iter))
+        add_word(self, iter->data, /*ignored*/true);
+
+    build_links(self);
+
+    log_debug("Compiled %u words into %u nodes", self->words_cnt, self->nodes_cnt);
+    return self;
+}
+
+sensitive_words_t *sensitive_words_load_default(int flags)
+{
+    GList *words = load_words_from_file(SENSITIVE_WORDS_FILE);
+    GList *ignored_words = load_words_from_file(IGNORED_WORDS_FILE);
+
+    sensitive_words_t *self = sensitive_words_new(words, ignored_words, flags);
+
+    list_free_with_free(ignored_words);
+    list_free_with_free(words);
+
+    return self;
+}
+
+void sensitive_words_free(sensitive_words_t *self)
+{
+    if (!self)
+        return;
+
+    for (unsigned i = 0; i < self->words_cnt; ++i)
+        free(self->words[i].text);
+    free(self->words);
+    free(self->nodes);
+    free(self);
+}
+
+void sensitive_word_matches_free(GList *matches)
+{
+    g_list_free_full(matches, free);
+}
+
+static int compare_matches(const struct sensitive_word_match *a, const struct sensitive_word_match *b)
+{
+    if (a->swm_start != b->swm_start)
+        return a->swm_start < b->swm_start ? -1 : 1;
+    if (a->swm_end != b->swm_end)
+        return a->swm_end < b->swm_end ? -1 : 1;
+    return 0;
+}
+
+static int compare_ranges(const void *a, const void *b)
+{
+    const struct sw_range *ra = a;
+    const struct sw_range *rb = b;
+    if (ra->start != rb->start)
+        return ra->start < rb->start ? -1 : 1;
+    return 0;
+}
+
+/* Removes the matches lying within an occurrence of an ignored word */
+static GList *drop_ignored(GList *matches, struct sw_range *ignored, size_t ignored_cnt)
+{
+    qsort(ignored, ignored_cnt, sizeof(*ignored), compare_ranges);
+
+    /* The furthest end of the ignored words starting before the match */
+    size_t max_end = 0;
+    size_t i = 0;
+
+    GList *iter = matches;
+    while (iter)
+    {
+        GList *next = g_list_next(iter);
+        struct sensitive_word_match *match = iter->data;
+
+        for (; i < ignored_cnt && ignored[i].start <= match->swm_start; ++i)
+            if (ignored[i].end > max_end)
+                max_end = ignored[i].end;
+
+        if (i != 0 && max_end >= match->swm_end)
+        {
+            free(match);
+            matches = g_list_delete_link(matches, iter);
+        }
+
+        iter = next;
+    }
+
+    return matches;
+}
+
+GList *sensitive_words_scan(const sensitive_words_t *self, const char *text, size_t len)
+{
+    GList *matches = NULL;
+    struct sw_range *ignored = NULL;
+    size_t ignored_cnt = 0;
+
+    const bool fold = self->flags & SENSITIVE_WORDS_CASE_INSENSITIVE;
+    char folded[8];
+    size_t folded_len = 0;
+
+    int node = 0;
+    for (size_t i = 0; i < len; )
+    {
+        /* Feed the automaton by characters to fold them */
+        if (fold)
+            folded_len = fold_char(text + i, len - i, folded);
+        else
+        {
+            folded[0] = text[i];
+            folded_len = 1;
+        }
+
+        for (size_t j = 0; j < folded_len; ++j)
+        {
+            const unsigned char byte = folded[j];
+            const size_t end = i + j + 1;
+
+            int next = NO_NODE;
+            while (node != 0 && (next = find_child(self, node, byte)) == NO_NODE)
+                node = self->nodes[node].fail;
+            node = node == 0 ? self->root_next[byte] : next;
+
+            const int first = self->nodes[node].word != NO_NODE ? node : self->nodes[node].dict;
+            for (int out = first; out != NO_NODE; out = self->nodes[out].dict)
+            {
+                for (int w = self->nodes[out].word; w != NO_NODE; w = self->words[w].next)
+                {
+                    const struct sw_word *word = self->words + w;
+                    const size_t start = end - word->len;
+
+                    if (word->ignored)
+                    {
+                        if (fold && memcmp(text + start, word->text, word->len) != 0)
+                            continue;
+
+                        ignored = xrealloc(ignored, (ignored_cnt + 1) * sizeof(*ignored));
+                        ignored[ignored_cnt].start = start;
+                        ignored[ignored_cnt].end = end;
+                        ++ignored_cnt;
+                        continue;
+                    }
+
+                    struct sensitive_word_match *match = xmalloc(sizeof(*match));
+                    match->swm_start = start;
+                    match->swm_end = end;
+                    match->swm_word = word->text;
+                    matches = g_list_prepend(matches, match);
+                }
+            }
+        }
+
+        i += folded_len;
+    }
+
+    matches = g_list_sort(matches, (GCompareFunc)compare_matches);
+
+    if (ignored_cnt != 0)
+        matches = drop_ignored(matches, ignored, ignored_cnt);
+    free(ignored);
+
+    return matches;
+}
+
+GHashTable *sensitive_words_scan_problem_data(const sensitive_words_t *self, problem_data_t *problem_data)
+{
+    GHashTable *result = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                               free, (GDestroyNotify)sensitive_word_matches_free);
+
+    GHashTableIter iter;
+    gpointer name;
+    gpointer value;
+    g_hash_table_iter_init(&iter, problem_data);
+    while (g_hash_table_iter_next(&iter, &name, &value))
+    {
+        const struct problem_item *item = value;
+        if (!(item->flags & CD_FLAG_TXT) || item->content == NULL)
+            continue;
+
+        GList *matches = sensitive_words_scan(self, item->content, strlen(item->content));
+        if (matches)
+            g_hash_table_insert(result, xstrdup(name), matches);
+    }
+
+    return result;
+}
@@ -233,6 +233,15 @@ struct strbuf *strbuf_append_str(struct strbuf *strbuf, const char *str)
     return strbuf;
 }
 
+struct strbuf *strbuf_append_strn(struct strbuf *strbuf, const char *str, unsigned len)
+{
+    char *p = strbuf_grow(strbuf, len);
+    assert(strbuf->len < strbuf->alloc);
+    memcpy(p, str, len);
+    p[len] = '\0';
+    return strbuf;
+}
+
 struct strbuf *strbuf_prepend_str(struct strbuf *strbuf, const char *str)
 {
     unsigned cur_len = strbuf->len;
@@ -26,6 +26,9 @@
 #include "ureport.h"
 #include "libreport_curl.h"
 
+/* Generating uReports is CPU bound (satyr parses the backtraces) */
+#define UREPORT_BATCH_MAX_THREADS 8
+
 #define DESTROYED_POINTER (void *)0xdeadbeef
 
 #define BTHASH_URL_SFX "reports/bthash/"
@@ -281,12 +284,27 @@ ureport_server_config_load_basic_auth(struct ureport_server_config *config,
     free_map_string(settings);
 }
 
+static int
+ureport_content_encoding_from_string(const char *value)
+{
+    int encoding = post_encoding_from_string(value);
+    if (encoding < 0)
+    {
+        log_warning(_("Unsupported ContentEncoding '%s', reports will not be compressed"), value);
+        encoding = POST_ENCODING_IDENTITY;
+    }
+
+    return encoding;
+}
+
 void
 ureport_server_config_load(struct ureport_server_config *config,
                            map_string_t *settings)
 {
     UREPORT_OPTION_VALUE_FROM_CONF(settings, "URL", config->ur_url, xstrdup);
     UREPORT_OPTION_VALUE_FROM_CONF(settings, "SSLVerify", config->ur_ssl_verify, string_to_bool);
+    UREPORT_OPTION_VALUE_FROM_CONF(settings, "ContentEncoding", config->ur_content_encoding,
+                                   ureport_content_encoding_from_string);
 
     const char *http_auth_pref = NULL;
     UREPORT_OPTION_VALUE_FROM_CONF(settings, "HTTPAuth", http_auth_pref, (const char *));
@@ -325,6 +343,7 @@ ureport_server_config_init(struct ureport_server_config *config)
     config->ur_username = NULL;
     config->ur_password = NULL;
     config->ur_http_headers = new_map_string();
+    config->ur_content_encoding = POST_ENCODING_IDENTITY;
 
     config->ur_prefs.urp_auth_items = NULL;
     config->ur_prefs.urp_flags = 0;
@@ -711,7 +730,14 @@ ureport_from_dump_dir_ext(const char *dump_dir_path, const struct ureport_prefer
     {
         struct dump_dir *dd = dd_opendir(dump_dir_path, DD_OPEN_READONLY);
         if (!dd)
-            xfunc_die(); /* dd_opendir() already printed an error message */
+        {
+            /* dd_opendir() already printed an error message */
+            if (!(preferences->urp_flags & UREPORT_PREF_FLAG_RETURN_ON_FAILURE))
+                xfunc_die();
+
+            sr_report_free(report);
+            return NULL;
+        }
 
         GList *iter = preferences->urp_auth_items;
         for ( ; iter != NULL; iter = g_list_next(iter))
@@ -745,9 +771,74 @@ ureport_from_dump_dir(const char *dump_dir_path)
     return ureport_from_dump_dir_ext(dump_dir_path, /*no preferences*/NULL);
 }
 
-struct post_state *
-ureport_do_post(const char *json, struct ureport_server_config *config,
-                const char *url_sfx)
+struct ureport_job
+{
+    const char *dump_dir_path;
+    const struct ureport_preferences *preferences;
+    char *json;
+};
+
+static void
+ureport_job_run(gpointer data, gpointer user_data)
+{
+    struct ureport_job *job = data;
+    job->json = ureport_from_dump_dir_ext(job->dump_dir_path, job->preferences);
+}
+
+char **
+ureport_from_dump_dirs(const char *const *dump_dir_paths, unsigned count,
+                       const struct ureport_preferences *preferences)
+{
+    /* One broken directory must not stop the others */
+    struct ureport_preferences prefs = { .urp_auth_items = NULL };
+    if (preferences != NULL)
+        prefs = *preferences;
+    prefs.urp_flags |= UREPORT_PREF_FLAG_RETURN_ON_FAILURE;
+
+    struct ureport_job *jobs = xzalloc(sizeof(*jobs) * (count + 1));
+    for (unsigned i = 0; i < count; ++i)
+    {
+        jobs[i].dump_dir_path = dump_dir_paths[i];
+        jobs[i].preferences = &prefs;
+    }
+
+    GThreadPool *pool = NULL;
+    if (count > 1)
+    {
+        const int threads = MIN(count, UREPORT_BATCH_MAX_THREADS);
+        GError *error = NULL;
+        pool = g_thread_pool_new(ureport_job_run, NULL, threads, /*exclusive*/TRUE, &error);
+        if (pool == NULL)
+        {
+            log_notice("Can't create a thread pool, generating uReports serially: %s", error->message);
+            g_error_free(error);
+        }
+    }
+
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (pool != NULL)
+            g_thread_pool_push(pool, &jobs[i], NULL);
+        else
+            ureport_job_run(&jobs[i], NULL);
+    }
+
+    if (pool != NULL)
+        /* Wait for all jobs to finish */
+        g_thread_pool_free(pool, /*immediate*/FALSE, /*wait*/TRUE);
+
+    char **json_ureports = xmalloc(sizeof(char *) * (count + 1));
+    for (unsigned i = 0; i < count; ++i)
+        json_ureports[i] = jobs[i].json;
+    json_ureports[count] = NULL;
+
+    free(jobs);
+    return json_ureports;
+}
+
+static struct post_state *
+ureport_do_post_in_session(const char *json, struct ureport_server_config *config,
+                           const char *url_sfx, http_session_t *session)
 {
     int flags = POST_WANT_BODY | POST_WANT_ERROR_MSG;
 
@@ -755,6 +846,8 @@ ureport_do_post(const char *json, struct ureport_server_config *config,
         flags |= POST_WANT_SSL_VERIFY;
 
     struct post_state *post_state = new_post_state(flags);
+    post_state->session = session;
+    post_state->content_encoding = config->ur_content_encoding;
 
     if (config->ur_client_cert && config->ur_client_key)
     {
@@ -768,14 +861,13 @@ ureport_do_post(const char *json, struct ureport_server_config *config,
         post_state->password = config->ur_password;
     }
 
-    char **headers = xmalloc(sizeof(char *) * (3 + size_map_string(config->ur_http_headers)));
+    char **headers = xmalloc(sizeof(char *) * (2 + size_map_string(config->ur_http_headers)));
     headers[0] = (char *)"Accept: application/json";
-    headers[1] = (char *)"Connection: close";
-    headers[2] = NULL;
+    headers[1] = NULL;
 
     if (config->ur_http_headers != NULL)
     {
-        unsigned i = 2;
+        unsigned i = 1;
         const char *header;
         const char *value;
         map_string_iter_t iter;
@@ -801,6 +893,8 @@ ureport_do_post(const char *json, struct ureport_server_config *config,
         warn_msg("Authentication failed. Retrying unauthenticated.");
         free_post_state(post_state);
         post_state = new_post_state(flags);
+        post_state->session = session;
+        post_state->content_encoding = config->ur_content_encoding;
 
         post_string_as_form_data(post_state, dest_url, "application/json",
                          (const char **)headers, json);
@@ -810,12 +904,19 @@ ureport_do_post(const char *json, struct ureport_server_config *config,
     free(dest_url);
 
     for (unsigned i = size_map_string(config->ur_http_headers); i != 0; --i)
-        free(headers[i + 1]);
+        free(headers[i]);
     free(headers);
 
     return post_state;
 }
 
+struct post_state *
+ureport_do_post(const char *json, struct ureport_server_config *config,
+                const char *url_sfx)
+{
+    return ureport_do_post_in_session(json, config, url_sfx, /*thread's session*/NULL);
+}
+
 struct ureport_server_response *
 ureport_submit(const char *json, struct ureport_server_config *config)
 {
@@ -833,6 +934,68 @@ ureport_submit(const char *json, struct ureport_server_config *config)
     return resp;
 }
 
+struct ureport_server_response **
+ureport_submit_many(const char *const *json_ureports, unsigned count,
+                    struct ureport_server_config *config)
+{
+    struct ureport_server_response **responses = xzalloc(sizeof(*responses) * (count + 1));
+
+    /* The uReports go one after another through one kept-alive connection,
+     * the server processes them in order anyway */
+    http_session_t *session = new_http_session();
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (json_ureports[i] == NULL)
+            continue;
+
+        struct post_state *post_state = ureport_do_post_in_session(json_ureports[i], config,
+                                                                   UREPORT_SUBMIT_ACTION, session);
+        /* The remaining uReports would wait for the same timeout */
+        const bool unreachable = post_state->curl_result != CURLE_OK;
+        responses[i] = ureport_server_response_from_reply(post_state, config);
+        free_post_state(post_state);
+
+        if (unreachable)
+        {
+            error_msg(_("Not submitting the remaining uReports, '%s' is unreachable"), config->ur_url);
+            break;
+        }
+    }
+    free_http_session(session);
+
+    return responses;
+}
+
+unsigned
+ureport_submit_dump_dirs(const char *const *dump_dir_paths, unsigned count,
+                         struct ureport_server_config *config)
+{
+    char **json_ureports = ureport_from_dump_dirs(dump_dir_paths, count, &config->ur_prefs);
+    struct ureport_server_response **responses =
+        ureport_submit_many((const char *const *)json_ureports, count, config);
+
+    unsigned submitted = 0;
+    for (unsigned i = 0; i < count; ++i)
+    {
+        struct ureport_server_response *response = responses[i];
+        if (json_ureports[i] == NULL)
+            error_msg(_("Failed to generate microreport from the problem data in '%s'"), dump_dir_paths[i]);
+        else if (response == NULL)
+            log_notice("uReport of '%s' was not submitted", dump_dir_paths[i]);
+        else if (response->urr_is_error)
+            error_msg(_("Server responded with an error: '%s'"), response->urr_value);
+        else if (ureport_server_response_save_in_dump_dir(response, dump_dir_paths[i], config))
+            ++submitted;
+
+        ureport_server_response_free(response);
+        free(json_ureports[i]);
+    }
+
+    free(responses);
+    free(json_ureports);
+    return submitted;
+}
+
 char *
 ureport_json_attachment_new(const char *bthash, const char *type, const char *data)
 {
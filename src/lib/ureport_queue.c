@@ -0,0 +1,716 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include <sys/file.h>
+#include <json.h>
+
+#include "internal_libreport.h"
+#include "ureport.h"
+#include "libreport_curl.h"
+
+#define UREPORT_QUEUE_SPOOL_DIR LOCALSTATEDIR"/spool/libreport/ureport"
+#define UREPORT_QUEUE_USER_DIR "libreport/ureport-queue"
+#define UREPORT_QUEUE_LOCK ".lock"
+#define UREPORT_QUEUE_ENTRY_SFX ".ureport"
+#define UREPORT_QUEUE_SENDING_SFX ".sending."
+#define UREPORT_QUEUE_BACKOFF_SFX ".backoff"
+
+#define UREPORT_QUEUE_MAX_ENTRY_SIZE (16 * 1024 * 1024)
+
+/* The back-off after the first failure, doubled after every next one */
+#define UREPORT_QUEUE_MIN_DELAY 60
+#define UREPORT_QUEUE_MAX_DELAY (6 * 60 * 60)
+
+char *ureport_queue_dir(void)
+{
+    const char *dir = getenv(UREPORT_QUEUE_DIR_ENV);
+    if (dir != NULL && dir[0] != '\0')
+        return xstrdup(dir);
+
+    if (geteuid() == 0)
+        return xstrdup(UREPORT_QUEUE_SPOOL_DIR);
+
+    return concat_path_file(g_get_user_cache_dir(), UREPORT_QUEUE_USER_DIR);
+}
+
+static int ureport_queue_open_dir(bool create)
+{
+    char *path = ureport_queue_dir();
+
+    if (create && g_mkdir_with_parents(path, 0700) != 0)
+    {
+        perror_msg("Can't create uReport queue '%s'", path);
+        free(path);
+        return -1;
+    }
+
+    const int dir_fd = open(path, O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (dir_fd < 0 && (create || errno != ENOENT))
+        perror_msg("Can't open uReport queue '%s'", path);
+
+    free(path);
+    return dir_fd;
+}
+
+/* Serializes modifications of the queue among processes */
+static int ureport_queue_lock(int dir_fd)
+{
+    const int lock_fd = openat(dir_fd, UREPORT_QUEUE_LOCK,
+                               O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (lock_fd < 0)
+    {
+        perror_msg("Can't open uReport queue lock");
+        return -1;
+    }
+
+    while (flock(lock_fd, LOCK_EX) != 0)
+    {
+        if (errno != EINTR)
+        {
+            perror_msg("Can't lock uReport queue");
+            close(lock_fd);
+            return -1;
+        }
+    }
+
+    return lock_fd;
+}
+
+static void ureport_queue_unlock(int lock_fd)
+{
+    /* Closing releases the lock */
+    close(lock_fd);
+}
+
+/* sha1 of the server URL and the problem: the name does not disclose either
+ * and the URL of the server does not need escaping */
+static char *ureport_queue_key(const char *url, const char *id)
+{
+    char *str = xasprintf("%s\n%s", url, id);
+    char *key = xmalloc(SHA1_RESULT_LEN * 2 + 1);
+    str_to_sha1str(key, str);
+    free(str);
+    return key;
+}
+
+static char *ureport_queue_backoff_name(const char *url)
+{
+    char *key = ureport_queue_key(url, "");
+    char *name = xasprintf("%s"UREPORT_QUEUE_BACKOFF_SFX, key);
+    free(key);
+    return name;
+}
+
+/*
+ * Every queued uReport is an occurrence counted by the server, hence it is
+ * one entry, even if an entry of the same problem is queued already.
+ *
+ * Entry sample:
+ * {"url":"https://retrace.fedoraproject.org/faf","ureport":"{...}",
+ *  "dump_dir":"/var/spool/abrt/ccpp-..."}
+ */
+static json_object *ureport_queue_entry_new(const char *url, const char *json,
+                                            const char *dump_dir_path)
+{
+    json_object *entry = json_object_new_object();
+    json_object_object_add(entry, "url", json_object_new_string(url));
+    json_object_object_add(entry, "ureport", json_object_new_string(json));
+    if (dump_dir_path != NULL)
+        json_object_object_add(entry, "dump_dir", json_object_new_string(dump_dir_path));
+
+    return entry;
+}
+
+static const char *ureport_queue_entry_string(json_object *entry, const char *key)
+{
+    json_object *value = NULL;
+    if (!json_object_object_get_ex(entry, key, &value)
+        || !json_object_is_type(value, json_type_string))
+        return NULL;
+
+    return json_object_get_string(value);
+}
+
+static json_object *ureport_queue_load(int dir_fd, const char *name)
+{
+    const int fd = openat(dir_fd, name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno != ENOENT)
+            perror_msg("Can't open queued uReport '%s'", name);
+        return NULL;
+    }
+
+    size_t size = UREPORT_QUEUE_MAX_ENTRY_SIZE;
+    char *data = xmalloc_read(fd, &size);
+    close(fd);
+    if (data == NULL)
+        return NULL;
+
+    json_object *entry = json_tokener_parse(data);
+    free(data);
+
+    if (is_error(entry)
+        || !json_object_is_type(entry, json_type_object)
+        || ureport_queue_entry_string(entry, "url") == NULL
+        || ureport_queue_entry_string(entry, "ureport") == NULL)
+    {
+        log_warning("Ignoring malformed queued uReport '%s'", name);
+        if (!is_error(entry))
+            json_object_put(entry);
+        return NULL;
+    }
+
+    return entry;
+}
+
+/* Other processes read the queue without the lock, hence the entry is
+ * written to a temporary file and renamed */
+static int ureport_queue_store(int dir_fd, const char *name, json_object *entry)
+{
+    const char *data = json_object_to_json_string(entry);
+    char *tmp_name = xasprintf(".%s.%lu.tmp", name, (unsigned long)getpid());
+    int r = 0;
+
+    const int fd = openat(dir_fd, tmp_name,
+                          O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        r = -errno;
+        perror_msg("Can't create queued uReport '%s'", name);
+        goto finish;
+    }
+
+    const size_t len = strlen(data);
+    if (full_write(fd, data, len) != len || fsync(fd) != 0)
+    {
+        r = -errno;
+        perror_msg("Can't write queued uReport '%s'", name);
+        close(fd);
+        unlinkat(dir_fd, tmp_name, 0);
+        goto finish;
+    }
+    close(fd);
+
+    if (renameat(dir_fd, tmp_name, dir_fd, name) != 0)
+    {
+        r = -errno;
+        perror_msg("Can't rename queued uReport '%s'", name);
+        unlinkat(dir_fd, tmp_name, 0);
+    }
+
+finish:
+    free(tmp_name);
+    return r;
+}
+
+/* Stores the entry under a free name "KEY.N.ureport" where KEY is derived
+ * from the server URL and the uReport. The queue must be locked. */
+static int ureport_queue_insert(int dir_fd, json_object *entry)
+{
+    char *key = ureport_queue_key(ureport_queue_entry_string(entry, "url"),
+                                  ureport_queue_entry_string(entry, "ureport"));
+    char *name = NULL;
+    for (unsigned n = 0; ; ++n)
+    {
+        free(name);
+        name = xasprintf("%s.%u"UREPORT_QUEUE_ENTRY_SFX, key, n);
+        if (faccessat(dir_fd, name, F_OK, AT_SYMLINK_NOFOLLOW) != 0 && errno == ENOENT)
+            break;
+    }
+
+    const int r = ureport_queue_store(dir_fd, name, entry);
+    if (r == 0)
+        log_notice("Queued uReport '%s'", name);
+
+    free(name);
+    free(key);
+    return r;
+}
+
+int ureport_queue_add(const char *json, const char *dump_dir_path,
+                      struct ureport_server_config *config)
+{
+    const int dir_fd = ureport_queue_open_dir(/*create*/true);
+    if (dir_fd < 0)
+        return -1;
+
+    /* Delivery does not run in the dump dir */
+    char *real_dump_dir = dump_dir_path ? realpath(dump_dir_path, NULL) : NULL;
+    json_object *entry = ureport_queue_entry_new(config->ur_url, json, real_dump_dir);
+
+    int r = -1;
+    const int lock_fd = ureport_queue_lock(dir_fd);
+    if (lock_fd >= 0)
+    {
+        r = ureport_queue_insert(dir_fd, entry) == 0 ? 0 : -1;
+        ureport_queue_unlock(lock_fd);
+    }
+
+    json_object_put(entry);
+    free(real_dump_dir);
+    close(dir_fd);
+    return r;
+}
+
+/* Back-off file: "FAILURES NEXT_ATTEMPT_TIME" */
+static time_t ureport_queue_load_backoff(int dir_fd, const char *url, unsigned *failures)
+{
+    char *name = ureport_queue_backoff_name(url);
+    unsigned long long next = 0;
+    unsigned count = 0;
+
+    const int fd = openat(dir_fd, name, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        char buf[64];
+        const ssize_t len = full_read(fd, buf, sizeof(buf) - 1);
+        close(fd);
+        if (len > 0)
+        {
+            buf[len] = '\0';
+            if (sscanf(buf, "%u %llu", &count, &next) != 2)
+                count = next = 0;
+        }
+    }
+
+    free(name);
+    if (failures)
+        *failures = count;
+    return (time_t)next;
+}
+
+/* The queue must be locked */
+static void ureport_queue_update_backoff(int dir_fd, const char *url, bool reachable)
+{
+    char *name = ureport_queue_backoff_name(url);
+
+    if (reachable)
+    {
+        if (unlinkat(dir_fd, name, 0) != 0 && errno != ENOENT)
+            perror_msg("Can't remove '%s'", name);
+        free(name);
+        return;
+    }
+
+    unsigned failures = 0;
+    ureport_queue_load_backoff(dir_fd, url, &failures);
+    ++failures;
+
+    /* Exponential with jitter, so that clients do not return at once */
+    unsigned delay = UREPORT_QUEUE_MAX_DELAY;
+    if (failures <= 16)
+        delay = MIN(UREPORT_QUEUE_MIN_DELAY << (failures - 1), UREPORT_QUEUE_MAX_DELAY);
+    delay = delay / 2 + g_random_int_range(0, delay / 2 + 1);
+
+    char *line = xasprintf("%u %llu\n", failures, (unsigned long long)(time(NULL) + delay));
+    char *tmp_name = xasprintf(".%s.%lu.tmp", name, (unsigned long)getpid());
+    const int fd = openat(dir_fd, tmp_name,
+                          O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0
+        || full_write(fd, line, strlen(line)) != strlen(line)
+        || renameat(dir_fd, tmp_name, dir_fd, name) != 0)
+    {
+        perror_msg("Can't save '%s'", name);
+        unlinkat(dir_fd, tmp_name, 0);
+    }
+    else
+        log_notice("The server '%s' will not be contacted for %u seconds", url, delay);
+
+    if (fd >= 0)
+        close(fd);
+    free(tmp_name);
+    free(line);
+    free(name);
+}
+
+static void ureport_queue_set_reachable(struct ureport_server_config *config, bool reachable)
+{
+    const int dir_fd = ureport_queue_open_dir(/*create*/!reachable);
+    if (dir_fd < 0)
+        return;
+
+    const int lock_fd = ureport_queue_lock(dir_fd);
+    if (lock_fd >= 0)
+    {
+        ureport_queue_update_backoff(dir_fd, config->ur_url, reachable);
+        ureport_queue_unlock(lock_fd);
+    }
+    close(dir_fd);
+}
+
+bool ureport_queue_server_unreachable(struct ureport_server_config *config)
+{
+    const int dir_fd = ureport_queue_open_dir(/*create*/false);
+    if (dir_fd < 0)
+        return false;
+
+    const time_t next = ureport_queue_load_backoff(dir_fd, config->ur_url, NULL);
+    close(dir_fd);
+
+    return next > time(NULL);
+}
+
+/* Network errors and HTTP codes asking to come later */
+static bool ureport_post_failed_transiently(const post_state_t *post_state)
+{
+    if (post_state->curl_result != CURLE_OK)
+        return true;
+
+    const int code = post_state->http_resp_code;
+    return code == 408 || code == 429 || code >= 500;
+}
+
+typedef void (*ureport_queue_func)(int dir_fd, const char *name, void *data);
+
+static void ureport_queue_foreach(int dir_fd, const char *sfx, ureport_queue_func func, void *data)
+{
+    const int fd = dup(dir_fd);
+    DIR *dir = fd >= 0 ? fdopendir(fd) : NULL;
+    if (dir == NULL)
+    {
+        perror_msg("Can't read uReport queue");
+        if (fd >= 0)
+            close(fd);
+        return;
+    }
+
+    /* The callback may rename the entries */
+    GList *names = NULL;
+    struct dirent *dent;
+    while ((dent = readdir(dir)) != NULL)
+    {
+        if (dent->d_name[0] != '.' && strstr(dent->d_name, sfx) != NULL)
+            names = g_list_prepend(names, xstrdup(dent->d_name));
+    }
+    closedir(dir);
+
+    for (GList *iter = names; iter; iter = g_list_next(iter))
+        func(dir_fd, iter->data, data);
+
+    g_list_free_full(names, free);
+}
+
+struct ureport_queue_stats
+{
+    const char *url;
+    unsigned entries;
+};
+
+static void ureport_queue_count(int dir_fd, const char *name, void *data)
+{
+    struct ureport_queue_stats *stats = data;
+    if (!g_str_has_suffix(name, UREPORT_QUEUE_ENTRY_SFX))
+        return;
+
+    json_object *entry = ureport_queue_load(dir_fd, name);
+    if (entry == NULL)
+        return;
+
+    if (strcmp(ureport_queue_entry_string(entry, "url"), stats->url) == 0)
+        ++stats->entries;
+    json_object_put(entry);
+}
+
+unsigned ureport_queue_length(struct ureport_server_config *config)
+{
+    struct ureport_queue_stats stats = { .url = config->ur_url };
+
+    const int dir_fd = ureport_queue_open_dir(/*create*/false);
+    if (dir_fd >= 0)
+    {
+        ureport_queue_foreach(dir_fd, UREPORT_QUEUE_ENTRY_SFX, ureport_queue_count, &stats);
+        close(dir_fd);
+    }
+
+    return stats.entries;
+}
+
+/* Entries claimed by a process which died are returned to the queue */
+static void ureport_queue_recover(int dir_fd, const char *name, void *data)
+{
+    const char *sfx = strstr(name, UREPORT_QUEUE_SENDING_SFX);
+    if (sfx == NULL)
+        return;
+
+    char *end = NULL;
+    const unsigned long pid = strtoul(sfx + strlen(UREPORT_QUEUE_SENDING_SFX), &end, 10);
+    if (end == NULL || *end != '\0')
+        return;
+
+    if (pid == (unsigned long)getpid() || kill((pid_t)pid, 0) == 0 || errno != ESRCH)
+        return;
+
+    json_object *entry = ureport_queue_load(dir_fd, name);
+    if (entry != NULL)
+    {
+        log_notice("Recovering queued uReport '%s' of process %lu", name, pid);
+        const int r = ureport_queue_insert(dir_fd, entry);
+        json_object_put(entry);
+        if (r != 0)
+            return;
+    }
+
+    unlinkat(dir_fd, name, 0);
+}
+
+enum
+{
+    UREPORT_DELIVERY_POSTPONED,
+    UREPORT_DELIVERY_DONE,
+};
+
+struct ureport_delivery
+{
+    char *claimed_name;
+    json_object *entry;
+    struct ureport_server_config *config;
+    /* Shared by all deliveries */
+    gint *server_down;
+
+    int result;
+    struct ureport_server_response *response;
+};
+
+struct ureport_queue_claim
+{
+    const char *url;
+    GPtrArray *deliveries;
+    gint *server_down;
+    struct ureport_server_config *config;
+};
+
+/* The queue must be locked */
+static void ureport_queue_claim(int dir_fd, const char *name, void *data)
+{
+    struct ureport_queue_claim *claim = data;
+    if (!g_str_has_suffix(name, UREPORT_QUEUE_ENTRY_SFX))
+        return;
+
+    json_object *entry = ureport_queue_load(dir_fd, name);
+    if (entry == NULL)
+        return;
+
+    if (strcmp(ureport_queue_entry_string(entry, "url"), claim->url) != 0)
+    {
+        json_object_put(entry);
+        return;
+    }
+
+    /* The name is free for uReports queued during the delivery */
+    char *claimed_name = xasprintf("%s"UREPORT_QUEUE_SENDING_SFX"%lu", name, (unsigned long)getpid());
+    if (renameat(dir_fd, name, dir_fd, claimed_name) != 0)
+    {
+        perror_msg("Can't claim queued uReport '%s'", name);
+        free(claimed_name);
+        json_object_put(entry);
+        return;
+    }
+
+    struct ureport_delivery *delivery = xzalloc(sizeof(*delivery));
+    delivery->claimed_name = claimed_name;
+    delivery->entry = entry;
+    delivery->config = claim->config;
+    delivery->server_down = claim->server_down;
+    g_ptr_array_add(claim->deliveries, delivery);
+}
+
+static void ureport_delivery_run(gpointer data, gpointer user_data)
+{
+    struct ureport_delivery *delivery = data;
+
+    /* Do not knock on the door of a server which is down */
+    if (g_atomic_int_get(delivery->server_down))
+        return;
+
+    const char *json = ureport_queue_entry_string(delivery->entry, "ureport");
+    post_state_t *post_state = ureport_do_post(json, delivery->config, UREPORT_SUBMIT_ACTION);
+
+    if (ureport_post_failed_transiently(post_state))
+    {
+        g_atomic_int_set(delivery->server_down, 1);
+        /* Logs the reason */
+        ureport_server_response_free(ureport_server_response_from_reply(post_state, delivery->config));
+    }
+    else
+    {
+        delivery->response = ureport_server_response_from_reply(post_state, delivery->config);
+        delivery->result = UREPORT_DELIVERY_DONE;
+    }
+
+    free_post_state(post_state);
+}
+
+static void ureport_delivery_finish(struct ureport_delivery *delivery)
+{
+    struct ureport_server_response *response = delivery->response;
+    if (response == NULL)
+        /* The error has been logged, the uReport would fail again */
+        return;
+
+    if (response->urr_is_error)
+    {
+        error_msg(_("Server responded with an error: '%s'"), response->urr_value);
+        return;
+    }
+
+    const char *dump_dir_path = ureport_queue_entry_string(delivery->entry, "dump_dir");
+    if (dump_dir_path != NULL
+        && !ureport_server_response_save_in_dump_dir(response, dump_dir_path, delivery->config))
+        log_notice("Can't save the response in '%s'", dump_dir_path);
+
+    log_warning(_("Delivered queued uReport"));
+}
+
+static void ureport_delivery_free(struct ureport_delivery *delivery)
+{
+    ureport_server_response_free(delivery->response);
+    json_object_put(delivery->entry);
+    free(delivery->claimed_name);
+    free(delivery);
+}
+
+int ureport_queue_deliver(struct ureport_server_config *config, unsigned max_concurrency)
+{
+    const int dir_fd = ureport_queue_open_dir(/*create*/false);
+    if (dir_fd < 0)
+        return errno == ENOENT ? 0 : -1;
+
+    int lock_fd = ureport_queue_lock(dir_fd);
+    if (lock_fd < 0)
+    {
+        close(dir_fd);
+        return -1;
+    }
+
+    gint server_down = 0;
+    struct ureport_queue_claim claim = {
+        .url = config->ur_url,
+        .deliveries = g_ptr_array_new(),
+        .server_down = &server_down,
+        .config = config,
+    };
+
+    ureport_queue_foreach(dir_fd, UREPORT_QUEUE_SENDING_SFX, ureport_queue_recover, NULL);
+    ureport_queue_foreach(dir_fd, UREPORT_QUEUE_ENTRY_SFX, ureport_queue_claim, &claim);
+    ureport_queue_unlock(lock_fd);
+
+    GPtrArray *deliveries = claim.deliveries;
+    log_info("Delivering %u queued uReports to '%s'", deliveries->len, config->ur_url);
+
+    if (max_concurrency == 0)
+        max_concurrency = UREPORT_QUEUE_DEFAULT_CONCURRENCY;
+
+    GThreadPool *pool = NULL;
+    if (deliveries->len > 1 && max_concurrency > 1)
+    {
+        const int threads = MIN(deliveries->len, max_concurrency);
+        GError *error = NULL;
+        pool = g_thread_pool_new(ureport_delivery_run, NULL, threads, /*exclusive*/TRUE, &error);
+        if (pool == NULL)
+        {
+            log_notice("Can't create a thread pool, delivering uReports serially: %s", error->message);
+            g_error_free(error);
+        }
+    }
+
+    for (unsigned i = 0; i < deliveries->len; ++i)
+    {
+        if (pool != NULL)
+            g_thread_pool_push(pool, g_ptr_array_index(deliveries, i), NULL);
+        else
+            ureport_delivery_run(g_ptr_array_index(deliveries, i), NULL);
+    }
+
+    if (pool != NULL)
+        /* Wait for all deliveries to finish */
+        g_thread_pool_free(pool, /*immediate*/FALSE, /*wait*/TRUE);
+
+    for (unsigned i = 0; i < deliveries->len; ++i)
+    {
+        struct ureport_delivery *delivery = g_ptr_array_index(deliveries, i);
+        if (delivery->result == UREPORT_DELIVERY_DONE)
+            ureport_delivery_finish(delivery);
+    }
+
+    int left = -1;
+    lock_fd = ureport_queue_lock(dir_fd);
+    if (lock_fd >= 0)
+    {
+        left = 0;
+        for (unsigned i = 0; i < deliveries->len; ++i)
+        {
+            struct ureport_delivery *delivery = g_ptr_array_index(deliveries, i);
+            if (delivery->result == UREPORT_DELIVERY_POSTPONED)
+            {
+                /* The claimed entry stays for recovery if it can't be returned */
+                if (ureport_queue_insert(dir_fd, delivery->entry) != 0)
+                    continue;
+                ++left;
+            }
+
+            unlinkat(dir_fd, delivery->claimed_name, 0);
+        }
+
+        if (deliveries->len != 0)
+            ureport_queue_update_backoff(dir_fd, config->ur_url, !g_atomic_int_get(&server_down));
+        ureport_queue_unlock(lock_fd);
+    }
+
+    if (left > 0)
+        log_warning(_("%d uReports stay queued, the server '%s' is unreachable"), left, config->ur_url);
+
+    g_ptr_array_foreach(deliveries, (GFunc)ureport_delivery_free, NULL);
+    g_ptr_array_free(deliveries, TRUE);
+    close(dir_fd);
+    return left;
+}
+
+struct ureport_server_response *
+ureport_submit_or_queue(const char *json, const char *dump_dir_path,
+                        struct ureport_server_config *config, bool *queued)
+{
+    *queued = false;
+
+    if (ureport_queue_server_unreachable(config))
+        log_notice("The server '%s' was unreachable recently", config->ur_url);
+    else
+    {
+        post_state_t *post_state = ureport_do_post(json, config, UREPORT_SUBMIT_ACTION);
+        const bool transient = ureport_post_failed_transiently(post_state);
+        struct ureport_server_response *response = ureport_server_response_from_reply(post_state, config);
+        free_post_state(post_state);
+
+        if (!transient)
+        {
+            /* Ends the back-off of the previous failures */
+            ureport_queue_set_reachable(config, true);
+            return response;
+        }
+
+        ureport_server_response_free(response);
+        ureport_queue_set_reachable(config, false);
+    }
+
+    if (ureport_queue_add(json, dump_dir_path, config) != 0)
+        return NULL;
+
+    *queued = true;
+    log_warning(_("uReport has been queued, it will be sent once '%s' is reachable"), config->ur_url);
+    return NULL;
+}
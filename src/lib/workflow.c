@@ -31,6 +31,12 @@ struct workflow
 
 
 GHashTable *g_workflow_list;
+/* All workflows have been loaded by load_workflow_config_data(), otherwise
+ * g_workflow_list holds only the workflows loaded on demand */
+static bool g_workflow_list_complete;
+/* Workflows removed by reload_workflow(), callers might still hold pointers
+ * to them */
+static GList *g_removed_workflows;
 
 workflow_t *new_workflow(const char *name)
 {
@@ -53,12 +59,70 @@ void free_workflow_list(GHashTable **wl)
 {
     if (*wl != NULL)
     {
+        if (*wl == g_workflow_list)
+        {
+            g_workflow_list_complete = false;
+            g_list_free_full(g_removed_workflows, (GDestroyNotify)free_workflow);
+            g_removed_workflows = NULL;
+        }
+
         g_hash_table_destroy(*wl);
         *wl = NULL;
     }
 }
 
-workflow_t *get_workflow(const char *name)
+static void init_workflow_list(void)
+{
+    if (g_workflow_list == NULL)
+    {
+        g_workflow_list = g_hash_table_new_full(
+                                        g_str_hash,
+                                        g_str_equal,
+                                        g_free,
+                                        (GDestroyNotify) free_workflow
+        );
+    }
+}
+
+/* The tests use their own workflow definitions */
+static const char *get_workflows_dir(void)
+{
+    const char *workflows_dir = getenv("LIBREPORT_DEBUG_WORKFLOWS_DIR");
+    return workflows_dir ? workflows_dir : WORKFLOWS_DIR;
+}
+
+/* Parses only the workflow's XML file instead of all workflows */
+static workflow_t *read_workflow(const char *name)
+{
+    if (!str_is_correct_filename(name))
+        return NULL;
+
+    char *path = xasprintf("%s/%s.xml", get_workflows_dir(), name);
+    workflow_t *workflow = NULL;
+    if (access(path, F_OK) == 0)
+    {
+        workflow = new_workflow(name);
+        load_workflow_description_from_file(workflow, path);
+    }
+    free(path);
+
+    return workflow;
+}
+
+static workflow_t *load_one_workflow(const char *name)
+{
+    workflow_t *workflow = read_workflow(name);
+    if (workflow)
+    {
+        log_debug("Loaded workflow '%s'", name);
+        init_workflow_list();
+        g_hash_table_replace(g_workflow_list, xstrdup(name), workflow);
+    }
+
+    return workflow;
+}
+
+static workflow_t *lookup_workflow(const char *name)
 {
     if (!g_workflow_list)
         return NULL;
@@ -73,6 +137,54 @@ workflow_t *get_workflow(const char *name)
     return g_hash_table_lookup(g_workflow_list, name);
 }
 
+workflow_t *get_workflow(const char *name)
+{
+    workflow_t *workflow = lookup_workflow(name);
+    if (!workflow && !g_workflow_list_complete)
+        workflow = load_one_workflow(name);
+
+    return workflow;
+}
+
+bool reload_workflow(const char *name)
+{
+    workflow_t *workflow = lookup_workflow(name);
+    /* Not loaded yet, get_workflow() will read the current file */
+    if (!workflow && !g_workflow_list_complete)
+        return false;
+
+    workflow_t *reloaded = read_workflow(name);
+    if (!reloaded)
+    {
+        if (!workflow)
+            return false;
+
+        log_info("Workflow '%s' has been removed", name);
+        /* Keep the workflow alive, callers might still hold it */
+        gpointer key = NULL;
+        g_hash_table_lookup_extended(g_workflow_list, name, &key, NULL);
+        g_hash_table_steal(g_workflow_list, key);
+        free(key);
+        g_removed_workflows = g_list_prepend(g_removed_workflows, workflow);
+        return true;
+    }
+
+    log_info("Reloaded workflow '%s'", name);
+    if (!workflow)
+    {
+        g_hash_table_replace(g_workflow_list, xstrdup(name), reloaded);
+        return true;
+    }
+
+    /* Swap the contents, so pointers to the workflow stay valid */
+    workflow_t old = *workflow;
+    *workflow = *reloaded;
+    *reloaded = old;
+    free_workflow(reloaded);
+
+    return true;
+}
+
 static gint file_obj_cmp(file_obj_t *file, const char *filename)
 {
     gint cmp = strcmp(file->filename, filename);
@@ -106,7 +218,7 @@ GHashTable *load_workflow_config_data_from_list(GList *wf_names,
         );
 
     if (path == NULL)
-        path = WORKFLOWS_DIR;
+        path = get_workflows_dir();
 
     GList *workflow_files = get_file_list(path, "xml");
     while(wfs)
@@ -121,41 +233,32 @@ GHashTable *load_workflow_config_data_from_list(GList *wf_names,
 
 GHashTable *load_workflow_config_data(const char *path)
 {
-    if (g_workflow_list)
+    if (g_workflow_list_complete)
         return g_workflow_list;
 
-    if (g_workflow_list == NULL)
-    {
-        g_workflow_list = g_hash_table_new_full(
-                                        g_str_hash,
-                                        g_str_equal,
-                                        g_free,
-                                        (GDestroyNotify) free_workflow
-        );
-    }
+    init_workflow_list();
 
     if (path == NULL)
-        path = WORKFLOWS_DIR;
+        path = get_workflows_dir();
 
     GList *workflow_files = get_file_list(path, "xml");
     while (workflow_files)
     {
         file_obj_t *file = (file_obj_t *)workflow_files->data;
 
-        workflow_t *workflow = get_workflow(file->filename);
-        bool nw_workflow = (!workflow);
-        if (nw_workflow)
-            workflow = new_workflow(file->filename);
-
-        load_workflow_description_from_file(workflow, file->fullpath);
-
-        if (nw_workflow)
+        /* Workflows loaded on demand are kept */
+        if (lookup_workflow(file->filename) == NULL)
+        {
+            workflow_t *workflow = new_workflow(file->filename);
+            load_workflow_description_from_file(workflow, file->fullpath);
             g_hash_table_replace(g_workflow_list, xstrdup(wf_get_name(workflow)), workflow);
+        }
 
         free_file_obj(file);
         workflow_files = g_list_delete_link(workflow_files, workflow_files);
     }
 
+    g_workflow_list_complete = true;
     return g_workflow_list;
 }
 
@@ -19,6 +19,7 @@
 #include "workflow.h"
 #include "internal_libreport.h"
 #include "xml_parser.h"
+#include "definition_cache.h"
 
 //workflow elements
 #define WORKFLOW_ELEMENT        "workflow"
@@ -83,6 +84,12 @@ static void text(GMarkupParseContext *context,
 
     if(parse_data->in_event_list && strcmp(inner_element, EVENT_ELEMENT) == 0)
     {
+        if (parse_data->event_names != NULL)
+        {
+            *parse_data->event_names = g_list_append(*parse_data->event_names, xstrdup(text));
+            return;
+        }
+
         event_config_t *ec = new_event_config(text);
         char *subevent_filename = xasprintf(EVENTS_DIR"/%s.xml", text);
 
@@ -179,12 +186,12 @@ static void error(GMarkupParseContext *context,
     error_msg("error in XML parsing");
 }
 
-void load_workflow_description_from_file(workflow_t *workflow, const char* filename)
+void parse_workflow_description_file(workflow_t *workflow, const char *filename,
+                                     const char *locale, GList **event_names)
 {
     log_info("loading workflow: '%s'", filename);
-    struct my_parse_data parse_data = { workflow, NULL, NULL, 0, 0, 0};
-    parse_data.cur_locale = xstrdup(setlocale(LC_ALL, NULL));
-    strchrnul(parse_data.cur_locale, '.')[0] = '\0';
+    struct my_parse_data parse_data = { workflow, NULL, NULL, 0, 0, 0, event_names };
+    parse_data.cur_locale = xstrdup(locale);
 
     GMarkupParser parser;
     memset(&parser, 0, sizeof(parser)); /* just in case */
@@ -215,3 +222,11 @@ void load_workflow_description_from_file(workflow_t *workflow, const char* filen
     free(parse_data.attribute_lang); /* just in case */
     free(parse_data.cur_locale);
 }
+
+void load_workflow_description_from_file(workflow_t *workflow, const char* filename)
+{
+    char *locale = definition_cache_locale();
+    if (!definition_cache_load_workflow(workflow, filename, locale))
+        parse_workflow_description_file(workflow, filename, locale, /*event_names*/ NULL);
+    free(locale);
+}
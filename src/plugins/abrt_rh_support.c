@@ -278,6 +278,7 @@ post_case_to_url(const char* url,
                 const char* username,
                 const char* password,
                 bool ssl_verify,
+                int content_encoding,
                 const char **additional_headers,
                 const char* product,
                 const char* version,
@@ -305,6 +306,7 @@ post_case_to_url(const char* url,
     );
     post_state->username = username;
     post_state->password = password;
+    post_state->content_encoding = content_encoding;
 
     post_string(post_state, url, "application/xml", additional_headers, case_data);
 
@@ -393,6 +395,7 @@ create_new_case(const char* base_url,
                 const char* username,
                 const char* password,
                 bool ssl_verify,
+                int content_encoding,
                 const char* product,
                 const char* version,
                 const char* summary,
@@ -404,6 +407,7 @@ create_new_case(const char* base_url,
                 username,
                 password,
                 ssl_verify,
+                content_encoding,
                 (const char **)text_plain_header,
                 product,
                 version,
@@ -466,6 +470,7 @@ post_comment_to_url(const char *url,
                 const char *username,
                 const char *password,
                 bool ssl_verify,
+                int content_encoding,
                 const char **additional_headers,
                 const char *comment_text)
 {
@@ -487,6 +492,7 @@ post_comment_to_url(const char *url,
     );
     post_state->username = username;
     post_state->password = password;
+    post_state->content_encoding = content_encoding;
 
     post_string(post_state, url, "application/xml", additional_headers, xml);
 
@@ -561,6 +567,7 @@ add_comment_to_case(const char* base_url,
                 const char* username,
                 const char* password,
                 bool ssl_verify,
+                int content_encoding,
                 const char* comment_text)
 {
     char *url = concat_path_file(base_url, "comments");
@@ -568,6 +575,7 @@ add_comment_to_case(const char* base_url,
                 username,
                 password,
                 ssl_verify,
+                content_encoding,
     // NB! text_plain_header here was causing error 404 instead of 201 (Created)!
     // NULL makes curl use "Accept: */*" instead and creation works.
     // Likely a bug on the server!
@@ -63,6 +63,7 @@ create_new_case(const char* baseURL,
                 const char* username,
                 const char* password,
                 bool ssl_verify,
+                int content_encoding,
                 const char* product,
                 const char* version,
                 const char* summary,
@@ -75,6 +76,7 @@ add_comment_to_case(const char* base_url,
                 const char* username,
                 const char* password,
                 bool ssl_verify,
+                int content_encoding,
                 const char* comment_text);
 
 rhts_result_t*
@@ -630,20 +630,17 @@ mantisbt_result_free(mantisbt_result_t *result)
     free(result);
 }
 
-mantisbt_result_t *
-mantisbt_soap_call(const mantisbt_settings_t *settings, const soap_request_t *req)
+static mantisbt_result_t *
+mantisbt_soap_call_body(const mantisbt_settings_t *settings, post_body_t *body)
 {
-    char *request = soap_request_to_str(req);
-
     const char *url = settings->m_mantisbt_soap_url;
 
     mantisbt_result_t *result = xzalloc(sizeof(*result));
 
-    if (url == NULL || request == NULL)
+    if (url == NULL || body == NULL)
     {
         result->mr_error = -2;
         result->mr_msg = xasprintf(_("Url or request isn't specified."));
-        free(request);
 
         return result;
     }
@@ -661,8 +658,9 @@ redirect:
             + POST_WANT_ERROR_MSG
             + (settings->m_ssl_verify ? POST_WANT_SSL_VERIFY : 0)
     );
+    post_state->content_encoding = settings->m_content_encoding;
 
-    post_string(post_state, settings->m_mantisbt_soap_url, "text/xml", NULL, request);
+    post_stream(post_state, settings->m_mantisbt_soap_url, "text/xml", NULL, body);
 
     char *location = find_header_in_post_state(post_state, "Location:");
 
@@ -711,27 +709,33 @@ redirect:
 
     free_post_state(post_state);
     free(url_copy);
-    free(request);
 
     return result;
 }
 
-int
-mantisbt_attach_data(const mantisbt_settings_t *settings, const char *bug_id,
-                    const char *att_name, const char *data, int size)
+mantisbt_result_t *
+mantisbt_soap_call(const mantisbt_settings_t *settings, const soap_request_t *req)
 {
-    soap_request_t *req = soap_request_new_for_method("mc_issue_attachment_add");
-    soap_request_add_credentials_parameter(req, settings);
+    char *request = soap_request_to_str(req);
 
-    soap_request_add_method_parameter(req, "issue_id", SOAP_INTEGER, bug_id);
-    soap_request_add_method_parameter(req, "name", SOAP_STRING, att_name);
+    post_body_t *body = NULL;
+    if (request != NULL)
+    {
+        body = new_post_body();
+        post_body_append_str(body, request);
+        free(request);
+    }
 
-    soap_request_add_method_parameter(req, "file_type", SOAP_STRING, "text");
-    soap_request_add_method_parameter(req, "content", SOAP_BASE64, encode_base64(data, size));
+    mantisbt_result_t *result = mantisbt_soap_call_body(settings, body);
+    free_post_body(body);
 
-    mantisbt_result_t *result = mantisbt_soap_call(settings, req);
-    soap_request_free(req);
+    return result;
+}
 
+/* Returns the attachment id or a negative number on errors */
+static int
+mantisbt_attach_result(mantisbt_result_t *result)
+{
     if (result->mr_http_resp_code != 200)
     {
         int ret = -1;
@@ -750,6 +754,27 @@ mantisbt_attach_data(const mantisbt_settings_t *settings, const char *bug_id,
     return id;
 }
 
+int
+mantisbt_attach_data(const mantisbt_settings_t *settings, const char *bug_id,
+                    const char *att_name, const char *data, int size)
+{
+    soap_request_t *req = soap_request_new_for_method("mc_issue_attachment_add");
+    soap_request_add_credentials_parameter(req, settings);
+
+    soap_request_add_method_parameter(req, "issue_id", SOAP_INTEGER, bug_id);
+    soap_request_add_method_parameter(req, "name", SOAP_STRING, att_name);
+
+    soap_request_add_method_parameter(req, "file_type", SOAP_STRING, "text");
+    char *content = encode_base64(data, size);
+    soap_request_add_method_parameter(req, "content", SOAP_BASE64, content);
+    free(content);
+
+    mantisbt_result_t *result = mantisbt_soap_call(settings, req);
+    soap_request_free(req);
+
+    return mantisbt_attach_result(result);
+}
+
 static int
 mantisbt_attach_fd(const mantisbt_settings_t *settings, const char *bug_id,
                 const char *att_name, int fd)
@@ -766,20 +791,41 @@ mantisbt_attach_fd(const mantisbt_settings_t *settings, const char *bug_id,
         error_msg(_("Can't upload '%s', it's too large (%llu bytes)"), att_name, (long long)size);
         return -1;
     }
-    lseek(fd, 0, SEEK_SET);
 
-    char *data = xmalloc(size + 1);
-    ssize_t r = full_read(fd, data, size);
+    soap_request_t *req = soap_request_new_for_method("mc_issue_attachment_add");
+    soap_request_add_credentials_parameter(req, settings);
+
+    soap_request_add_method_parameter(req, "issue_id", SOAP_INTEGER, bug_id);
+    soap_request_add_method_parameter(req, "name", SOAP_STRING, att_name);
+
+    soap_request_add_method_parameter(req, "file_type", SOAP_STRING, "text");
+    /* The file is encoded into the request while it is being sent instead of
+     * the placeholder, which is random, so the other parameters can't
+     * contain it */
+    char *placeholder = xasprintf("@CONTENT-%08x%08x%08x%08x@",
+                                  g_random_int(), g_random_int(), g_random_int(), g_random_int());
+    soap_request_add_method_parameter(req, "content", SOAP_BASE64, placeholder);
+
+    char *request = soap_request_to_str(req);
+    soap_request_free(req);
+
+    post_body_t *body = new_post_body();
+    int r = post_body_append_fd_base64_at(body, request, strlen(request), placeholder, fd);
+    free(request);
+    free(placeholder);
+
     if (r < 0)
     {
-        free(data);
+        errno = -r;
         perror_msg(_("Can't read '%s'"), att_name);
+        free_post_body(body);
         return -1;
     }
 
-    int res = mantisbt_attach_data(settings, bug_id, att_name, data, size);
-    free(data);
-    return res;
+    mantisbt_result_t *result = mantisbt_soap_call_body(settings, body);
+    free_post_body(body);
+
+    return mantisbt_attach_result(result);
 }
 
 int
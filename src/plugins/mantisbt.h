@@ -61,6 +61,7 @@ typedef struct mantisbt_settings
     char *m_project_version;
     const char *m_DontMatchComponents;
     int         m_ssl_verify;
+    int         m_content_encoding;
     int         m_create_private;
 } mantisbt_settings_t;
 
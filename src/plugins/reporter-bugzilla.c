@@ -19,40 +19,48 @@
 #include "internal_libreport.h"
 #include "problem_report.h"
 #include "client.h"
+#include "libreport_curl.h"
 #include "abrt_xmlrpc.h"
 #include "rhbz.h"
+#include "http_cache.h"
 
 /* BZ attachments */
 
 #define DEFAULT_BUGZILLA_PRODUCT "Fedora"
 
+/* Uploading more attachments at once hides the latency of the round trips
+ * but the server should not be flooded.
+ */
+#define MAX_PARALLEL_ATTACHMENTS 4
+
 static
-int attach_text_item(struct abrt_xmlrpc *ax, const char *bug_id,
+bool prepare_text_item(struct rhbz_attachment *att,
                 const char *item_name, struct problem_item *item)
 {
     if (!(item->flags & CD_FLAG_TXT))
-        return 0;
+        return false;
     log_debug("attaching '%s' as text", item_name);
-    int r = rhbz_attach_blob(ax, bug_id,
-                item_name, item->content, strlen(item->content),
-                RHBZ_NOMAIL_NOTIFY
-    );
-    return (r == 0);
+    att->ra_name = item_name;
+    att->ra_data = item->content;
+    att->ra_data_len = strlen(item->content);
+    att->ra_fd = -1;
+    att->ra_flags = RHBZ_NOMAIL_NOTIFY;
+    return true;
 }
 
 static
-int attach_file_item(struct abrt_xmlrpc *ax, const char *bug_id,
+bool prepare_file_item(struct rhbz_attachment *att,
                 const char *item_name, struct problem_item *item)
 {
     if (!(item->flags & CD_FLAG_BIN))
-        return 0;
+        return false;
 
     char *filename = item->content;
     int fd = open(filename, O_RDONLY);
     if (fd < 0)
     {
         perror_msg("Can't open '%s'", filename);
-        return 0;
+        return false;
     }
     errno = 0;
     struct stat st;
@@ -60,15 +68,42 @@ int attach_file_item(struct abrt_xmlrpc *ax, const char *bug_id,
     {
         perror_msg("'%s': not a regular file", filename);
         close(fd);
-        return 0;
+        return false;
     }
     log_debug("attaching '%s' as file", item_name);
-    int flag = RHBZ_NOMAIL_NOTIFY;
+    att->ra_name = item_name;
+    att->ra_fd = fd;
+    att->ra_flags = RHBZ_NOMAIL_NOTIFY;
     if (!(item->flags & CD_FLAG_BIGTXT))
-        flag |= RHBZ_BINARY_ATTACHMENT;
-    int r = rhbz_attach_fd(ax, bug_id, item_name, fd, flag);
-    close(fd);
-    return (r == 0);
+        att->ra_flags |= RHBZ_BINARY_ATTACHMENT;
+    return true;
+}
+
+static
+void attach_items(struct abrt_xmlrpc *ax, const char *bug_id,
+                problem_data_t *problem_data, GList *item_names)
+{
+    struct rhbz_attachment *atts = xzalloc(sizeof(*atts) * (g_list_length(item_names) + 1));
+    unsigned count = 0;
+
+    for (GList *a = item_names; a != NULL; a = g_list_next(a))
+    {
+        const char *item_name = (const char *)a->data;
+        struct problem_item *item = problem_data_get_item_or_NULL(problem_data, item_name);
+        if (!item)
+            continue;
+        else if (item->flags & CD_FLAG_TXT)
+            count += prepare_text_item(&atts[count], item_name, item);
+        else if (item->flags & CD_FLAG_BIN)
+            count += prepare_file_item(&atts[count], item_name, item);
+    }
+
+    rhbz_attach_many(ax, bug_id, atts, count, MAX_PARALLEL_ATTACHMENTS);
+
+    for (unsigned i = 0; i < count; ++i)
+        if (atts[i].ra_fd >= 0)
+            close(atts[i].ra_fd);
+    free(atts);
 }
 
 /* Main */
@@ -82,6 +117,7 @@ struct bugzilla_struct {
     char *b_product_version;
     const char *b_DontMatchComponents;
     int         b_ssl_verify;
+    int         b_content_encoding;
     int         b_create_private;
     GList       *b_private_groups;
 };
@@ -158,6 +194,15 @@ static void set_settings(struct bugzilla_struct *b, map_string_t *settings)
     environ = getenv("Bugzilla_SSLVerify");
     b->b_ssl_verify = string_to_bool(environ ? environ : get_map_string_item_or_empty(settings, "SSLVerify"));
 
+    environ = getenv("Bugzilla_ContentEncoding");
+    const char *encoding = environ ? environ : get_map_string_item_or_NULL(settings, "ContentEncoding");
+    b->b_content_encoding = post_encoding_from_string(encoding);
+    if (b->b_content_encoding < 0)
+    {
+        error_msg(_("Unsupported ContentEncoding '%s', requests will not be compressed"), encoding);
+        b->b_content_encoding = POST_ENCODING_IDENTITY;
+    }
+
     environ = getenv("Bugzilla_DontMatchComponents");
     b->b_DontMatchComponents = environ ? environ : get_map_string_item_or_empty(settings, "DontMatchComponents");
 
@@ -278,7 +323,7 @@ int main(int argc, char **argv)
         "\n"
         "\nIf not specified, CONFFILE defaults to "CONF_DIR"/plugins/bugzilla.conf"
         "\nIts lines should have 'PARAM = VALUE' format."
-        "\nRecognized string parameters: BugzillaURL, Login, Password, OSRelease."
+        "\nRecognized string parameters: BugzillaURL, Login, Password, OSRelease, ContentEncoding."
         "\nRecognized boolean parameter (VALUE should be 1/0, yes/no): SSLVerify."
         "\nParameters can be overridden via $Bugzilla_PARAM environment variables."
         "\n"
@@ -381,6 +426,7 @@ int main(int argc, char **argv)
 
     struct abrt_xmlrpc *client;
     client = abrt_xmlrpc_new_client(rhbz.b_bugzilla_xmlrpc, rhbz.b_ssl_verify);
+    client->ax_content_encoding = rhbz.b_content_encoding;
     unsigned rhbz_ver = rhbz_version(client);
 
     if (abrt_hash)
@@ -589,8 +635,11 @@ int main(int argc, char **argv)
             error_msg_and_die("Invalid format file: %s", fmt_file);
 
         problem_report_t *pr = NULL;
-        if (problem_formatter_generate_report(pf, problem_data, &pr))
+        /* The report is cached in the dump directory only if it can be locked */
+        struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+        if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
             error_msg_and_die("Failed to format bug report from problem data");
+        dd_close(pr_dd);
 
         printf("summary: %s\n"
                 "\n"
@@ -637,6 +686,27 @@ int main(int argc, char **argv)
         }
     }
 
+    /* Figure out whether we want to match component
+     * when doing dup search.
+     */
+    const char *component_substitute = is_in_comma_separated_list(component, rhbz.b_DontMatchComponents) ? NULL : component;
+
+    /* The result of the dup search is cached. Private bugs are created even if
+     * a duplicate exists, so they don't use the cache.
+     */
+    const bool use_dup_cache = !bug_id && !rhbz.b_create_private;
+    char *dup_scope = xasprintf("%s %s %s",
+                                rhbz.b_product ? rhbz.b_product : "",
+                                rhbz.b_product_version ? rhbz.b_product_version : "",
+                                component_substitute ? component_substitute : "");
+    if (use_dup_cache)
+    {
+        if (opts & OPT_f)
+            duplicate_cache_drop(rhbz.b_bugzilla_url, dup_scope, duphash);
+        else if (duplicate_cache_get(rhbz.b_bugzilla_url, dup_scope, duphash, &bug_id, NULL))
+            log_warning(_("Using cached duplicate bug %i"), bug_id);
+    }
+
     struct bug_info *bz = NULL;
     if (!bug_id)
     {
@@ -645,11 +715,6 @@ int main(int argc, char **argv)
         int existing_id = -1;
         int crossver_id = -1;
         {
-            /* Figure out whether we want to match component
-             * when doing dup search.
-             */
-            const char *component_substitute = is_in_comma_separated_list(component, rhbz.b_DontMatchComponents) ? NULL : component;
-
             /* We don't do dup detection across versions (see below why),
              * but we do add a note if cross-version potential dup exists.
              * For that, we search for cross version dups first:
@@ -691,8 +756,11 @@ int main(int argc, char **argv)
                 error_msg_and_die("Invalid format file: %s", fmt_file);
 
             problem_report_t *pr = NULL;
-            if (problem_formatter_generate_report(pf, problem_data, &pr))
+            /* The report is cached in the dump directory only if it can be locked */
+            struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+            if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
                 error_msg_and_die("Failed to format problem data");
+            dd_close(pr_dd);
 
             if (existing_id >= 0)
             {
@@ -754,6 +822,9 @@ int main(int argc, char **argv)
                 error_msg_and_die(_("Failed to create a new bug."));
             }
 
+            if (use_dup_cache)
+                duplicate_cache_put(rhbz.b_bugzilla_url, dup_scope, duphash, new_id, "NEW");
+
             struct dump_dir *dd = dd_opendir(dump_dir_name, /*flags:*/ 0);
             if (dd)
             {
@@ -786,17 +857,7 @@ int main(int argc, char **argv)
             char new_id_str[sizeof(int)*3 + 2];
             sprintf(new_id_str, "%i", new_id);
 
-            for (GList *a = problem_report_get_attachments(pr); a != NULL; a = g_list_next(a))
-            {
-                const char *item_name = (const char *)a->data;
-                struct problem_item *item = problem_data_get_item_or_NULL(problem_data, item_name);
-                if (!item)
-                    continue;
-                else if (item->flags & CD_FLAG_TXT)
-                    attach_text_item(client, new_id_str, item_name, item);
-                else if (item->flags & CD_FLAG_BIN)
-                    attach_file_item(client, new_id_str, item_name, item);
-            }
+            attach_items(client, new_id_str, problem_data, problem_report_get_attachments(pr));
 
             bz = new_bug_info();
             bz->bi_status = xstrdup("NEW");
@@ -831,6 +892,10 @@ int main(int argc, char **argv)
         }
     }
 
+    /* Next time go straight to the origin bug */
+    if (use_dup_cache)
+        duplicate_cache_put(rhbz.b_bugzilla_url, dup_scope, duphash, bz->bi_id, bz->bi_status);
+
     /* We used to skip adding the comment to CLOSED bugs:
      *
      * if (strcmp(bz->bi_status, "CLOSED") != 0)
@@ -872,8 +937,11 @@ int main(int argc, char **argv)
             error_msg_and_die("Invalid duplicate format file: '%s", fmt_file2);
 
         problem_report_t *pr;
-        if (problem_formatter_generate_report(pf, problem_data, &pr))
+        /* The report is cached in the dump directory only if it can be locked */
+        struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+        if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
             error_msg_and_die("Failed to format duplicate comment from problem data");
+        dd_close(pr_dd);
 
         const char *bzcomment = problem_report_get_description(pr);
 
@@ -906,6 +974,8 @@ int main(int argc, char **argv)
     }
 
  log_out:
+    free(dup_scope);
+
     log_warning(_("Logging out"));
     rhbz_logout(client);
 
@@ -142,9 +142,21 @@ static void create_and_send_email(
             error_msg_and_die("Invalid format file: %s", fmt_file);
     }
 
+    env = getenv("Mailx_MaxSectionSize");
+    const char *max_section_size = env ? env : get_map_string_item_or_NULL(settings, "MaxSectionSize");
+    if (max_section_size)
+    {
+        problem_report_settings_t report_settings = problem_formatter_get_settings(pf);
+        report_settings.prs_max_section_size = xatoi_positive(max_section_size);
+        problem_formatter_set_settings(pf, report_settings);
+    }
+
     problem_report_t *pr = NULL;
-    if (problem_formatter_generate_report(pf, problem_data, &pr))
+    /* The report is cached in the dump directory only if it can be locked */
+    struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+    if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
         error_msg_and_die("Failed to format bug report from problem data");
+    dd_close(pr_dd);
 
     const char *subject = problem_report_get_summary(pr);
     const char *dsc = problem_report_get_description(pr);
@@ -261,6 +273,7 @@ int main(int argc, char **argv)
         "\n""If not specified, CONFFILE defaults to "CONF_DIR"/plugins/mailx.conf"
         "\n""Its lines should have 'PARAM = VALUE' format."
         "\n""Recognized string parameters: Subject, EmailFrom, EmailTo."
+        "\n""Recognized numeric parameter: MaxSectionSize."
         "\n""Recognized boolean parameter (VALUE should be 1/0, yes/no): SendBinaryData."
         "\n""Parameters can be overridden via $Mailx_PARAM environment variables."
     );
@@ -19,8 +19,10 @@
 
 #include "internal_libreport.h"
 #include "client.h"
+#include "libreport_curl.h"
 #include "mantisbt.h"
 #include "problem_report.h"
+#include "http_cache.h"
 
 static void
 parse_osinfo_for_mantisbt(map_string_t *osinfo, char** project, char** version)
@@ -183,6 +185,15 @@ set_settings(mantisbt_settings_t *m, map_string_t *settings, struct dump_dir *dd
     environ = getenv("Mantisbt_SSLVerify");
     m->m_ssl_verify = string_to_bool(environ ? environ : get_map_string_item_or_empty(settings, "SSLVerify"));
 
+    environ = getenv("Mantisbt_ContentEncoding");
+    const char *encoding = environ ? environ : get_map_string_item_or_NULL(settings, "ContentEncoding");
+    m->m_content_encoding = post_encoding_from_string(encoding);
+    if (m->m_content_encoding < 0)
+    {
+        error_msg(_("Unsupported ContentEncoding '%s', requests will not be compressed"), encoding);
+        m->m_content_encoding = POST_ENCODING_IDENTITY;
+    }
+
     environ = getenv("Mantisbt_DontMatchComponents");
     m->m_DontMatchComponents = environ ? environ : get_map_string_item_or_empty(settings, "DontMatchComponents");
 
@@ -245,7 +256,7 @@ int main(int argc, char **argv)
         "\n"
         "\nIf not specified, CONFFILE defaults to "CONF_DIR"/plugins/mantisbt.conf"
         "\nIts lines should have 'PARAM = VALUE' format."
-        "\nRecognized string parameters: MantisbtURL, Login, Password, Project, ProjectVersion."
+        "\nRecognized string parameters: MantisbtURL, Login, Password, Project, ProjectVersion, ContentEncoding."
         "\nRecognized boolean parameter (VALUE should be 1/0, yes/no): SSLVerify, CreatePrivate."
         "\nParameters can be overridden via $Mantisbt_PARAM environment variables."
         "\n"
@@ -434,8 +445,11 @@ int main(int argc, char **argv)
             error_msg_and_die("Invalid format file: %s", fmt_file);
 
         problem_report_t *pr = NULL;
-        if (problem_formatter_generate_report(pf, problem_data, &pr))
+        /* The report is cached in the dump directory only if it can be locked */
+        struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+        if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
             error_msg_and_die("Failed to format issue report from problem data");
+        dd_close(pr_dd);
 
         printf("summary: %s\n"
                 "\n"
@@ -480,6 +494,25 @@ int main(int argc, char **argv)
         }
     }
 
+    /* Figure out whether we want to match category
+     * when doing dup search.
+     */
+    const char *category_substitute = is_in_comma_separated_list(category, mbt_settings.m_DontMatchComponents) ? NULL : category;
+
+    /* The result of the dup search is cached */
+    const bool use_dup_cache = !bug_id;
+    char *dup_scope = xasprintf("%s %s %s",
+                                mbt_settings.m_project ? mbt_settings.m_project : "",
+                                mbt_settings.m_project_version ? mbt_settings.m_project_version : "",
+                                category_substitute ? category_substitute : "");
+    if (use_dup_cache)
+    {
+        if (opts & OPT_f)
+            duplicate_cache_drop(mbt_settings.m_mantisbt_url, dup_scope, duphash);
+        else if (duplicate_cache_get(mbt_settings.m_mantisbt_url, dup_scope, duphash, &bug_id, NULL))
+            log_warning(_("Using cached duplicate issue %i"), bug_id);
+    }
+
     mantisbt_issue_info_t *ii;
     if (!bug_id)
     {
@@ -488,11 +521,6 @@ int main(int argc, char **argv)
         int existing_id = -1;
         int crossver_id = -1;
         {
-            /* Figure out whether we want to match category
-             * when doing dup search.
-             */
-            const char *category_substitute = is_in_comma_separated_list(category, mbt_settings.m_DontMatchComponents) ? NULL : category;
-
             /* We don't do dup detection across versions (see below why),
              * but we do add a note if cross-version potential dup exists.
              * For that, we search for cross version dups first:
@@ -530,8 +558,11 @@ int main(int argc, char **argv)
                 error_msg_and_die(_("Invalid format file: %s"), fmt_file);
 
             problem_report_t *pr = NULL;
-            if (problem_formatter_generate_report(pf, problem_data, &pr))
+            /* The report is cached in the dump directory only if it can be locked */
+            struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+            if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
                 error_msg_and_die(_("Failed to format problem data"));
+            dd_close(pr_dd);
 
             if (crossver_id >= 0)
                 problem_report_buffer_printf(
@@ -563,6 +594,9 @@ int main(int argc, char **argv)
             if (new_id == -1)
                 return EXIT_FAILURE;
 
+            if (use_dup_cache)
+                duplicate_cache_put(mbt_settings.m_mantisbt_url, dup_scope, duphash, new_id, "new");
+
             log_warning(_("Adding attachments to issue %i"), new_id);
             char *new_id_str = xasprintf("%u", new_id);
 
@@ -606,6 +640,10 @@ int main(int argc, char **argv)
         }
     }
 
+    /* Next time go straight to the origin issue */
+    if (use_dup_cache)
+        duplicate_cache_put(mbt_settings.m_mantisbt_url, dup_scope, duphash, ii->mii_id, ii->mii_status);
+
     /* TODO CC list
      * Is no MantisBT SOAP API method which allows adding users to CC list
      * without updating issue.
@@ -621,8 +659,11 @@ int main(int argc, char **argv)
             error_msg_and_die(_("Invalid duplicate format file: '%s"), fmt_file2);
 
         problem_report_t *pr;
-        if (problem_formatter_generate_report(pf, problem_data, &pr))
+        /* The report is cached in the dump directory only if it can be locked */
+        struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+        if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
             error_msg_and_die(_("Failed to format duplicate comment from problem data"));
+        dd_close(pr_dd);
 
         const char *mbtcomment = problem_report_get_description(pr);
 
@@ -672,6 +713,8 @@ int main(int argc, char **argv)
     }
 
 finish:
+    free(dup_scope);
+
     log_warning(_("Status: %s%s%s %s/view.php?id=%u"),
                 ii->mii_status,
                 ii->mii_resolution ? " " : "",
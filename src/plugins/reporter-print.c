@@ -25,6 +25,8 @@ static const char *dump_dir_name = ".";
 static char *output_file = NULL;
 static const char *append = "no";
 static const char *open_mode = "w";
+/* 0 = no limit */
+static int max_size = 0;
 
 int main(int argc, char **argv)
 {
@@ -39,7 +41,7 @@ int main(int argc, char **argv)
 
     /* Can't keep these strings/structs static: _() doesn't support that */
     const char *program_usage_string = _(
-        "& [-v] -d DIR [-o FILE] [-a yes/no] [-r]\n"
+        "& [-v] -d DIR [-o FILE] [-a yes/no] [-r] [-s NUM]\n"
         "\n"
         "Prints problem information to standard output or FILE"
     );
@@ -49,6 +51,7 @@ int main(int argc, char **argv)
         OPT_o = 1 << 2,
         OPT_a = 1 << 3,
         OPT_r = 1 << 4,
+        OPT_s = 1 << 5,
     };
     /* Keep enum above and order of options below in sync! */
     struct options program_options[] = {
@@ -57,10 +60,14 @@ int main(int argc, char **argv)
         OPT_STRING('o', NULL, &output_file  , "FILE"  , _("Output file")),
         OPT_STRING('a', NULL, &append       , "yes/no", _("Append to, or overwrite FILE")),
         OPT_BOOL(  'r', NULL, NULL          ,           _("Create reported_to in DIR")),
+        OPT_INTEGER('s', NULL, &max_size    ,           _("Truncate the output to NUM bytes")),
         OPT_END()
     };
     unsigned opts = parse_opts(argc, argv, program_options, program_usage_string);
 
+    if (max_size < 0)
+        show_usage_and_die(program_usage_string, program_options);
+
     export_abrt_envvars(0);
 
     if (output_file)
@@ -120,11 +127,13 @@ int main(int argc, char **argv)
     if (!problem_data)
         xfunc_die(); /* create_problem_data_for_reporting already emitted error msg */
 
-    char *dsc = make_description_logger(problem_data, CD_TEXT_ATT_SIZE_LOGGER);
-    fputs(dsc, stdout);
+    /* Stream the description, do not build a copy of the whole problem */
+    fflush(stdout);
+    if (make_description_logger_fd(fileno(stdout), problem_data, CD_TEXT_ATT_SIZE_LOGGER,
+                                   max_size) != 0)
+        xfunc_die(); /* make_description_logger_fd already emitted error msg */
     if (open_mode[0] == 'a')
         fputs("\nEND:\n\n", stdout);
-    free(dsc);
     problem_data_free(problem_data);
 
     if (output_file)
@@ -482,7 +482,7 @@ int main(int argc, char **argv)
         "\n"
         "If not specified, CONFFILE defaults to "CONF_DIR"/plugins/rhtsupport.conf\n"
         "Its lines should have 'PARAM = VALUE' format.\n"
-        "Recognized string parameters: URL, Login, Password, BigFileURL.\n"
+        "Recognized string parameters: URL, Login, Password, BigFileURL, ContentEncoding.\n"
         "Recognized numeric parameter: BigSizeMB.\n"
         "Recognized boolean parameter (VALUE should be 1/0, yes/no): SSLVerify.\n"
         "Parameters can be overridden via $RHTSupport_PARAM environment variables.\n"
@@ -563,6 +563,14 @@ int main(int argc, char **argv)
     bool ssl_verify = string_to_bool(
                 envvar ? envvar : (get_map_string_item_or_NULL(settings, "SSLVerify") ? : "1")
     );
+    envvar = getenv("RHTSupport_ContentEncoding");
+    const char *encoding = envvar ? envvar : get_map_string_item_or_NULL(settings, "ContentEncoding");
+    int content_encoding = post_encoding_from_string(encoding);
+    if (content_encoding < 0)
+    {
+        error_msg(_("Unsupported ContentEncoding '%s', requests will not be compressed"), encoding);
+        content_encoding = POST_ENCODING_IDENTITY;
+    }
     envvar = getenv("RHTSupport_BigSizeMB");
     unsigned bigsize = xatoi_positive(
                 /* RH has a 250m limit for web attachments (as of 2013) */
@@ -758,8 +766,11 @@ int main(int argc, char **argv)
     }
 
     problem_report_t *pr = NULL;
-    if (problem_formatter_generate_report(pf, problem_data, &pr))
+    /* The report is cached in the dump directory only if it can be locked */
+    struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+    if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
         error_msg_and_die("Failed to format bug report from problem data");
+    dd_close(pr_dd);
 
     /* Add information about attachments into the description */
     problem_report_buffer *dsc_buffer = problem_report_get_buffer(pr, PR_SEC_DESCRIPTION);
@@ -833,7 +844,7 @@ int main(int argc, char **argv)
         }
 
         INVALID_CREDENTIALS_LOOP(login, password,
-                result, create_new_case(url, login, password, ssl_verify,
+                result, create_new_case(url, login, password, ssl_verify, content_encoding,
                                         product, version, summary, dsc, package)
         );
 
@@ -933,7 +944,7 @@ int main(int argc, char **argv)
         );
         free(remote_filename);
         INVALID_CREDENTIALS_LOOP(login, password,
-                result_atch, add_comment_to_case(url, login, password, ssl_verify, comment_text)
+                result_atch, add_comment_to_case(url, login, password, ssl_verify, content_encoding, comment_text)
         );
         free(comment_text);
     }
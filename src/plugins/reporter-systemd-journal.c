@@ -295,6 +295,9 @@ int main(int argc, char **argv)
     problem_report_settings_t report_settings = problem_formatter_get_settings(pf);
     report_settings.prs_shortbt_max_frames = 5;
     report_settings.prs_shortbt_max_text_size = 0; /* always short bt */
+    const char *max_section_size = getenv("REPORTER_JOURNAL_MAX_SECTION_SIZE");
+    if (max_section_size)
+        report_settings.prs_max_section_size = xatoi_positive(max_section_size);
     problem_formatter_set_settings(pf, report_settings);
 
     /* Modify problem_data to meet reporter's needs */
@@ -328,8 +331,11 @@ int main(int argc, char **argv)
 
     /* Generating of problem report */
     problem_report_t *pr = NULL;
-    if (problem_formatter_generate_report(pf, problem_data, &pr))
+    /* The report is cached in the dump directory only if it can be locked */
+    struct dump_dir *pr_dd = dd_opendir(dump_dir_name, DD_OPEN_READONLY | DD_FAIL_QUIETLY_EACCES);
+    if (problem_formatter_generate_report_ext(pf, problem_data, pr_dd, &pr))
         error_msg_and_die("Failed to format bug report from problem data");
+    dd_close(pr_dd);
 
     /* Debug */
     if (opts & OPT_D)
@@ -63,7 +63,8 @@ static int interactive_upload_file(const char *url, const char *file_name,
     if (state->client_ssh_private_keyfile != NULL)
         log_debug("Using SSH private key '%s'", state->client_ssh_private_keyfile);
 
-    char *tmp = upload_file_ext(state, url, file_name, UPLOAD_FILE_HANDLE_ACCESS_DENIALS);
+    char *tmp = upload_file_ext(state, url, file_name,
+                                UPLOAD_FILE_HANDLE_ACCESS_DENIALS | UPLOAD_FILE_RESUMABLE);
 
     if (remote_name)
         *remote_name = tmp;
@@ -77,6 +78,76 @@ static int interactive_upload_file(const char *url, const char *file_name,
     return tmp == NULL;
 }
 
+/* Lists the elements of the problem directory with their sizes and
+ * modification times. The directory's own mtime is useless here: locking
+ * changes it and rewriting an element in place does not. */
+static char *problem_dir_manifest(const char *dump_dir_name)
+{
+    DIR *dp = opendir(dump_dir_name);
+    if (!dp)
+        return NULL;
+
+    GList *lines = NULL;
+    struct dirent *dent;
+    while ((dent = readdir(dp)) != NULL)
+    {
+        /* The lock and the meta-data are not archived */
+        if (dent->d_name[0] == '.')
+            continue;
+
+        struct stat sb;
+        if (fstatat(dirfd(dp), dent->d_name, &sb, AT_SYMLINK_NOFOLLOW) != 0)
+            continue;
+
+        lines = g_list_prepend(lines, xasprintf("%s %lld %lld.%09ld\n", dent->d_name,
+                                                (long long)sb.st_size,
+                                                (long long)sb.st_mtim.tv_sec,
+                                                (long)sb.st_mtim.tv_nsec));
+    }
+    closedir(dp);
+
+    lines = g_list_sort(lines, (GCompareFunc)strcmp);
+    struct strbuf *manifest = strbuf_new();
+    for (GList *iter = lines; iter; iter = g_list_next(iter))
+        strbuf_append_str(manifest, iter->data);
+    list_free_with_free(lines);
+
+    return strbuf_free_nobuf(manifest);
+}
+
+static char *archive_manifest_path(const char *archive)
+{
+    return xasprintf("%s.manifest", archive);
+}
+
+/* An archive whose upload was interrupted is kept together with the upload
+ * checkpoint and the manifest of the problem directory it was created from.
+ * It can be uploaded again if none of the elements was changed since. */
+static bool can_resume_archive_upload(const char *dump_dir_name, const char *archive)
+{
+    char *checkpoint = upload_checkpoint_path(archive);
+    char *manifest_path = archive_manifest_path(archive);
+    char *saved = xmalloc_open_read_close(manifest_path, NULL);
+    char *current = saved ? problem_dir_manifest(dump_dir_name) : NULL;
+
+    const bool resume = access(checkpoint, F_OK) == 0
+                        && access(archive, R_OK) == 0
+                        && current && strcmp(saved, current) == 0;
+
+    if (!resume)
+    {
+        unlink(checkpoint);
+        unlink(archive);
+        unlink(manifest_path);
+    }
+
+    free(current);
+    free(saved);
+    free(manifest_path);
+    free(checkpoint);
+    return resume;
+}
+
 static int create_and_upload_archive(
                 const char *dump_dir_name,
                 const char *url,
@@ -85,6 +156,7 @@ static int create_and_upload_archive(
 {
     int result = 1; /* error */
     char* tempfile = NULL;
+    struct dump_dir *dd = NULL;
 
     /* Create a child gzip which will compress the data */
     /* SELinux guys are not happy with /tmp, using /var/run/abrt */
@@ -93,27 +165,68 @@ static int create_and_upload_archive(
     tempfile = concat_path_basename(LARGE_DATA_TMP_DIR, dump_dir_name);
     tempfile = append_to_malloced_string(tempfile, ".tar.gz");
 
-    string_vector_ptr_t exclude_from_report = get_global_always_excluded_elements();
+    const bool upload = url && url[0] && strcmp(url, "file://"LARGE_DATA_TMP_DIR"/") != 0;
 
-    struct dump_dir *dd = dd_opendir(dump_dir_name, /*flags:*/ 0);
-    if (!dd)
-        xfunc_die(); /* error msg is already logged by dd_opendir */
-
-    /* Compressing e.g. 0.5gig coredump takes a while. Let client know what we are doing */
-    log_warning(_("Compressing data"));
-    if (dd_create_archive(dd, tempfile, (const_string_vector_const_ptr_t)exclude_from_report, 0) != 0)
+    if (upload && can_resume_archive_upload(dump_dir_name, tempfile))
+        log_warning(_("Using the archive of the interrupted upload"));
+    else
     {
-        log_error("Can't create temporary file in %s", LARGE_DATA_TMP_DIR);
-        goto ret;
-    }
+        string_vector_ptr_t exclude_from_report = get_global_always_excluded_elements();
 
-    dd_close(dd);
-    dd = NULL;
+        dd = dd_opendir(dump_dir_name, /*flags:*/ 0);
+        if (!dd)
+            xfunc_die(); /* error msg is already logged by dd_opendir */
+
+        /* Taken under the lock, before the archive, so that a change made
+         * while compressing prevents the archive from being reused */
+        char *manifest = upload ? problem_dir_manifest(dump_dir_name) : NULL;
+
+        /* Compressing e.g. 0.5gig coredump takes a while. Let client know what we are doing */
+        log_warning(_("Compressing data"));
+        if (dd_create_archive(dd, tempfile, (const_string_vector_const_ptr_t)exclude_from_report, 0) != 0)
+        {
+            free(manifest);
+            log_error("Can't create temporary file in %s", LARGE_DATA_TMP_DIR);
+            goto ret;
+        }
+
+        if (manifest)
+        {
+            char *manifest_path = archive_manifest_path(tempfile);
+            FILE *fp = fopen(manifest_path, "w");
+            bool written = fp && fputs(manifest, fp) >= 0;
+            if (fp && fclose(fp) != 0)
+                written = false;
+            if (!written)
+            {
+                /* The archive will not be reused */
+                perror_msg("Can't write '%s'", manifest_path);
+                unlink(manifest_path);
+            }
+            free(manifest_path);
+            free(manifest);
+        }
+
+        dd_close(dd);
+        dd = NULL;
+    }
 
     /* Upload the archive */
     /* Upload from /tmp to /tmp + deletion -> BAD, exclude this possibility */
-    if (url && url[0] && strcmp(url, "file://"LARGE_DATA_TMP_DIR"/") != 0)
+    if (upload)
+    {
         result = interactive_upload_file(url, tempfile, settings, remote_name);
+
+        /* Keep the archive for the next attempt */
+        char *checkpoint = upload_checkpoint_path(tempfile);
+        if (result != 0 && access(checkpoint, F_OK) == 0)
+        {
+            log_notice("Keeping '%s' for the next attempt", tempfile);
+            free(tempfile);
+            tempfile = NULL;
+        }
+        free(checkpoint);
+    }
     else
     {
         result = 0; /* success */
@@ -128,6 +241,9 @@ static int create_and_upload_archive(
     if (tempfile)
     {
         unlink(tempfile);
+        char *manifest_path = archive_manifest_path(tempfile);
+        unlink(manifest_path);
+        free(manifest_path);
         free(tempfile);
     }
 
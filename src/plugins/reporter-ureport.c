@@ -45,10 +45,14 @@ int main(int argc, char **argv)
         OPT_t = 1 << 4,
         OPT_h = 1 << 5,
         OPT_i = 1 << 6,
+        OPT_Q = 1 << 7,
+        OPT_D = 1 << 8,
     };
 
     int ret = 1; /* "failure" (for now) */
     int insecure = !config.ur_ssl_verify;
+    int queue = 0;
+    int deliver = 0;
     const char *conf_file = UREPORT_CONF_FILE_PATH;
     const char *arg_server_url = NULL;
     const char *client_auth = NULL;
@@ -78,6 +82,8 @@ int main(int argc, char **argv)
         OPT_STRING('t', "auth", &client_auth, "SOURCE", _("Use client authentication")),
         OPT_STRING('h', "http-auth", &http_auth, "CREDENTIALS", _("Use HTTP Authentication")),
         OPT_LIST('i', "auth_items", &auth_items, "AUTH_ITEMS", _("Additional files included in 'auth' key")),
+        OPT_BOOL('Q', "queue", &queue, _("Queue uReport if the server is unreachable")),
+        OPT_BOOL('D', "deliver", &deliver, _("Send queued uReports")),
         OPT_STRING('c', NULL, &conf_file, "FILE", _("Configuration file")),
         OPT_STRING('a', "attach", &ureport_hash, "BTHASH",
                           _("bthash of uReport to attach (conflicts with -A)")),
@@ -114,9 +120,13 @@ int main(int argc, char **argv)
         "  [-A -a bthash -B -b bug-id -E -e email -O -o comment] [-d DIR]\n"
         "  [-A -a bthash -T ATTACHMENT_TYPE -r REPORT_RESULT_TYPE -L RESULT_FIELD] [-d DIR]\n"
         "  [-A -a bthash -T ATTACHMENT_TYPE -l DATA] [-d DIR]\n"
-        "& [-v] [-c FILE] [-u URL] [-k] [-t SOURCE] [-h CREDENTIALS] [-i AUTH_ITEMS] [-d DIR]\n"
+        "& [-v] [-c FILE] [-u URL] [-k] [-t SOURCE] [-h CREDENTIALS] [-i AUTH_ITEMS] [-Q] [-d DIR]\n"
+        "& [-v] [-c FILE] [-u URL] [-k] [-t SOURCE] [-h CREDENTIALS] -D\n"
+        "& [-v] [-c FILE] [-u URL] [-k] [-t SOURCE] [-h CREDENTIALS] [-i AUTH_ITEMS] DIR...\n"
         "\n"
-        "Upload micro report or add an attachment to a micro report\n"
+        "Upload micro report or add an attachment to a micro report.\n"
+        "Micro reports of more DIRs are generated concurrently and uploaded\n"
+        "through one connection.\n"
         "\n"
         "Reads the default configuration from "UREPORT_CONF_FILE_PATH
     );
@@ -145,6 +155,16 @@ int main(int argc, char **argv)
     if (!config.ur_url)
         ureport_server_config_set_url(&config, xstrdup(DEFAULT_WEB_SERVICE_URL));
 
+    if (!(opts & OPT_Q))
+        UREPORT_OPTION_VALUE_FROM_CONF(settings, "Queue", queue, string_to_bool);
+
+    if (deliver)
+    {
+        const int left = ureport_queue_deliver(&config, UREPORT_QUEUE_DEFAULT_CONCURRENCY);
+        ret = left == 0 ? 0 : 1;
+        goto finalize;
+    }
+
     if (ureport_hash && ureport_hash_from_rt)
         error_msg_and_die("You need to pass either -a bthash or -A");
 
@@ -286,6 +306,15 @@ int main(int argc, char **argv)
     if (!ureport_hash && (rhbz_bug >= 0 || email_address))
         error_msg_and_die(_("You need to specify bthash of the uReport to attach."));
 
+    argv += optind;
+    if (*argv)
+    {
+        /* Backlog of problem directories, e.g. after a network outage */
+        const unsigned count = g_strv_length(argv);
+        ret = ureport_submit_dump_dirs((const char *const *)argv, count, &config) == count ? 0 : 1;
+        goto finalize;
+    }
+
     struct ureport_preferences *prefs = &(config.ur_prefs);
     prefs->urp_flags |= UREPORT_PREF_FLAG_RETURN_ON_FAILURE;
 
@@ -296,7 +325,17 @@ int main(int argc, char **argv)
         goto finalize;
     }
 
-    struct ureport_server_response *response = ureport_submit(json_ureport, &config);
+    struct ureport_server_response *response = NULL;
+    if (queue)
+    {
+        bool queued = false;
+        response = ureport_submit_or_queue(json_ureport, dump_dir_path, &config, &queued);
+        if (queued)
+            /* Delivered by 'reporter-ureport --deliver' */
+            ret = 0;
+    }
+    else
+        response = ureport_submit(json_ureport, &config);
     free(json_ureport);
 
     if (!response)
@@ -68,7 +68,28 @@ void free_bug_info(struct bug_info *bi)
     free(bi);
 }
 
-static GList *rhbz_comments(struct abrt_xmlrpc *ax, int bug_id)
+/* Completion function of queued calls whose result is not needed. Dies on
+ * faults like abrt_xmlrpc_call(). */
+static void rhbz_die_on_fault(const char *method, const xmlrpc_env *fault,
+                xmlrpc_value *result, void *user_data)
+{
+    if (fault->fault_occurred)
+        error_msg_and_die("fatal: %s", fault->fault_string);
+}
+
+/* Completion function of queued calls, stores a reference to the result in
+ * xmlrpc_value **user_data */
+static void rhbz_keep_result(const char *method, const xmlrpc_env *fault,
+                xmlrpc_value *result, void *user_data)
+{
+    rhbz_die_on_fault(method, fault, result, user_data);
+
+    xmlrpc_INCREF(result);
+    *(xmlrpc_value **)user_data = result;
+}
+
+/* Reads the comments from the response of Bug.comments */
+static GList *rhbz_comments(xmlrpc_value *xml_response, int bug_id)
 {
     func_entry();
 
@@ -85,8 +106,7 @@ static GList *rhbz_comments(struct abrt_xmlrpc *ax, int bug_id)
      *           <value><array>
      * ...
      */
-    xmlrpc_value *xml_response = abrt_xmlrpc_call(ax, "Bug.comments", "{s:(i)}",
-                                                                      "ids", bug_id);
+
     /* bugs
      *     This is used for bugs specified in ids. This is a hash, where the
      *     keys are the numeric ids of the bugs, and the value is a hash with a
@@ -128,7 +148,6 @@ static GList *rhbz_comments(struct abrt_xmlrpc *ax, int bug_id)
     xmlrpc_DECREF(comments_memb);
     xmlrpc_DECREF(item_memb);
     xmlrpc_DECREF(bugs_memb);
-    xmlrpc_DECREF(xml_response);
 
     return g_list_reverse(comments);
 }
@@ -444,9 +463,17 @@ struct bug_info *rhbz_bug_info(struct abrt_xmlrpc *ax, int bug_id)
      *     <member><name>bugs</name>
      *        <value><array><data>
      *        ...
+     *
+     * The bug and its comments are requested at once, together with the
+     * queued updates.
      */
-    xmlrpc_value *xml_bug_response = abrt_xmlrpc_call(ax, "Bug.get", "{s:(i)}",
-                                                          "ids", bug_id);
+    xmlrpc_value *xml_bug_response = NULL;
+    xmlrpc_value *xml_comments_response = NULL;
+    abrt_xmlrpc_queue_call(ax, "Bug.get", rhbz_keep_result, &xml_bug_response,
+                           "{s:(i)}", "ids", bug_id);
+    abrt_xmlrpc_queue_call(ax, "Bug.comments", rhbz_keep_result, &xml_comments_response,
+                           "{s:(i)}", "ids", bug_id);
+    abrt_xmlrpc_flush_calls(ax);
 
     xmlrpc_value *bugs_memb = rhbz_get_member("bugs", xml_bug_response);
     xmlrpc_value *bug_item = rhbz_array_item_at(bugs_memb, 0);
@@ -484,11 +511,12 @@ struct bug_info *rhbz_bug_info(struct abrt_xmlrpc *ax, int bug_id)
 
     bz->bi_cc_list = rhbz_bug_cc(bug_item);
 
-    bz->bi_comments = rhbz_comments(ax, bug_id);
+    bz->bi_comments = rhbz_comments(xml_comments_response, bug_id);
     bz->bi_best_bt_rating = find_best_bt_rating_in_comments(bz->bi_comments);
 
     xmlrpc_DECREF(bugs_memb);
     xmlrpc_DECREF(bug_item);
+    xmlrpc_DECREF(xml_comments_response);
     xmlrpc_DECREF(xml_bug_response);
 
     return bz;
@@ -611,7 +639,8 @@ int rhbz_attach_blob(struct abrt_xmlrpc *ax, const char *bug_id,
 {
     func_entry();
 
-    if (strlen(data) == 0)
+    /* data needn't be NUL terminated (e.g. mmaped files) */
+    if (data_len == 0 || data[0] == '\0')
     {
         log_notice("not attaching an empty file: '%s'", filename);
         /* Return SUCCESS */
@@ -655,43 +684,197 @@ int rhbz_attach_blob(struct abrt_xmlrpc *ax, const char *bug_id,
     return 0;
 }
 
+/* Files bigger than this are not attached concurrently by rhbz_attach_many()
+ * but streamed one by one by rhbz_attach_fd(), so the memory usage does not
+ * depend on the sizes of the files.
+ */
+#define RHBZ_CONCURRENT_ATTACHMENT_SIZE (1024 * 1024)
+
+/* Maps the file to memory. Returns NULL on errors. */
+static char *map_attachment_fd(const char *att_name, int fd, size_t *data_len)
+{
+    char *data = mmap_fd_read(fd, data_len);
+    if (data == NULL)
+        perror_msg("Can't read '%s'", att_name);
+
+    return data;
+}
+
 int rhbz_attach_fd(struct abrt_xmlrpc *ax, const char *bug_id,
                 const char *att_name, int fd, int flags)
 {
     func_entry();
 
-    off_t size = lseek(fd, 0, SEEK_END);
-    if (size < 0)
+    /* Like rhbz_attach_blob(), do not attach empty files */
+    char first;
+    ssize_t r;
+    do
+        r = pread(fd, &first, 1, 0);
+    while (r < 0 && errno == EINTR);
+
+    if (r < 0)
     {
-        perror_msg("Can't lseek '%s'", att_name);
+        perror_msg("Can't read '%s'", att_name);
         return -1;
     }
 
-    /* bugzilla limit is 20MB
-     * attaching more then bugzilla's limit could cause that xmlrpc-c fails
-     * somewhere inside itself.
-     * https://bugzilla.redhat.com/show_bug.cgi?id=741980
-     */
-    if (size >= (20 * 1024 * 1024))
+    if (r == 0 || first == '\0')
     {
-        error_msg("Can't upload '%s', it's too large (%llu bytes)", att_name, (long long)size);
-        return -1;
+        log_notice("not attaching an empty file: '%s'", att_name);
+        /* Return SUCCESS */
+        return 0;
     }
-    lseek(fd, 0, SEEK_SET);
 
-//TODO: need to have a method of attaching huge files (IOW: 1Gb read isn't good).
+    xmlrpc_env env;
+    xmlrpc_env_init(&env);
 
-    char *data = xmalloc(size + 1);
-    ssize_t r = full_read(fd, data, size);
-    if (r < 0)
+    /* See rhbz_attach_blob() for description of the arguments, "data" are
+     * added by abrt_xmlrpc_call_params_fd() */
+    char *fn = xasprintf("File: %s", att_name);
+    xmlrpc_value *params = xmlrpc_build_value(&env, "{s:(s),s:s,s:s,s:s,s:i}",
+                "ids", bug_id,
+                "summary", fn,
+                "file_name", att_name,
+                "content_type", (flags & RHBZ_BINARY_ATTACHMENT) ? "application/octet-stream" : "text/plain",
+                "nomail", !!IS_NOMAIL_NOTIFY(flags)
+    );
+    free(fn);
+    if (env.fault_occurred)
+        abrt_xmlrpc_die(&env);
+
+    xmlrpc_value *result = abrt_xmlrpc_call_params_fd(&env, ax, "Bug.add_attachment",
+                params, "data", fd);
+    xmlrpc_DECREF(params);
+
+    /* The server may refuse big files, it is not a reason to give up */
+    if (env.fault_occurred)
     {
-        free(data);
-        perror_msg("Can't read '%s'", att_name);
+        error_msg("Can't attach '%s': %s", att_name, env.fault_string);
+        xmlrpc_env_clean(&env);
         return -1;
     }
 
-    int res = rhbz_attach_blob(ax, bug_id, att_name, data, size, flags);
-    free(data);
+    xmlrpc_DECREF(result);
+    return 0;
+}
+
+struct rhbz_attach_call
+{
+    struct rhbz_attachment *attachment;
+    char *fault;
+};
+
+static void rhbz_attach_done(const char *method, const xmlrpc_env *fault,
+                xmlrpc_value *result, void *user_data)
+{
+    struct rhbz_attach_call *call = user_data;
+
+    if (fault->fault_occurred)
+    {
+        call->attachment->ra_result = -1;
+        call->fault = xstrdup(fault->fault_string);
+        return;
+    }
+
+    call->attachment->ra_result = 0;
+    log_notice("attached '%s'", call->attachment->ra_name);
+}
+
+int rhbz_attach_many(struct abrt_xmlrpc *ax, const char *bug_id,
+                struct rhbz_attachment *attachments, unsigned count,
+                unsigned max_parallel)
+{
+    func_entry();
+
+    if (max_parallel == 0)
+        max_parallel = 1;
+
+    int res = 0;
+    struct rhbz_attach_call *calls = xzalloc(sizeof(*calls) * (count + 1));
+    GList *streamed = NULL;
+
+    /* Attachments are sent in waves of max_parallel calls, because xmlrpc-c
+     * can only wait for all started calls.
+     */
+    for (unsigned first = 0; first < count; first += max_parallel)
+    {
+        const unsigned last = MIN(count, first + max_parallel);
+
+        for (unsigned i = first; i < last; ++i)
+        {
+            struct rhbz_attachment *att = &attachments[i];
+            calls[i].attachment = att;
+
+            const char *data = att->ra_data;
+            size_t data_len = att->ra_data_len;
+            char *mapped = NULL;
+            if (att->ra_fd >= 0)
+            {
+                struct stat st;
+                if (fstat(att->ra_fd, &st) == 0 && st.st_size > RHBZ_CONCURRENT_ATTACHMENT_SIZE)
+                {
+                    streamed = g_list_prepend(streamed, att);
+                    continue;
+                }
+
+                data = mapped = map_attachment_fd(att->ra_name, att->ra_fd, &data_len);
+                if (data == NULL)
+                {
+                    att->ra_result = res = -1;
+                    continue;
+                }
+            }
+
+            /* data needn't be NUL terminated (e.g. mmaped files) */
+            if (data_len == 0 || data[0] == '\0')
+            {
+                log_notice("not attaching an empty file: '%s'", att->ra_name);
+                att->ra_result = 0;
+            }
+            else
+            {
+                /* See rhbz_attach_blob() for description of the arguments */
+                char *fn = xasprintf("File: %s", att->ra_name);
+                abrt_xmlrpc_start_call(ax, "Bug.add_attachment", rhbz_attach_done, &calls[i],
+                            "{s:(s),s:s,s:s,s:s,s:6,s:i}",
+                            "ids", bug_id,
+                            "summary", fn,
+                            "file_name", att->ra_name,
+                            "content_type", (att->ra_flags & RHBZ_BINARY_ATTACHMENT) ? "application/octet-stream" : "text/plain",
+                            "data", data, data_len,
+                            "nomail", !!IS_NOMAIL_NOTIFY(att->ra_flags)
+                );
+                free(fn);
+            }
+
+            /* xmlrpc-c has its own copy of the data */
+            if (mapped)
+                munmap_fd_read(mapped, data_len);
+        }
+
+        abrt_xmlrpc_finish_calls(ax);
+
+        for (unsigned i = first; i < last; ++i)
+        {
+            /* Be consistent with rhbz_attach_blob() which dies on faults */
+            if (calls[i].fault)
+                error_msg_and_die("fatal: %s", calls[i].fault);
+        }
+
+        log_notice("attached %u of %u files", last - g_list_length(streamed), count);
+    }
+
+    streamed = g_list_reverse(streamed);
+    for (GList *iter = streamed; iter; iter = g_list_next(iter))
+    {
+        struct rhbz_attachment *att = iter->data;
+        att->ra_result = rhbz_attach_fd(ax, bug_id, att->ra_name, att->ra_fd, att->ra_flags);
+        if (att->ra_result != 0)
+            res = -1;
+    }
+
+    g_list_free(streamed);
+    free(calls);
     return res;
 }
 
@@ -742,7 +925,6 @@ void rhbz_mail_to_cc(struct abrt_xmlrpc *ax, int bug_id, const char *mail, int f
 {
     func_entry();
 
-    xmlrpc_value *result;
     int nomail_notify = !!IS_NOMAIL_NOTIFY(flags);
 #if 0 /* Obsolete API */
     result = abrt_xmlrpc_call(ax, "Bug.update", "({s:i,s:{s:(s),s:i}})",
@@ -752,13 +934,12 @@ void rhbz_mail_to_cc(struct abrt_xmlrpc *ax, int bug_id, const char *mail, int f
     );
 #endif
     /* Bugzilla 4.0+ uses this API: */
-    result = abrt_xmlrpc_call(ax, "Bug.update", "{s:i,s:{s:(s),s:i}}",
+    abrt_xmlrpc_queue_call(ax, "Bug.update", rhbz_die_on_fault, NULL,
+                              "{s:i,s:{s:(s),s:i}}",
                               "ids", bug_id,
                               "cc", "add", mail,
                                     "nomail", nomail_notify
     );
-    if (result)
-        xmlrpc_DECREF(result);
 
     /* TODO: check that result does indicate that CC was updated.
      * The structure I see from Bugzilla 4.2:
@@ -788,13 +969,10 @@ void rhbz_add_comment(struct abrt_xmlrpc *ax, int bug_id, const char *comment,
     int private = !!IS_PRIVATE(flags);
     int nomail_notify = !!IS_NOMAIL_NOTIFY(flags);
 
-    xmlrpc_value *result;
-    result = abrt_xmlrpc_call(ax, "Bug.add_comment", "{s:i,s:s,s:b,s:i}",
+    abrt_xmlrpc_queue_call(ax, "Bug.add_comment", rhbz_die_on_fault, NULL,
+                              "{s:i,s:s,s:b,s:i}",
                               "id", bug_id, "comment", comment,
                               "private", private, "nomail", nomail_notify);
-
-    if (result)
-        xmlrpc_DECREF(result);
 }
 
 void rhbz_set_url(struct abrt_xmlrpc *ax, int bug_id, const char *url, int flags)
@@ -802,7 +980,8 @@ void rhbz_set_url(struct abrt_xmlrpc *ax, int bug_id, const char *url, int flags
     func_entry();
 
     const int nomail_notify = !!IS_NOMAIL_NOTIFY(flags);
-    xmlrpc_value *result = abrt_xmlrpc_call(ax, "Bug.update", "{s:i,s:s,s:i}",
+    abrt_xmlrpc_queue_call(ax, "Bug.update", rhbz_die_on_fault, NULL,
+                              "{s:i,s:s,s:i}",
                               "ids", bug_id,
                               "url", url,
 
@@ -811,9 +990,6 @@ void rhbz_set_url(struct abrt_xmlrpc *ax, int bug_id, const char *url, int flags
                  */
                               "nomail", nomail_notify
     );
-
-    if (result)
-        xmlrpc_DECREF(result);
 }
 
 void rhbz_close_as_duplicate(struct abrt_xmlrpc *ax, int bug_id,
@@ -823,7 +999,8 @@ void rhbz_close_as_duplicate(struct abrt_xmlrpc *ax, int bug_id,
     func_entry();
 
     const int nomail_notify = !!IS_NOMAIL_NOTIFY(flags);
-    xmlrpc_value *result = abrt_xmlrpc_call(ax, "Bug.update", "{s:i,s:s,s:s,s:i,s:i}",
+    abrt_xmlrpc_queue_call(ax, "Bug.update", rhbz_die_on_fault, NULL,
+                              "{s:i,s:s,s:s,s:i,s:i}",
                               "ids", bug_id,
                               "status", "CLOSED",
                               "resolution", "DUPLICATE",
@@ -834,9 +1011,6 @@ void rhbz_close_as_duplicate(struct abrt_xmlrpc *ax, int bug_id,
                  */
                               "nomail", nomail_notify
     );
-
-    if (result)
-        xmlrpc_DECREF(result);
 }
 
 xmlrpc_value *rhbz_search_duphash(struct abrt_xmlrpc *ax,
@@ -67,6 +67,10 @@ void free_bug_info(struct bug_info *bz);
 
 bool rhbz_login(struct abrt_xmlrpc *ax, const char *login, const char *password);
 
+/* The following updates are only queued. They are sent in one request with
+ * the next call on the client (see abrt_xmlrpc_queue_call()) and the process
+ * dies if any of them fails.
+ */
 void rhbz_mail_to_cc(struct abrt_xmlrpc *ax, int bug_id, const char *mail, int flags);
 
 void rhbz_add_comment(struct abrt_xmlrpc *ax, int bug_id, const char *comment,
@@ -102,9 +106,35 @@ int rhbz_new_bug(struct abrt_xmlrpc *ax,
 int rhbz_attach_blob(struct abrt_xmlrpc *ax, const char *bug_id,
                 const char *att_name, const char *data, int data_len, int flags);
 
+/* The file is streamed, so it can be of any size. Unlike rhbz_attach_blob(),
+ * returns -1 on XML-RPC faults (e.g. the file exceeds the server's limit).
+ */
 int rhbz_attach_fd(struct abrt_xmlrpc *ax, const char *bug_id,
                 const char *att_name, int fd, int flags);
 
+struct rhbz_attachment {
+    const char *ra_name;
+    /* Either data or a file descriptor (ra_fd >= 0) */
+    const char *ra_data;
+    size_t ra_data_len;
+    int ra_fd;
+    /* RHBZ_NOMAIL_NOTIFY, RHBZ_BINARY_ATTACHMENT */
+    int ra_flags;
+    /* 0 on success */
+    int ra_result;
+};
+
+/* Uploads the attachments concurrently, at most max_parallel at once.
+ *
+ * Big files are attached one by one by rhbz_attach_fd() after the others.
+ *
+ * Returns -1 if some of the files could not be read or some of the big files
+ * could not be attached. Dies on other XML-RPC faults like rhbz_attach_blob().
+ */
+int rhbz_attach_many(struct abrt_xmlrpc *ax, const char *bug_id,
+                struct rhbz_attachment *attachments, unsigned count,
+                unsigned max_parallel);
+
 GList *rhbz_bug_cc(xmlrpc_value *result_xml);
 
 struct bug_info *rhbz_bug_info(struct abrt_xmlrpc *ax, int bug_id);
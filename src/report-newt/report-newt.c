@@ -106,11 +106,11 @@ static int configure_reporter(struct reporter *r, bool skip_if_valid)
         text = newtTextboxReflowed(0, 0, ec_get_screen_name(r->config) ?
                 xstrdup(ec_get_screen_name(r->config)) : r->name, 35, 5, 5, 0);
 
-        num_opts = g_list_length(r->config->options);
+        num_opts = g_list_length(ec_get_options(r->config));
         options = xmalloc(sizeof (newtComponent) * num_opts);
         ogrid = newtCreateGrid(2, num_opts);
 
-        for (option = r->config->options, i = 0; option && i < num_opts;
+        for (option = ec_get_options(r->config), i = 0; option && i < num_opts;
                 option = g_list_next(option), i++)
         {
             opt = (event_option_t *)option->data;
@@ -160,7 +160,7 @@ static int configure_reporter(struct reporter *r, bool skip_if_valid)
             for (iter = error_list; iter; iter = iter->next)
             {
                 invalid_option_t *inv_data = (invalid_option_t *)iter->data;
-                opt = get_event_option_from_list(inv_data->invopt_name, r->config->options);
+                opt = ec_get_option(r->config, inv_data->invopt_name);
                 snprintf(buf + strlen(buf), sizeof (buf) - strlen(buf), "%s: %s\n",
                         opt->eo_label ? opt->eo_label : opt->eo_name, inv_data->invopt_error);
             }
@@ -170,7 +170,7 @@ static int configure_reporter(struct reporter *r, bool skip_if_valid)
 
         if (newtRunForm(form) == button_ok)
         {
-            for (option = r->config->options, i = 0; option && i < num_opts;
+            for (option = ec_get_options(r->config), i = 0; option && i < num_opts;
                     option = g_list_next(option), i++)
             {
                 opt = (event_option_t *)option->data;
@@ -412,8 +412,7 @@ int main(int argc, char **argv)
 
     dump_dir_name = argv[0];
 
-    /* Get settings */
-    load_event_config_data();
+    /* Event settings are loaded on demand by get_event_config() */
 
     newtInit();
     newtCls();
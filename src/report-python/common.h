@@ -30,6 +30,7 @@ extern PyObject *ReportError;
 extern PyTypeObject p_problem_data_type;
 extern PyTypeObject p_dump_dir_type;
 extern PyTypeObject p_run_event_state_type;
+extern PyTypeObject p_config_watcher_type;
 
 /* python objects' struct defs */
 typedef struct {
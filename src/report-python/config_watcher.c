@@ -0,0 +1,143 @@
+/*
+    Copyright (C) 2017  ABRT team
+    Copyright (C) 2017  RedHat Inc
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+#include <Python.h>
+
+#include "common.h"
+#include "config_watcher.h"
+
+typedef struct {
+    PyObject_HEAD
+    config_watcher_t *watcher;
+    PyObject *callback;
+} p_config_watcher;
+
+
+/*** init/cleanup ***/
+
+/* The Python callback gets the kind (CONFIG_WATCH_*) and the name */
+static void changed_callback(config_watch_kind_t kind, const char *name, void *param)
+{
+    p_config_watcher *self = (p_config_watcher*)param;
+    if (self->callback == NULL || PyErr_Occurred())
+        return;
+
+    PyObject *ret = PyObject_CallFunction(self->callback, (char*) "(is)", (int)kind, name);
+    /* The exception is raised by process() */
+    Py_XDECREF(ret);
+}
+
+static PyObject *p_config_watcher_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PyObject *callback = Py_None;
+    if (!PyArg_ParseTuple(args, "|O", &callback))
+        return NULL;
+
+    if (callback != Py_None && !PyCallable_Check(callback))
+    {
+        PyErr_SetString(PyExc_TypeError, "callback must be callable");
+        return NULL;
+    }
+
+    p_config_watcher *self = (p_config_watcher *)type->tp_alloc(type, 0);
+    if (!self)
+        return NULL;
+
+    self->watcher = config_watcher_new(changed_callback, self);
+    if (!self->watcher)
+    {
+        Py_DECREF(self);
+        PyErr_SetString(ReportError, "Can't watch configuration changes");
+        return NULL;
+    }
+
+    if (callback != Py_None)
+    {
+        Py_INCREF(callback);
+        self->callback = callback;
+    }
+
+    return (PyObject *)self;
+}
+
+static void p_config_watcher_dealloc(PyObject *pself)
+{
+    p_config_watcher *self = (p_config_watcher*)pself;
+    config_watcher_free(self->watcher);
+    self->watcher = NULL;
+    Py_XDECREF(self->callback);
+    self->callback = NULL;
+    Py_TYPE(self)->tp_free(pself);
+}
+
+
+/*** methods ***/
+
+/* fileno() makes the watcher usable with select.select() and the like */
+static PyObject *p_config_watcher_fileno(PyObject *pself, PyObject *always_null)
+{
+    p_config_watcher *self = (p_config_watcher*)pself;
+    return Py_BuildValue("i", config_watcher_get_fd(self->watcher));
+}
+
+static PyObject *p_config_watcher_add_dir(PyObject *pself, PyObject *args)
+{
+    p_config_watcher *self = (p_config_watcher*)pself;
+    int kind;
+    const char *dir;
+    if (!PyArg_ParseTuple(args, "is", &kind, &dir))
+        return NULL;
+
+    return Py_BuildValue("i", config_watcher_add_dir(self->watcher, kind, dir));
+}
+
+static PyObject *p_config_watcher_process(PyObject *pself, PyObject *always_null)
+{
+    p_config_watcher *self = (p_config_watcher*)pself;
+    const int cnt = config_watcher_process(self->watcher);
+
+    /* Raised by the callback */
+    if (PyErr_Occurred())
+        return NULL;
+
+    if (cnt < 0)
+    {
+        PyErr_SetString(ReportError, "Can't read configuration changes");
+        return NULL;
+    }
+
+    return Py_BuildValue("i", cnt);
+}
+
+static PyMethodDef p_config_watcher_methods[] = {
+    /* method_name, func, flags, doc_string */
+    { "fileno"  , p_config_watcher_fileno , METH_NOARGS,  "Returns the file descriptor to poll" },
+    { "add_dir" , p_config_watcher_add_dir, METH_VARARGS, "Watches one more directory" },
+    { "process" , p_config_watcher_process, METH_NOARGS,  "Reloads the changed configuration and calls the callback" },
+    { NULL }
+};
+
+PyTypeObject p_config_watcher_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name      = "report.config_watcher",
+    .tp_basicsize = sizeof(p_config_watcher),
+    .tp_flags     = Py_TPFLAGS_DEFAULT,
+    .tp_new       = p_config_watcher_new,
+    .tp_dealloc   = p_config_watcher_dealloc,
+    .tp_methods   = p_config_watcher_methods,
+};
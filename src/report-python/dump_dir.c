@@ -157,6 +157,36 @@ static PyObject *p_dd_load_text(PyObject *pself, PyObject *args)
     return obj;
 }
 
+/* void *dd_map_item(struct dump_dir *dd, const char *name, size_t *size); */
+static PyObject *p_dd_load_binary(PyObject *pself, PyObject *args)
+{
+    p_dump_dir *self = (p_dump_dir*)pself;
+    if (!self->dd)
+    {
+        PyErr_SetString(ReportError, "dump dir is not open");
+        return NULL;
+    }
+    const char *name;
+    if (!PyArg_ParseTuple(args, "s", &name))
+    {
+        return NULL;
+    }
+    /* The bytes object is filled directly from the mapping, no heap copy */
+    size_t size;
+    char *data = dd_map_item(self->dd, name, &size);
+    if (data == NULL)
+    {
+        Py_RETURN_NONE;
+    }
+#if PY_MAJOR_VERSION >= 3
+    PyObject *obj = PyBytes_FromStringAndSize(data, size);
+#else
+    PyObject *obj = PyString_FromStringAndSize(data, size);
+#endif
+    dd_unmap_item(data, size);
+    return obj;
+}
+
 /* void dd_save_text(struct dump_dir *dd, const char *name, const char *data); */
 static PyObject *p_dd_save_text(PyObject *pself, PyObject *args)
 {
@@ -258,6 +288,7 @@ static PyMethodDef p_dump_dir_methods[] = {
     { "create_basic_files", p_dd_create_basic_files, METH_VARARGS, NULL },
     { "exist"      , p_dd_exist, METH_VARARGS, NULL },
     { "load_text"  , p_dd_load_text, METH_VARARGS, NULL },
+    { "load_binary", p_dd_load_binary, METH_VARARGS, NULL },
     { "save_text"  , p_dd_save_text, METH_VARARGS, NULL },
     { "save_binary", p_dd_save_binary, METH_VARARGS, NULL },
     { "copy_file"  , p_dd_copy_file, METH_VARARGS, NULL },
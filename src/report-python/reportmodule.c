@@ -20,6 +20,7 @@
 
 #include "common.h"
 #include "internal_libreport.h"
+#include "config_watcher.h"
 
 #if PY_MAJOR_VERSION >= 3
   #define MOD_ERROR_VAL NULL
@@ -71,6 +72,11 @@ MOD_INIT
         printf("PyType_Ready(&p_run_event_state_type) < 0\n");
         return MOD_ERROR_VAL;
     }
+    if (PyType_Ready(&p_config_watcher_type) < 0)
+    {
+        printf("PyType_Ready(&p_config_watcher_type) < 0\n");
+        return MOD_ERROR_VAL;
+    }
 
 
     PyObject *m;
@@ -103,6 +109,14 @@ MOD_INIT
     /* for include/report/run_event.h */
     Py_INCREF(&p_run_event_state_type);
     PyModule_AddObject(m, "run_event_state", (PyObject *)&p_run_event_state_type);
+    /* for include/report/config_watcher.h */
+    Py_INCREF(&p_config_watcher_type);
+    PyModule_AddObject(m, "config_watcher", (PyObject *)&p_config_watcher_type);
+    PyModule_AddObject(m, "CONFIG_WATCH_EVENT"      , Py_BuildValue("i", CONFIG_WATCH_EVENT      ));
+    PyModule_AddObject(m, "CONFIG_WATCH_WORKFLOW"   , Py_BuildValue("i", CONFIG_WATCH_WORKFLOW   ));
+    PyModule_AddObject(m, "CONFIG_WATCH_EVENT_RULES", Py_BuildValue("i", CONFIG_WATCH_EVENT_RULES));
+    PyModule_AddObject(m, "CONFIG_WATCH_PLUGIN"     , Py_BuildValue("i", CONFIG_WATCH_PLUGIN     ));
+    PyModule_AddObject(m, "CONFIG_WATCH_GLOBAL"     , Py_BuildValue("i", CONFIG_WATCH_GLOBAL     ));
     /* for include/report/report.h */
     PyModule_AddObject(m, "LIBREPORT_NOWAIT"     , Py_BuildValue("i", LIBREPORT_NOWAIT     ));
     PyModule_AddObject(m, "LIBREPORT_WAIT"       , Py_BuildValue("i", LIBREPORT_WAIT       ));
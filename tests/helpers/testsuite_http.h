@@ -0,0 +1,305 @@
+/*
+    Copyright (C) 2017  ABRT team <crash-catcher@lists.fedorahosted.org>
+    Copyright (C) 2017  RedHat inc.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    ----
+
+    A minimal HTTP server for testing of the network code
+
+    The server runs in a forked process and serves every connection in its own
+    process. The handler is called in the server process, hence it can't
+    change the test's variables; it can log the requests to a file instead.
+    testsuite_http_respond() closes the connection, a handler can keep it
+    alive with testsuite_http_respond_keep_alive().
+
+        static void handler(const struct testsuite_http_request *request,
+                            int response_fd, void *user_data)
+        {
+            testsuite_http_respond(response_fd, 200, "text/plain", "OK", 2);
+        }
+
+        char *url;
+        pid_t server = testsuite_http_server_start(handler, NULL, &url);
+        ...
+        testsuite_http_server_stop(server);
+        free(url);
+*/
+
+#include "testsuite.h"
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+struct testsuite_http_request
+{
+    char *method;
+    char *path;
+    /* The header lines including the line ends */
+    char *headers;
+    /* Decoded from the chunked transfer encoding */
+    char *body;
+    size_t body_size;
+    /* The client's port, the same for all requests of one connection */
+    unsigned connection;
+};
+
+typedef void (*testsuite_http_handler_fn)(const struct testsuite_http_request *request,
+                                          int response_fd, void *user_data);
+
+/* Returns the value of the header or NULL, the value must be freed */
+static char *testsuite_http_header(const struct testsuite_http_request *request, const char *name)
+{
+    const size_t name_len = strlen(name);
+    for (const char *line = request->headers; line && *line; )
+    {
+        const char *end = strstr(line, "\r\n");
+        if (!end)
+            break;
+
+        if (strncasecmp(line, name, name_len) == 0 && line[name_len] == ':')
+        {
+            const char *value = line + name_len + 1;
+            while (*value == ' ')
+                ++value;
+            return xstrndup(value, end - value);
+        }
+
+        line = end + 2;
+    }
+
+    return NULL;
+}
+
+static void testsuite_http_write_response(int response_fd, int code, const char *content_type,
+                                          const char *body, size_t size, bool keep_alive)
+{
+    struct strbuf *head = strbuf_new();
+    strbuf_append_strf(head, "HTTP/1.1 %d Test\r\n", code);
+    if (content_type)
+        strbuf_append_strf(head, "Content-Type: %s\r\n", content_type);
+    strbuf_append_strf(head, "Content-Length: %zu\r\nConnection: %s\r\n\r\n",
+                       size, keep_alive ? "keep-alive" : "close");
+
+    full_write(response_fd, head->buf, head->len);
+    full_write(response_fd, body, size);
+    strbuf_free(head);
+}
+
+/* Writes a complete response closing the connection */
+static void testsuite_http_respond(int response_fd, int code, const char *content_type,
+                                   const char *body, size_t size)
+{
+    testsuite_http_write_response(response_fd, code, content_type, body, size, false);
+}
+
+/* Writes a complete response, the client may send more requests */
+static void testsuite_http_respond_keep_alive(int response_fd, int code, const char *content_type,
+                                              const char *body, size_t size)
+{
+    testsuite_http_write_response(response_fd, code, content_type, body, size, true);
+}
+
+/* Reads till the end of the headers, returns the number of read bytes */
+static size_t testsuite_http_read_headers(int fd, struct strbuf *buf)
+{
+    char c;
+    while (!strstr(buf->buf, "\r\n\r\n") && safe_read(fd, &c, 1) == 1)
+        strbuf_append_char(buf, c);
+
+    return buf->len;
+}
+
+static bool testsuite_http_read_line(int fd, struct strbuf *line)
+{
+    strbuf_clear(line);
+    char c;
+    while (safe_read(fd, &c, 1) == 1)
+    {
+        if (c == '\n')
+            return true;
+        if (c != '\r')
+            strbuf_append_char(line, c);
+    }
+
+    return false;
+}
+
+static void testsuite_http_read_body(int fd, struct testsuite_http_request *request)
+{
+    char *encoding = testsuite_http_header(request, "Transfer-Encoding");
+    const bool chunked = encoding && strcasecmp(encoding, "chunked") == 0;
+    free(encoding);
+
+    if (!chunked)
+    {
+        char *length = testsuite_http_header(request, "Content-Length");
+        request->body_size = length ? strtoul(length, NULL, 10) : 0;
+        free(length);
+
+        request->body = xmalloc(request->body_size + 1);
+        request->body_size = full_read(fd, request->body, request->body_size);
+        request->body[request->body_size] = '\0';
+        return;
+    }
+
+    struct strbuf *line = strbuf_new();
+    request->body = xzalloc(1);
+    while (testsuite_http_read_line(fd, line))
+    {
+        const size_t size = strtoul(line->buf, NULL, 16);
+        if (size == 0)
+        {
+            /* The trailer ends with an empty line */
+            while (testsuite_http_read_line(fd, line) && line->len)
+                ;
+            break;
+        }
+
+        request->body = xrealloc(request->body, request->body_size + size + 1);
+        request->body_size += full_read(fd, request->body + request->body_size, size);
+        request->body[request->body_size] = '\0';
+
+        /* The CRLF after the chunk */
+        testsuite_http_read_line(fd, line);
+    }
+    strbuf_free(line);
+}
+
+/* Returns false once the client closes the connection */
+static bool testsuite_http_serve(int fd, unsigned connection, testsuite_http_handler_fn handler, void *user_data)
+{
+    struct strbuf *head = strbuf_new();
+    if (testsuite_http_read_headers(fd, head) == 0)
+    {
+        strbuf_free(head);
+        return false;
+    }
+
+    struct testsuite_http_request request;
+    memset(&request, 0, sizeof(request));
+    request.connection = connection;
+
+    char *const line_end = strstr(head->buf, "\r\n");
+    *line_end = '\0';
+    request.headers = line_end + 2;
+
+    char *const path = strchr(head->buf, ' ');
+    if (path)
+    {
+        *path = '\0';
+        char *const version = strchr(path + 1, ' ');
+        if (version)
+            *version = '\0';
+        request.path = path + 1;
+    }
+    request.method = head->buf;
+
+    char *expect = testsuite_http_header(&request, "Expect");
+    if (expect && strcasecmp(expect, "100-continue") == 0)
+        full_write_str(fd, "HTTP/1.1 100 Continue\r\n\r\n");
+    free(expect);
+
+    testsuite_http_read_body(fd, &request);
+
+    handler(&request, fd, user_data);
+
+    free(request.body);
+    strbuf_free(head);
+    return true;
+}
+
+/* Starts the server on a free port of the loopback interface
+ *
+ * @param url The base URL of the server, e.g. "http://127.0.0.1:4242/"
+ * @returns The pid of the server process
+ */
+static pid_t testsuite_http_server_start(testsuite_http_handler_fn handler, void *user_data, char **url)
+{
+    const int sock = xsocket(AF_INET, SOCK_STREAM, 0);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    xbind(sock, (struct sockaddr *)&addr, sizeof(addr));
+    xlisten(sock, 16);
+
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(sock, (struct sockaddr *)&addr, &addr_len) != 0)
+        perror_msg_and_die("getsockname");
+
+    /* Flush the buffers to not print them twice */
+    fflush(NULL);
+
+    const pid_t pid = fork();
+    if (pid < 0)
+        perror_msg_and_die("fork");
+
+    if (pid == 0)
+    {
+        /* testsuite_http_server_stop() kills the connections too */
+        setpgid(0, 0);
+        signal(SIGCHLD, SIG_IGN);
+
+        while (1)
+        {
+            struct sockaddr_in peer;
+            socklen_t peer_len = sizeof(peer);
+            const int fd = accept(sock, (struct sockaddr *)&peer, &peer_len);
+            if (fd < 0)
+                continue;
+
+            /* An idle kept-alive connection must not block the others */
+            const pid_t child = fork();
+            if (child == 0)
+            {
+                close(sock);
+                while (testsuite_http_serve(fd, ntohs(peer.sin_port), handler, user_data))
+                    ;
+                _exit(0);
+            }
+
+            if (child < 0)
+                perror_msg("fork");
+            close(fd);
+        }
+    }
+
+    /* Both sides set the group, the server may be stopped before it runs */
+    setpgid(pid, pid);
+    close(sock);
+
+    *url = xasprintf("http://127.0.0.1:%u/", (unsigned)ntohs(addr.sin_port));
+    return pid;
+}
+
+static void testsuite_http_server_stop(pid_t pid)
+{
+    kill(-pid, SIGTERM);
+    waitpid(pid, NULL, 0);
+}
+
+/* Appends the line to the file, the server's handlers log the requests with it */
+static void testsuite_http_log(const char *path, const char *line)
+{
+    const int fd = xopen3(path, O_WRONLY | O_CREAT | O_APPEND, 0600);
+    full_write_str(fd, line);
+    full_write_str(fd, "\n");
+    close(fd);
+}